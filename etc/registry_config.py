@@ -15,11 +15,13 @@ universal_coders = [
     AlgorithmConfig(name="BitCoder", header="coders/BitCoder.hpp"),
     AlgorithmConfig(name="EliasGammaCoder", header="coders/EliasGammaCoder.hpp"),
     AlgorithmConfig(name="EliasDeltaCoder", header="coders/EliasDeltaCoder.hpp"),
+    AlgorithmConfig(name="RangeCoder", header="coders/RangeCoder.hpp"),
 ]
 
 # Entropy coders
 entropy_coders = [
     AlgorithmConfig(name="HuffmanCoder", header="coders/HuffmanCoder.hpp"),
+    AlgorithmConfig(name="RANSCoder", header="coders/RANSCoder.hpp"),
 ]
 
 # Entropy coders that may consume characters without immediately generating an
@@ -58,10 +60,15 @@ lcp_uncompressed = [
     AlgorithmConfig(name="LCPFromPLCP", header="ds/LCPFromPLCP.hpp"),
 ]
 
+# LCP arrays that are decoded for writing
+lcp_decodable = [
+    AlgorithmConfig(name="DACLCP", header="ds/DACLCP.hpp"),
+]
+
 # All LCP Arrays
 lcp = lcp_uncompressed + [
     AlgorithmConfig(name="CompressedLCP", header="ds/CompressedLCP.hpp", sub=[sa]),
-]
+] + lcp_decodable
 
 # Inverse Suffix Array
 isa = [
@@ -113,10 +120,12 @@ lz78_trie = [
     AlgorithmConfig(name="lz78::ExtHashTrie", header="compressors/lz78/ExtHashTrie.hpp"),
     AlgorithmConfig(name="lz78::HashTrie", header="compressors/lz78/HashTrie.hpp", sub=[hash_function,hash_prober,hash_manager]),
     AlgorithmConfig(name="lz78::HashTriePlus", header="compressors/lz78/HashTriePlus.hpp", sub=[hash_function,hash_manager]),
+    AlgorithmConfig(name="lz78::GroupHashTrie", header="compressors/lz78/GroupHashTrie.hpp", sub=[hash_function]),
     AlgorithmConfig(name="lz78::RollingTrie", header="compressors/lz78/RollingTrie.hpp", sub=[hash_roll, hash_prober,hash_manager,hash_function]),
     AlgorithmConfig(name="lz78::RollingTriePlus", header="compressors/lz78/RollingTriePlus.hpp", sub=[hash_roll, hash_manager,hash_function]),
     AlgorithmConfig(name="lz78::TernaryTrie", header="compressors/lz78/TernaryTrie.hpp"),
     AlgorithmConfig(name="lz78::CompactSparseHashTrie", header="compressors/lz78/CompactSparseHashTrie.hpp"),
+    AlgorithmConfig(name="lz78::CompactDisplacementHashTrie", header="compressors/lz78/CompactDisplacementHashTrie.hpp"),
 ]
 
 if config_match("^#define JUDY_H_AVAILABLE 1"): # if the Judy trie is available
@@ -139,6 +148,8 @@ lcpcomp_coders = [
     AlgorithmConfig(name="ASCIICoder", header="coders/ASCIICoder.hpp"),
     AlgorithmConfig(name="SLECoder", header="coders/SLECoder.hpp"),
     AlgorithmConfig(name="HuffmanCoder", header="coders/HuffmanCoder.hpp"),
+    AlgorithmConfig(name="RangeCoder", header="coders/RangeCoder.hpp"),
+    AlgorithmConfig(name="RANSCoder", header="coders/RANSCoder.hpp"),
 ]
 
 # lcpcomp factorization strategies ("comp")
@@ -158,14 +169,16 @@ if config_match("^#define Boost_FOUND 1"): # if Boost is available
 # lcpcomp factor decoding strategies ("dec")
 lcpcomp_dec = [
     AlgorithmConfig(name="lcpcomp::ScanDec", header="compressors/lcpcomp/decompress/ScanDec.hpp"),
+    AlgorithmConfig(name="lcpcomp::BlockScanDec", header="compressors/lcpcomp/decompress/BlockScanDec.hpp"),
     AlgorithmConfig(name="lcpcomp::DecodeForwardQueueListBuffer", header="compressors/lcpcomp/decompress/DecodeQueueListBuffer.hpp"),
     AlgorithmConfig(name="lcpcomp::CompactDec", header="compressors/lcpcomp/decompress/CompactDec.hpp"),
+    AlgorithmConfig(name="lcpcomp::ForwardListDec", header="compressors/lcpcomp/decompress/ForwardListDec.hpp"),
     AlgorithmConfig(name="lcpcomp::MultimapBuffer", header="compressors/lcpcomp/decompress/MultiMapBuffer.hpp"),
 ]
 
-# Allowed TextDS instances for lcpcomp (LCP array must be writable!)
+# Allowed TextDS instances for lcpcomp (LCP array must be writable or decodable!)
 lcpcomp_textds = [
-    AlgorithmConfig(name="TextDS", header="ds/TextDS.hpp", sub=[sa, phi, plcp, lcp_uncompressed, isa]),
+    AlgorithmConfig(name="TextDS", header="ds/TextDS.hpp", sub=[sa, phi, plcp, lcp_uncompressed + lcp_decodable, isa]),
 ]
 
 ##### ESP grammar compressor WIP #####
@@ -206,9 +219,9 @@ slp_coder = [
 
 lfs_strat = [
     AlgorithmConfig(name="lfs::ESAStrategy<>", header="compressors/lfs/ESAStrategy.hpp"),
-    AlgorithmConfig(name="lfs::STStrategy", header="compressors/lfs/STStrategy.hpp"),
+    AlgorithmConfig(name="lfs::STStrategy<>", header="compressors/lfs/STStrategy.hpp"),
     AlgorithmConfig(name="lfs::BSTStrategy", header="compressors/lfs/BSTStrategy.hpp"),
-    AlgorithmConfig(name="lfs::SimSTStrategy", header="compressors/lfs/SimSTStrategy.hpp"),
+    AlgorithmConfig(name="lfs::SimSTStrategy<>", header="compressors/lfs/SimSTStrategy.hpp"),
 ]
 
 lit_coder = [
@@ -234,6 +247,7 @@ tdc.compressors = [
     AlgorithmConfig(name="RePairCompressor", header="compressors/RePairCompressor.hpp", sub=[non_consuming_coders]),
     AlgorithmConfig(name="LZSSLCPCompressor", header="compressors/LZSSLCPCompressor.hpp", sub=[non_consuming_coders, textds]),
     AlgorithmConfig(name="LZSSSlidingWindowCompressor", header="compressors/LZSSSlidingWindowCompressor.hpp", sub=[universal_coders]),
+    AlgorithmConfig(name="LZSSStreamingCompressor", header="compressors/LZSSStreamingCompressor.hpp", sub=[universal_coders]),
     AlgorithmConfig(name="MTFCompressor", header="compressors/MTFCompressor.hpp"),
     AlgorithmConfig(name="NoopCompressor", header="compressors/NoopCompressor.hpp"),
     AlgorithmConfig(name="BWTCompressor", header="compressors/BWTCompressor.hpp", sub=[textds]),
@@ -8,6 +8,7 @@
 #include <tudocomp/util.hpp>
 #include <tudocomp/Range.hpp>
 #include <tudocomp/def.hpp>
+#include <tudocomp/util/huffman.hpp>
 
 namespace tdc {
 
@@ -76,120 +77,10 @@ namespace huff {
         return map_from_effective;
     }
 
-    /**
-     * Returns an array storing for each character of the effective alphabet the length of its codeword.
-     * The array is sorted with respect to the rank of the alphabet character.
-     * This is an implementation of Managing Gigabytes, Chapter 2.3 Huffman Coding, Second Edition, 1999
-     * @param C @see count_alphabet
-     * @param map_from_effective maps from the effective alphabet to the full alphabet
-     * @param alphabet_size the size of the effective alphabet
-     *
-     **/
-    inline uint8_t* gen_codelengths(const len_compact_t*const C, const uliteral_t*const map_from_effective, const size_t alphabet_size) {
-        size_t A[2*alphabet_size];
-        for(size_t i=0; i < alphabet_size; i++) {
-            DVLOG(2) << "Char " << map_from_effective[i] << " : " << size_t(C[map_from_effective[i]]);
-            A[alphabet_size+i] = C[map_from_effective[i]];
-            A[i] = alphabet_size+i;
-        }
-        // build a minHeap of A[0..size)
-        auto comp = [&A] (const size_t a, const size_t b) -> bool { return A[a] > A[b];};
-        std::make_heap(&A[0], &A[alphabet_size], comp);
-        DCHECK_LE(A[A[0]], A[A[1]]);
-        assert_permutation_offset<size_t*>(A,alphabet_size,alphabet_size);
-
-        DVLOG(2) << "A: "<<arr_to_debug_string(A,2*alphabet_size);
-
-
-        size_t h = alphabet_size-1;
-        //builds the Huffman tree
-        while(h > 0) {
-            std::pop_heap(A, A+h+1, comp);
-            const size_t m1 = A[h];  // first element from the heap (already popped)
-            --h;
-
-            std::pop_heap(A, A+h+1, comp);
-            const size_t m2 = A[h]; //second min count
-            DCHECK_GT(m1,h); DCHECK_GT(m2,h);
-
-            A[h+1] = A[m1] + A[m2]; // create a new parent node
-            A[h] = h + 1;
-            A[m1] = A[m2] = h + 1; //parent pointer
-            std::push_heap(A, A+h+1, comp);
-        }
-
-        A[1] = 0;
-        for(size_t i = 2; i < 2*alphabet_size; ++i) {
-            A[i] = A[A[i]]+ 1;
-        }
-        // variant:
-        // for(size_t i = size; i < 2*size; ++i) {
-        //  size_t d = 0;
-        //  size_t r = i;
-        //  while(r > 1) {
-        //      ++d;
-        //      r = A[r];
-        //  }
-        //  A[i] = d;
-        // }
-
-        uint8_t* codelengths { new uint8_t[alphabet_size] };
-        for (size_t i=0; i < alphabet_size; i++) {
-            DCHECK_LE(A[alphabet_size+i], 64); // the latter representation allows only codewords of length at most 64 bits
-            codelengths[i] = A[alphabet_size+i];
-            DVLOG(2) << "Char " << map_from_effective[i] << " : " << codelengths[i];
-        }
-
-        IF_PARANOID({
-            // invariants
-
-            // check that more frequent keywords get shorter codelengthss
-            for(size_t i=0; i < alphabet_size; ++i) {
-                for(size_t j=i+1; j < alphabet_size; ++j) {
-                    if(codelengths[i] > codelengths[j]) {
-                        DCHECK_LE(C[map_from_effective[i]], C[map_from_effective[j]]);
-                    }
-                    else if(codelengths[i] < codelengths[j]) {
-                        DCHECK_GE(C[map_from_effective[i]], C[map_from_effective[j]]);
-                    }
-                }}
-            { // check Kraft's equality
-                const size_t& max_el = *std::max_element(A+alphabet_size,A+2*alphabet_size);
-                DCHECK_LT(max_el,63);
-                size_t sum = 0;
-                for (size_t i = 0; i < alphabet_size; ++i)
-                {
-                    sum += 2ULL<<(max_el - A[alphabet_size+i]);
-                }
-                DCHECK_EQ(sum, 2ULL<<max_el);
-            }
-        })
-
-        return codelengths;
-    }
-
-    /** Generates the numl array (@see huffmantable). This function is called before decoding Huffman-encoded text.
-     */
-    inline uliteral_t* gen_numl(const uint8_t*const ordered_codelengths, const size_t alphabet_size, const uint8_t longest) {
-        DCHECK_EQ(longest, *std::max_element(ordered_codelengths, ordered_codelengths+alphabet_size));
-        DCHECK_GT(longest,0);
-
-        // numl : length l -> #codewords of length l
-        uliteral_t* numl = new uliteral_t[longest];
-        std::memset(numl,0,sizeof(uliteral_t)*longest);
-
-        for (size_t i = 0; i < alphabet_size; ++i) {
-            DCHECK_LE(ordered_codelengths[i], longest);
-            DCHECK_GT(ordered_codelengths[i], 0);
-            ++numl[ordered_codelengths[i]-1];
-        }
-        return numl;
-    }
-
     /**
      * The returned array stores for each codeword length the smallest codeword of the respective length.
      */
-    inline size_t* gen_first_codes(const uliteral_t*const numl, const size_t longest) {
+    inline size_t* gen_first_codes(const len_compact_t*const numl, const size_t longest) {
         size_t* firstcode = new size_t[longest];
         firstcode[longest-1] = 0;
         for(size_t i = longest-1; i > 0; --i)
@@ -197,26 +88,6 @@ namespace huff {
         return firstcode;
     }
 
-    /** Generates all codewords. Called before encoding a text.
-     */
-    inline size_t* gen_codewords(const uint8_t*const ordered_codelengths, const size_t alphabet_size, const uliteral_t*const numl, const uint8_t longest) {
-        DCHECK_EQ(longest, *std::max_element(ordered_codelengths, ordered_codelengths+alphabet_size));
-        DCHECK_GT(longest,0);
-
-        //firstcode stores the code of the first character with the specific length. It is then incremented for the later characters of the same length
-        size_t*const firstcode = gen_first_codes(numl, longest);
-
-        size_t*const codewords = new size_t[alphabet_size];
-        for(size_t i = 0; i < alphabet_size; ++i) {
-            DCHECK_LE(ordered_codelengths[i], longest);
-            DCHECK_GT(ordered_codelengths[i], 0);
-            codewords[i] = firstcode[ordered_codelengths[i]-1]++;
-            DVLOG(2) << "codeword " << i << " : " << std::bitset<64>(codewords[i]) << ", length " << ordered_codelengths[i];
-        }
-        delete [] firstcode;
-        return codewords;
-    }
-
     struct huffmantable {
         const uliteral_t* ordered_map_from_effective; //! stores a map from the effective alphabet to the full alphabet, sorted by the length of the codewords
         const size_t alphabet_size; //! stores the size of the effective alphabet
@@ -224,7 +95,7 @@ namespace huff {
         /** Given a codelength l, nums returns the number of codewords with the given length.
          * numl starts with index 0, i.e., numl[l] returns the codewords with length l+1 !
          */
-        const uliteral_t*const numl;
+        const len_compact_t*const numl;
         const uint8_t longest; //! how long is the longest codeword?
 
         ~huffmantable() { //! all members of the huffmantable are created dynamically
@@ -244,7 +115,7 @@ namespace huff {
                 const size_t*const _codewords,
                 const uint8_t*const _ordered_codelengths,
                 const size_t _alphabet_size,
-                const uliteral_t*const _numl,
+                const len_compact_t*const _numl,
                 const uint8_t _longest)
             : huffmantable{_ordered_map_from_effective,_alphabet_size, _numl, _longest},
             codewords(_codewords),
@@ -277,9 +148,9 @@ namespace huff {
      */
     inline huffmantable huffmantable_decode(tdc::io::BitIStream& in) {
         const uint8_t longest = in.read_compressed_int<uint8_t>();
-        uliteral_t*const numl { new uliteral_t[longest] };
+        len_compact_t*const numl { new len_compact_t[longest] };
         for(size_t i = 0; i < longest; ++i) {
-            numl[i] = in.read_compressed_int<uliteral_t>();
+            numl[i] = in.read_compressed_int<len_compact_t>();
         }
         const size_t alphabet_size = in.read_compressed_int<size_t>();
         uint8_t*const ordered_map_from_effective { new uint8_t[alphabet_size] };
@@ -403,7 +274,7 @@ namespace huff {
             const uliteral_t*const ordered_map_from_effective,
             const uint8_t*const ordered_codelengths,
             const size_t alphabet_size,
-            const uliteral_t*const numl,
+            const len_compact_t*const numl,
             const uint8_t longest) {
 
             std::unique_ptr<size_t const[]> const prefix_sum_lengths { gen_prefix_sum_lengths(ordered_codelengths, alphabet_size, longest) };
@@ -423,7 +294,7 @@ namespace huff {
 
     /** Computes the lengths of all codewords of the Huffman code. Needed to decode a Huffman-encoded text.
      */
-    inline uint8_t* gen_ordered_codelength(const size_t alphabet_size, const uliteral_t*const numl, const size_t longest) {
+    inline uint8_t* gen_ordered_codelength(const size_t alphabet_size, const len_compact_t*const numl, const size_t longest) {
         uint8_t* ordered_codelengths { new uint8_t[alphabet_size] };
         for(size_t i = 0,k=0; i < longest; ++i) {
             for(size_t j = 0; j < numl[i]; ++j) {
@@ -436,41 +307,40 @@ namespace huff {
 
     /** Generates the Huffman table based on some input text
      * @param C @see count_alphabet
+     * @param max_length the maximum length of a codeword
      * @attention Deletes the input array C!
      * @attention C must contain at least two non-zero values
      */
-    inline extended_huffmantable gen_huffmantable(const len_compact_t*const C) {
+    inline extended_huffmantable gen_huffmantable(const len_compact_t*const C, const size_t max_length = DEFAULT_MAX_CODELENGTH) {
         const size_t alphabet_size = effective_alphabet_size(C);
         DCHECK_GT(alphabet_size,0);
 
         // mapFromEffective : rank of an effective alphabet character -> input alphabet (char-range)
         const uliteral_t*const mapFromEffective = gen_effective_alphabet(C, alphabet_size);
 
-        const uint8_t*const codelengths = gen_codelengths(C, mapFromEffective, alphabet_size);
+        std::vector<size_t> weights(alphabet_size);
+        for(size_t i = 0; i < alphabet_size; ++i) {
+            weights[i] = C[mapFromEffective[i]];
+        }
         delete [] C;
 
-        // codeword_order is a permutation (like suffix array) sorting (code_length, mapFromEffective) by code_length ascendingly (instead of mapFromEffective values)
-        size_t*const codeword_order = new size_t[alphabet_size];
-        std::iota(codeword_order,codeword_order+alphabet_size,0);
-        std::sort(codeword_order,codeword_order+alphabet_size, [&] (const uliteral_t& i, const uliteral_t& j) { return codelengths[i] < codelengths[j]; });
-
-        const uint8_t longest = *std::max_element(codelengths, codelengths+alphabet_size);
+        const CanonicalCode code = gen_canonical_code(weights, max_length);
 
         // the ordered variants are all sorted by the codelengths, (instead of by character values)
-        uint8_t* ordered_codelengths { new uint8_t[alphabet_size] };
+        uint8_t*const ordered_codelengths { new uint8_t[alphabet_size] };
         uliteral_t*const ordered_map_from_effective { new uliteral_t[alphabet_size] };
+        size_t*const codewords { new size_t[alphabet_size] };
         for(size_t i = 0; i < alphabet_size; ++i) {
-            ordered_codelengths[i] = codelengths[codeword_order[i]];
-            ordered_map_from_effective[i] = mapFromEffective[codeword_order[i]];
+            ordered_codelengths[i] = code.ordered_codelengths[i];
+            ordered_map_from_effective[i] = mapFromEffective[code.order[i]];
+            codewords[i] = code.codewords[i];
         }
-        delete [] codelengths;
         delete [] mapFromEffective;
-        delete [] codeword_order;
 
-        const uliteral_t*const numl = gen_numl(ordered_codelengths, alphabet_size, longest);
-        const size_t*const codewords = gen_codewords(ordered_codelengths, alphabet_size, numl, longest);
+        len_compact_t*const numl { new len_compact_t[code.longest] };
+        std::copy(code.numl.begin(), code.numl.end(), numl);
 
-        return { ordered_map_from_effective, codewords, ordered_codelengths, alphabet_size, numl, longest };
+        return { ordered_map_from_effective, codewords, ordered_codelengths, alphabet_size, numl, code.longest };
     }
 
     inline extended_huffmantable gen_huffmantable(const std::string& text) {
@@ -513,6 +383,7 @@ class HuffmanCoder : public Algorithm {
 public:
     inline static Meta meta() {
         Meta m("coder", "huff", "Canonical Huffman Coder");
+        m.option("max_length").dynamic(32); // longest codeword in bits
         return m;
     }
 
@@ -533,7 +404,9 @@ public:
                     delete [] C;
                     return huff::extended_huffmantable { nullptr, nullptr, nullptr, 1, nullptr, 0 };
                 }
-                return huff::gen_huffmantable(C);
+                const size_t max_length = this->env().option("max_length").as_integer();
+                return huff::gen_huffmantable(C, std::min<size_t>(huff::MAX_CODELENGTH,
+                    std::max<size_t>(max_length, bits_for(alphabet_size - 1))));
             }() }
             , ordered_map_to_effective { m_table.codewords == nullptr ? nullptr : huff::gen_ordered_map_to_effective(m_table.ordered_map_from_effective, m_table.alphabet_size) }
         {
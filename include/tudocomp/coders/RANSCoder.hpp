@@ -0,0 +1,319 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include <tudocomp/util.hpp>
+#include <tudocomp/Coder.hpp>
+
+namespace tdc {
+namespace rans {
+
+/// The frequencies of the literals sum up to `1 << SCALE_BITS`.
+constexpr size_t SCALE_BITS = 12;
+constexpr uint32_t SCALE = uint32_t(1) << SCALE_BITS;
+
+/// The lower bound of the normalized state interval `[STATE_LOW, 256 * STATE_LOW)`.
+constexpr uint32_t STATE_LOW = uint32_t(1) << 23;
+
+constexpr size_t MAX_STATES = 32;
+
+/// \brief The static model of the literals: their frequencies scaled to sum
+///        up to \ref SCALE and the start of each literal's slot interval.
+class Model {
+    uint32_t m_freq[ULITERAL_MAX + 1];
+    uint32_t m_start[ULITERAL_MAX + 1];
+
+    // maps each slot to its literal, its frequency and the start of its
+    // interval, such that a decoding step needs a single lookup
+    struct Slot {
+        uliteral_t c;
+        uint16_t freq;
+        uint16_t start;
+    };
+    std::vector<Slot> m_slots;
+
+    inline void compute_starts() {
+        uint32_t start = 0;
+        for(size_t c = 0; c <= ULITERAL_MAX; ++c) {
+            m_start[c] = start;
+            start += m_freq[c];
+        }
+        DCHECK_EQ(start, SCALE);
+    }
+
+public:
+    /// Scales the given literal counts such that they sum up to
+    /// \ref SCALE and every occurring literal has a frequency of at least one.
+    inline Model(const std::vector<size_t>& counts) {
+        size_t total = 0;
+        for(size_t c = 0; c <= ULITERAL_MAX; ++c) total += counts[c];
+        DCHECK_GT(total, 0U);
+
+        int64_t sum = 0;
+        for(size_t c = 0; c <= ULITERAL_MAX; ++c) {
+            m_freq[c] = counts[c] == 0 ? 0 : std::max<uint32_t>(1,
+                uint32_t((uint64_t(counts[c]) * SCALE) / total));
+            sum += m_freq[c];
+        }
+
+        // correct rounding errors at the literal where the relative error
+        // of a change by one is smallest
+        while(sum != SCALE) {
+            size_t best = 0;
+            for(size_t c = 1; c <= ULITERAL_MAX; ++c) {
+                if(m_freq[c] > m_freq[best]) best = c;
+            }
+            if(sum > int64_t(SCALE)) {
+                for(size_t c = 0; c <= ULITERAL_MAX; ++c) {
+                    if(m_freq[c] > 1 && uint64_t(counts[c]) * m_freq[best] <
+                                        uint64_t(counts[best]) * m_freq[c]) {
+                        best = c;
+                    }
+                }
+                --m_freq[best];
+                --sum;
+            } else {
+                for(size_t c = 0; c <= ULITERAL_MAX; ++c) {
+                    if(m_freq[c] > 0 && uint64_t(counts[c]) * m_freq[best] >
+                                        uint64_t(counts[best]) * m_freq[c]) {
+                        best = c;
+                    }
+                }
+                ++m_freq[best];
+                ++sum;
+            }
+        }
+        compute_starts();
+    }
+
+    /// Reads a model written by \ref write.
+    inline Model(BitIStream& in) {
+        for(size_t c = 0; c <= ULITERAL_MAX; ++c) {
+            m_freq[c] = in.read_bit() ? in.read_int<uint32_t>(SCALE_BITS) + 1 : 0;
+        }
+        compute_starts();
+
+        m_slots.resize(SCALE);
+        for(size_t c = 0; c <= ULITERAL_MAX; ++c) {
+            for(uint32_t s = m_start[c]; s < m_start[c] + m_freq[c]; ++s) {
+                m_slots[s] = Slot { uliteral_t(c), uint16_t(m_freq[c]), uint16_t(m_start[c]) };
+            }
+        }
+    }
+
+    /// Writes the frequencies of all literals.
+    inline void write(BitOStream& out) const {
+        for(size_t c = 0; c <= ULITERAL_MAX; ++c) {
+            out.write_bit(m_freq[c] > 0);
+            if(m_freq[c] > 0) out.write_int(m_freq[c] - 1, SCALE_BITS);
+        }
+    }
+
+    inline uint32_t freq(uliteral_t c) const { return m_freq[c]; }
+    inline uint32_t start(uliteral_t c) const { return m_start[c]; }
+
+    /// Encodes `c` into the state `x`, writing renormalization bytes
+    /// to `out` in reverse order.
+    inline void encode(uint32_t& x, uliteral_t c, std::vector<uint8_t>& out) const {
+        const uint32_t f = m_freq[c];
+        DCHECK_GT(f, 0U) << "literal " << size_t(c) << " was not counted";
+
+        const uint32_t x_max = ((STATE_LOW >> SCALE_BITS) << 8) * f;
+        while(x >= x_max) {
+            out.push_back(uint8_t(x));
+            x >>= 8;
+        }
+        x = ((x / f) << SCALE_BITS) + (x % f) + m_start[c];
+    }
+
+    /// Decodes a literal from the state `x`, reading renormalization bytes
+    /// from `in`.
+    inline uliteral_t decode(uint32_t& x, const uint8_t*& in) const {
+        const Slot& s = m_slots[x & (SCALE - 1)];
+        x = s.freq * (x >> SCALE_BITS) + (x & (SCALE - 1)) - s.start;
+        while(x < STATE_LOW) x = (x << 8) | *in++;
+        return s.c;
+    }
+};
+
+} //ns rans
+
+/// \brief Defines data encoding to and decoding from a stream of
+///        interleaved rANS codes.
+///
+/// Literals are coded with a static model of their frequencies that is
+/// gathered by a counting pass over the literal iterator, like in
+/// \ref HuffmanCoder, but with the precision of an arithmetic code.
+/// All other values are encoded in binary like in \ref BitCoder.
+///
+/// The literals are distributed round-robin over `states` independent
+/// rANS states that share one byte stream. Subsequent literals hence do
+/// not depend on each other while decoding, which allows the CPU to
+/// decode several of them at the same time.
+///
+/// As rANS encodes in reverse order, literals are buffered in chunks of
+/// at most `chunk` literals. Each chunk is written as the number of its
+/// literals and their rANS code at the position of its first literal in the
+/// output (see \ref io::BitOStream::reserve). All other values are written
+/// immediately, so the coder can be interleaved with other coders and raw
+/// bits on the same stream.
+class RANSCoder : public Algorithm {
+public:
+    inline static Meta meta() {
+        Meta m("coder", "rans", "Interleaved rANS encoding");
+        m.option("states").dynamic(8);
+        m.option("chunk").dynamic(1 << 16);
+        return m;
+    }
+
+    RANSCoder() = delete;
+
+    /// \brief Encodes data to a stream of interleaved rANS codes.
+    class Encoder : public tdc::Encoder {
+        std::unique_ptr<rans::Model> m_model;
+        size_t m_states;
+        size_t m_chunk;
+
+        std::vector<uliteral_t> m_literals; // the current chunk
+        size_t m_part; // the reserved output of the current chunk
+        std::vector<uint8_t> m_bytes;
+
+        inline void write_chunk() {
+            // encode the literals backwards
+            uint32_t x[rans::MAX_STATES];
+            std::fill(x, x + m_states, rans::STATE_LOW);
+            m_bytes.clear();
+            for(size_t i = m_literals.size(); i > 0; --i) {
+                m_model->encode(x[(i - 1) % m_states], m_literals[i - 1], m_bytes);
+            }
+            for(size_t j = m_states; j > 0; --j) {
+                for(size_t b = 0; b < 4; ++b) {
+                    m_bytes.push_back(uint8_t(x[j - 1] >> (8 * b)));
+                }
+            }
+
+            m_out->write_reserved(m_part, [&](BitOStream& out) {
+                out.write_compressed_int(m_literals.size());
+                out.write_compressed_int(m_bytes.size());
+                for(size_t i = m_bytes.size(); i > 0; --i) {
+                    out.write_int(m_bytes[i - 1], 8);
+                }
+            });
+            m_literals.clear();
+        }
+
+    public:
+        template<typename literals_t>
+        inline Encoder(Env&& env, std::shared_ptr<BitOStream> out, literals_t&& literals)
+            : tdc::Encoder(std::move(env), out, literals)
+            , m_states(std::min<size_t>(std::max<size_t>(
+                this->env().option("states").as_integer(), 1), rans::MAX_STATES))
+            , m_chunk(std::max<size_t>(this->env().option("chunk").as_integer(), 1)) {
+
+            std::vector<size_t> counts(ULITERAL_MAX + 1, 0);
+            bool any = false;
+            while(literals.has_next()) {
+                ++counts[uliteral_t(literals.next().c)];
+                any = true;
+            }
+
+            m_out->write_int(m_states - 1, 5);
+            m_out->write_bit(any);
+            if(any) {
+                m_model = std::make_unique<rans::Model>(counts);
+                m_model->write(*m_out);
+            }
+        }
+
+        template<typename literals_t>
+        inline Encoder(Env&& env, Output& out, literals_t&& literals)
+            : Encoder(std::move(env), std::make_shared<BitOStream>(out), literals) {
+        }
+
+        inline ~Encoder() {
+            if(!m_literals.empty()) write_chunk();
+        }
+
+        using tdc::Encoder::encode; // binary encoding of all other values
+
+        template<typename value_t>
+        inline void encode(value_t v, const LiteralRange&) {
+            if(m_model) {
+                if(m_literals.empty()) m_part = m_out->reserve();
+                m_literals.push_back(uliteral_t(v));
+                if(m_literals.size() == m_chunk) write_chunk();
+            } else {
+                // no literals were counted
+                m_out->write_int(uliteral_t(v), 8 * sizeof(uliteral_t));
+            }
+        }
+    };
+
+    /// \brief Decodes data from a stream of interleaved rANS codes.
+    class Decoder : public tdc::Decoder {
+        std::unique_ptr<rans::Model> m_model;
+        size_t m_states;
+
+        size_t m_remaining = 0; // literals left in the current chunk
+        std::vector<uint8_t> m_bytes;
+        const uint8_t* m_next_byte;
+        uint32_t m_x[rans::MAX_STATES];
+        size_t m_state = 0; // the state of the next literal
+
+        inline void read_chunk() {
+            DCHECK(!m_in->eof()) << "decoding past the end of the stream";
+            m_remaining = m_in->read_compressed_int<size_t>();
+            m_bytes.resize(m_in->read_compressed_int<size_t>());
+            for(uint8_t& b : m_bytes) b = m_in->read_int<uint8_t>(8);
+
+            m_next_byte = m_bytes.data();
+            for(size_t j = 0; j < m_states; ++j) {
+                uint32_t x = 0;
+                for(size_t b = 0; b < 4; ++b) x = (x << 8) | *m_next_byte++;
+                m_x[j] = x;
+            }
+            m_state = 0;
+        }
+
+    public:
+        inline Decoder(Env&& env, std::shared_ptr<BitIStream> in)
+            : tdc::Decoder(std::move(env), in) {
+
+            m_states = m_in->read_int<size_t>(5) + 1;
+            if(m_in->read_bit()) {
+                m_model = std::make_unique<rans::Model>(*m_in);
+            }
+        }
+
+        inline Decoder(Env&& env, Input& in)
+            : Decoder(std::move(env), std::make_shared<BitIStream>(in)) {
+        }
+
+        /// \brief Tests whether all encoded values have been decoded.
+        inline bool eof() const {
+            return m_remaining == 0 && m_in->eof();
+        }
+
+        using tdc::Decoder::decode; // binary decoding of all other values
+
+        template<typename value_t>
+        inline value_t decode(const LiteralRange&) {
+            uliteral_t c;
+            if(m_model) {
+                // a chunk is read when its first literal is decoded, as it
+                // was written at that position
+                if(m_remaining == 0) read_chunk();
+                --m_remaining;
+
+                c = m_model->decode(m_x[m_state], m_next_byte);
+                if(++m_state == m_states) m_state = 0;
+            } else {
+                c = m_in->read_int<uliteral_t>();
+            }
+            return value_t(c);
+        }
+    };
+};
+
+} //ns
@@ -0,0 +1,429 @@
+#pragma once
+
+#include <cstring>
+#include <vector>
+
+#include <tudocomp/util.hpp>
+#include <tudocomp/Coder.hpp>
+
+namespace tdc {
+namespace rc {
+
+/// The probability of a binary decision to be zero, scaled to
+/// `[0, PROB_ONE)`.
+using prob_t = uint16_t;
+
+constexpr size_t PROB_BITS = 11;
+constexpr prob_t PROB_ONE = prob_t(1) << PROB_BITS;
+constexpr prob_t PROB_INIT = PROB_ONE / 2;
+
+/// The adaption rate of probabilities, larger values adapt slower.
+constexpr size_t ADAPT_SHIFT = 5;
+
+constexpr uint32_t RANGE_TOP = uint32_t(1) << 24;
+
+/// \brief Binary range encoder writing bytes to a buffer.
+///
+/// The carry handling follows the range coder of LZMA: the low end of the
+/// range is kept with 33 bits, and a byte followed by a run of 0xFF bytes is
+/// withheld until it is known whether a carry propagates into it.
+class BitEncoder {
+    std::vector<uint8_t> m_bytes;
+    uint64_t m_low;
+    uint32_t m_range;
+    uint8_t m_cache;
+    size_t m_cache_size;
+
+    inline void shift_low() {
+        if(uint32_t(m_low) < 0xFF000000U || (m_low >> 32) != 0) {
+            uint8_t carry = uint8_t(m_low >> 32);
+            uint8_t b = m_cache;
+            do {
+                m_bytes.push_back(uint8_t(b + carry));
+                b = 0xFF;
+            } while(--m_cache_size != 0);
+            m_cache = uint8_t(m_low >> 24);
+        }
+        ++m_cache_size;
+        m_low = (m_low & 0x00FFFFFFU) << 8;
+    }
+
+public:
+    inline BitEncoder() { reset(); }
+
+    /// Starts a new code, discarding all written bytes.
+    inline void reset() {
+        m_bytes.clear();
+        m_low = 0;
+        m_range = 0xFFFFFFFFU;
+        m_cache = 0;
+        m_cache_size = 1;
+    }
+
+    /// Codes `bit` with the probability `p` and adapts `p`.
+    inline bool code(prob_t& p, bool bit) {
+        const uint32_t bound = (m_range >> PROB_BITS) * p;
+        if(!bit) {
+            m_range = bound;
+            p += (PROB_ONE - p) >> ADAPT_SHIFT;
+        } else {
+            m_low += bound;
+            m_range -= bound;
+            p -= p >> ADAPT_SHIFT;
+        }
+        if(m_range < RANGE_TOP) {
+            m_range <<= 8;
+            shift_low();
+        }
+        return bit;
+    }
+
+    /// Codes `bit` with probability one half.
+    inline bool code_direct(bool bit) {
+        m_range >>= 1;
+        if(bit) m_low += m_range;
+        if(m_range < RANGE_TOP) {
+            m_range <<= 8;
+            shift_low();
+        }
+        return bit;
+    }
+
+    /// Terminates the code and returns all of its bytes.
+    inline const std::vector<uint8_t>& finish() {
+        for(size_t i = 0; i < 5; ++i) shift_low();
+        return m_bytes;
+    }
+};
+
+/// \brief Binary range decoder reading bytes written by \ref BitEncoder.
+class BitDecoder {
+    std::vector<uint8_t> m_bytes;
+    size_t m_pos;
+    uint32_t m_code;
+    uint32_t m_range;
+
+    inline uint8_t next_byte() {
+        return (m_pos < m_bytes.size()) ? m_bytes[m_pos++] : 0;
+    }
+
+public:
+    /// Starts decoding the code stored in `bytes()`.
+    inline void reset() {
+        m_pos = 0;
+        m_code = 0;
+        m_range = 0xFFFFFFFFU;
+        for(size_t i = 0; i < 5; ++i) m_code = (m_code << 8) | next_byte();
+    }
+
+    inline std::vector<uint8_t>& bytes() { return m_bytes; }
+
+    /// Decodes a bit with the probability `p` and adapts `p`.
+    inline bool code(prob_t& p, bool = false) {
+        const uint32_t bound = (m_range >> PROB_BITS) * p;
+        bool bit;
+        if(m_code < bound) {
+            m_range = bound;
+            p += (PROB_ONE - p) >> ADAPT_SHIFT;
+            bit = false;
+        } else {
+            m_code -= bound;
+            m_range -= bound;
+            p -= p >> ADAPT_SHIFT;
+            bit = true;
+        }
+        if(m_range < RANGE_TOP) {
+            m_range <<= 8;
+            m_code = (m_code << 8) | next_byte();
+        }
+        return bit;
+    }
+
+    /// Decodes a bit with probability one half.
+    inline bool code_direct(bool = false) {
+        m_range >>= 1;
+        const bool bit = (m_code >= m_range);
+        if(bit) m_code -= m_range;
+        if(m_range < RANGE_TOP) {
+            m_range <<= 8;
+            m_code = (m_code << 8) | next_byte();
+        }
+        return bit;
+    }
+};
+
+/// \brief The adaptive models of \ref RangeCoder.
+///
+/// All models are written once as functions of a bit coder `c` that either
+/// encodes the given bits (\ref BitEncoder) or ignores them and returns the
+/// decoded bits (\ref BitDecoder), such that encoder and decoder cannot
+/// diverge.
+class Models {
+public:
+    /// Number of high mantissa bits of integers that are modelled
+    /// adaptively, all lower bits are coded with probability one half.
+    static constexpr size_t MODELLED_BITS = 4;
+
+private:
+    static constexpr size_t MAX_BITS = 64;
+    static constexpr size_t INT_CONTEXTS = 2 * (MAX_BITS + 1);
+    static constexpr size_t LENGTH_TREE = 128; // >= 2^bits_for(MAX_BITS)
+    static constexpr size_t MANTISSA_TREE = size_t(1) << MODELLED_BITS;
+
+    size_t m_order;
+    size_t m_literal_contexts;
+    uliteral_t m_prev1 = 0, m_prev2 = 0;
+    bool m_prev_bit = false;
+
+    std::vector<prob_t> m_literal;
+    std::vector<prob_t> m_length;
+    std::vector<prob_t> m_mantissa;
+    prob_t m_bit[2];
+
+    inline size_t literal_context() const {
+        switch(m_order) {
+            case 0: return 0;
+            case 1: return m_prev1;
+            default:
+                // hash the last two literals to 12 bits
+                return (((uint32_t(m_prev2) << 8) | m_prev1) * 0x9E3779B1U) >> 20;
+        }
+    }
+
+    // codes the `bits` low bits of `v` with a binary tree of models
+    template<typename coder_t>
+    inline static size_t code_tree(coder_t& c, prob_t* tree, size_t bits, size_t v) {
+        size_t node = 1;
+        for(size_t i = bits; i > 0; --i) {
+            node = (node << 1) | c.code(tree[node], (v >> (i - 1)) & 1);
+        }
+        return node - (size_t(1) << bits);
+    }
+
+public:
+    /// Creates models for literals with contexts of the given order
+    /// (0, 1 or 2).
+    inline Models(size_t order)
+        : m_order(std::min<size_t>(order, 2))
+        , m_literal_contexts(m_order == 0 ? 1 : m_order == 1 ? 256 : 4096)
+        , m_literal(m_literal_contexts * 256, PROB_INIT)
+        , m_length(INT_CONTEXTS * LENGTH_TREE, PROB_INIT)
+        , m_mantissa(INT_CONTEXTS * (MAX_BITS + 1) * MANTISSA_TREE, PROB_INIT)
+    {
+        m_bit[0] = m_bit[1] = PROB_INIT;
+    }
+
+    /// Codes a literal in the context of the preceding literals.
+    template<typename coder_t>
+    inline uliteral_t literal(coder_t& c, uliteral_t v) {
+        prob_t* tree = &m_literal[literal_context() * 256];
+        const uliteral_t r = uliteral_t(code_tree(c, tree, 8, v));
+        m_prev2 = m_prev1;
+        m_prev1 = r;
+        return r;
+    }
+
+    /// Codes a bit in the context of the preceding bit.
+    template<typename coder_t>
+    inline bool bit(coder_t& c, bool v) {
+        m_prev_bit = c.code(m_bit[m_prev_bit], v);
+        return m_prev_bit;
+    }
+
+    /// Codes an integer `v` of at most `k` bits.
+    ///
+    /// The bit length of `v` is coded with a binary tree of models,
+    /// followed by the \ref MODELLED_BITS highest bits after the leading one
+    /// with models depending on the bit length, and the remaining bits
+    /// directly. The models depend on `k` and on whether the values tend
+    /// to be small (`min_distributed`).
+    template<typename coder_t>
+    inline uint64_t integer(coder_t& c, uint64_t v, size_t k, bool min_distributed) {
+        if(k == 0) return 0;
+        DCHECK_LE(k, size_t(MAX_BITS));
+
+        const size_t ctx = k + (min_distributed ? MAX_BITS + 1 : 0);
+        const size_t l = code_tree(c, &m_length[ctx * LENGTH_TREE],
+                                   bits_for(k), bits_hi(v));
+        if(l <= 1) return l;
+
+        // code the mantissa below the leading one
+        const size_t mbits = l - 1;
+        const size_t modelled = (mbits < MODELLED_BITS) ? mbits : MODELLED_BITS;
+        const size_t direct = mbits - modelled;
+
+        prob_t* tree = &m_mantissa[(ctx * (MAX_BITS + 1) + l) * MANTISSA_TREE];
+        uint64_t r = (uint64_t(1) << modelled) |
+            code_tree(c, tree, modelled, v >> direct);
+        for(size_t i = direct; i > 0; --i) {
+            r = (r << 1) | c.code_direct((v >> (i - 1)) & 1);
+        }
+        return r;
+    }
+};
+
+} //ns rc
+
+/// \brief Adaptive binary range coding with context models.
+///
+/// All values are decomposed into binary decisions that are coded by a
+/// range coder with adaptive probabilities, so no statistics need to be
+/// gathered or stored beforehand:
+///
+/// - literals are coded bitwise with a binary tree of models
+///   for each context of the previous `order` literals (0, 1 or 2, where
+///   the contexts of order 2 are hashed),
+/// - bits are coded with a model depending on the previous bit,
+/// - integers are coded by their bit length and the highest bits of their
+///   mantissa with models depending on their range, see
+///   \ref rc::Models::integer.
+///
+/// The code is written in chunks of at most `chunk` values that are each
+/// preceded by their number of values and bytes, such that the decoder
+/// recognizes the end of the stream. The models are kept across chunks.
+/// Each chunk is written at the position of its first value in the output
+/// (see \ref io::BitOStream::reserve), so the coder can be interleaved with
+/// other coders and raw bits on the same stream.
+class RangeCoder : public Algorithm {
+public:
+    inline static Meta meta() {
+        Meta m("coder", "range", "Adaptive range coding with context models");
+        m.option("order").dynamic(1);
+        m.option("chunk").dynamic(1 << 16);
+        return m;
+    }
+
+    RangeCoder() = delete;
+
+    /// \brief Encodes data with an adaptive range coder.
+    class Encoder : public tdc::Encoder {
+        rc::Models m_models;
+        rc::BitEncoder m_coder;
+        size_t m_chunk;
+        size_t m_count = 0; // values in the current chunk
+        size_t m_part; // the reserved output of the current chunk
+
+        inline void write_chunk() {
+            const std::vector<uint8_t>& bytes = m_coder.finish();
+            m_out->write_reserved(m_part, [&](BitOStream& out) {
+                out.write_compressed_int(m_count);
+                out.write_compressed_int(bytes.size());
+                for(uint8_t b : bytes) out.write_int(b, 8);
+            });
+            m_coder.reset();
+            m_count = 0;
+        }
+
+        inline void next_value() {
+            if(m_count == 0) m_part = m_out->reserve();
+            if(++m_count == m_chunk) write_chunk();
+        }
+
+    public:
+        template<typename literals_t>
+        inline Encoder(Env&& env, std::shared_ptr<BitOStream> out, literals_t&& literals)
+            : tdc::Encoder(std::move(env), out, literals)
+            , m_models(this->env().option("order").as_integer())
+            , m_chunk(std::max<size_t>(this->env().option("chunk").as_integer(), 1)) {
+        }
+
+        template<typename literals_t>
+        inline Encoder(Env&& env, Output& out, literals_t&& literals)
+            : Encoder(std::move(env), std::make_shared<BitOStream>(out), literals) {
+        }
+
+        inline ~Encoder() {
+            if(m_count > 0) write_chunk();
+        }
+
+        template<typename value_t>
+        inline void encode(value_t v, const Range& r) {
+            m_models.integer(m_coder, uint64_t(v) - r.min(), bits_hi(r.delta()), false);
+            next_value();
+        }
+
+        template<typename value_t>
+        inline void encode(value_t v, const MinDistributedRange& r) {
+            m_models.integer(m_coder, uint64_t(v) - r.min(), bits_hi(r.delta()), true);
+            next_value();
+        }
+
+        template<typename value_t>
+        inline void encode(value_t v, const BitRange&) {
+            m_models.bit(m_coder, bool(v));
+            next_value();
+        }
+
+        template<typename value_t>
+        inline void encode(value_t v, const LiteralRange&) {
+            m_models.literal(m_coder, uliteral_t(v));
+            next_value();
+        }
+    };
+
+    /// \brief Decodes data with an adaptive range coder.
+    class Decoder : public tdc::Decoder {
+        rc::Models m_models;
+        rc::BitDecoder m_coder;
+        size_t m_remaining = 0; // values left in the current chunk
+
+        inline void read_chunk() {
+            DCHECK(!m_in->eof()) << "decoding past the end of the stream";
+            m_remaining = m_in->read_compressed_int<size_t>();
+            std::vector<uint8_t>& bytes = m_coder.bytes();
+            bytes.resize(m_in->read_compressed_int<size_t>());
+            for(uint8_t& b : bytes) b = m_in->read_int<uint8_t>(8);
+            m_coder.reset();
+        }
+
+        // a chunk is read when its first value is decoded, as it was
+        // written at that position
+        inline void next_value() {
+            if(m_remaining == 0) read_chunk();
+            --m_remaining;
+        }
+
+    public:
+        inline Decoder(Env&& env, std::shared_ptr<BitIStream> in)
+            : tdc::Decoder(std::move(env), in)
+            , m_models(this->env().option("order").as_integer()) {
+        }
+
+        inline Decoder(Env&& env, Input& in)
+            : Decoder(std::move(env), std::make_shared<BitIStream>(in)) {
+        }
+
+        /// \brief Tests whether all encoded values have been decoded.
+        inline bool eof() const {
+            return m_remaining == 0 && m_in->eof();
+        }
+
+        template<typename value_t>
+        inline value_t decode(const Range& r) {
+            next_value();
+            const uint64_t v = m_models.integer(m_coder, 0, bits_hi(r.delta()), false);
+            return value_t(r.min() + v);
+        }
+
+        template<typename value_t>
+        inline value_t decode(const MinDistributedRange& r) {
+            next_value();
+            const uint64_t v = m_models.integer(m_coder, 0, bits_hi(r.delta()), true);
+            return value_t(r.min() + v);
+        }
+
+        template<typename value_t>
+        inline value_t decode(const BitRange&) {
+            next_value();
+            return value_t(m_models.bit(m_coder, false));
+        }
+
+        template<typename value_t>
+        inline value_t decode(const LiteralRange&) {
+            next_value();
+            return value_t(m_models.literal(m_coder, 0));
+        }
+    };
+};
+
+} //ns
@@ -2,6 +2,7 @@
 
 #include <tudocomp/Compressor.hpp>
 #include <tudocomp/compressors/lz78/LZ78Trie.hpp>
+#include <tudocomp/compressors/lz78/ParallelParsing.hpp>
 #include <tudocomp/Range.hpp>
 
 #include <tudocomp_stat/StatPhase.hpp>
@@ -18,6 +19,12 @@ namespace tdc {
             std::vector<uliteral_t> literals;
 
             public:
+            /// Adds a factor to the dictionary without decoding it.
+            inline void seed(lz78::factorid_t index, uliteral_t literal) {
+                indices.push_back(index);
+                literals.push_back(literal);
+            }
+
             inline void decompress(lz78::factorid_t index, uliteral_t literal, std::ostream& out) {
                 indices.push_back(index);
                 literals.push_back(literal);
@@ -47,36 +54,34 @@ private:
     /// Max dictionary size before reset
     const lz78::factorid_t m_dict_max_size {0}; //! Maximum dictionary size before reset, 0 == unlimited
 
-public:
-    inline LZ78Compressor(Env&& env):
-        Compressor(std::move(env)),
-        m_dict_max_size(env.option("dict_size").as_integer())
-    {}
-
-    inline static Meta meta() {
-        Meta m("compressor", "lz78", "Lempel-Ziv 78\n\n" LZ78_DICT_SIZE_DESC);
-        m.option("coder").templated<coder_t, BitCoder>("coder");
-        m.option("lz78trie").templated<dict_t, lz78::TernaryTrie>("lz78trie");
-        m.option("dict_size").dynamic(0);
-        return m;
-    }
-
-    virtual void compress(Input& input, Output& out) override {
-        const size_t n = input.size();
-        const size_t reserved_size = isqrt(n)*2;
-        auto is = input.as_stream();
-
-        // Stats
-        StatPhase phase1("Lz78 compression");
+    const size_t m_threads;
+    const size_t m_seed;
 
-        IF_STATS(size_t stat_dictionary_resets = 0);
-        IF_STATS(size_t stat_dict_counter_at_last_reset = 0);
-        IF_STATS(size_t stat_factor_count = 0);
+    struct Stats {
         size_t factor_count = 0;
+        size_t dictionary_resets = 0;
+        size_t dict_counter_at_last_reset = 0;
+    };
+
+    /// Parses `seed` into the dictionary without encoding it.
+    /// `on_factor(index, c)` is called for every factor that is added.
+    template<class F>
+    inline static void parse_seed(dict_t& dict, View seed, F on_factor) {
+        node_t node = dict.get_rootnode(0);
+        for(const uliteral_t c : seed) {
+            node_t child = dict.find_or_insert(node, c);
+            if(child.is_new()) {
+                on_factor(node.id(), c);
+                node = dict.get_rootnode(0);
+            } else {
+                node = child;
+            }
+        }
+    }
 
-        size_t remaining_characters = n; // position in the text
-        dict_t dict(env().env_for_option("lz78trie"), n, remaining_characters, reserved_size);
-
+    /// Factorizes the text read from `is` with a dictionary seeded by `seed`.
+    inline void factorize(std::istream& is, dict_t& dict, size_t& remaining_characters,
+                          View seed, Env&& coder_env, Output& out, Stats& stats) const {
         auto reset_dict = [&dict] () {
             dict.clear();
             node_t node = dict.add_rootnode(0);
@@ -85,7 +90,10 @@ public:
         };
         reset_dict();
 
-        typename coder_t::Encoder coder(env().env_for_option("coder"), out, NoLiterals());
+        parse_seed(dict, seed, [](lz78::factorid_t, uliteral_t){});
+        size_t factor_count = dict.size() - 1;
+
+        typename coder_t::Encoder coder(std::move(coder_env), out, NoLiterals());
 
         // Define ranges
         node_t node = dict.get_rootnode(0);
@@ -101,7 +109,7 @@ public:
                 coder.encode(node.id(), Range(factor_count));
                 coder.encode(static_cast<uliteral_t>(c), literal_r);
                 factor_count++;
-                IF_STATS(stat_factor_count++);
+                stats.factor_count++;
                 parent = node = dict.get_rootnode(0); // return to the root
                 DCHECK_EQ(node.id(), 0);
                 DCHECK_EQ(parent.id(), 0);
@@ -111,8 +119,8 @@ public:
                     DCHECK(false); // broken right now
                     reset_dict();
                     factor_count = 0; //coder.dictionary_reset();
-                    IF_STATS(stat_dictionary_resets++);
-                    IF_STATS(stat_dict_counter_at_last_reset = m_dict_max_size);
+                    stats.dictionary_resets++;
+                    stats.dict_counter_at_last_reset = m_dict_max_size;
                 }
             } else { // traverse further
                 parent = node;
@@ -127,30 +135,157 @@ public:
 //            // TODO: this check only works if the trie is not the MonteCarloTrie !
 //            DCHECK_EQ(dict.find_or_insert(parent, static_cast<uliteral_t>(c)).id(), node.id());
             factor_count++;
-            IF_STATS(stat_factor_count++);
+            stats.factor_count++;
+        }
+    }
+
+    /// Decodes the factors read from `input`.
+    /// `decomp` has to contain the factors of the seed already.
+    inline static void defactorize(lz78::Decompressor& decomp, uint64_t factor_count,
+                                   Env&& coder_env, Input& input, std::ostream& out) {
+        typename coder_t::Decoder decoder(std::move(coder_env), input);
+
+        while (!decoder.eof()) {
+            const lz78::factorid_t index = decoder.template decode<lz78::factorid_t>(Range(factor_count));
+            const uliteral_t chr = decoder.template decode<uliteral_t>(literal_r);
+            decomp.decompress(index, chr, out);
+            factor_count++;
+        }
+    }
+
+    inline void compress_parallel(Input& input, Output& out, Stats& stats) {
+        auto view = input.as_view();
+        const size_t n = view.size();
+        const auto bounds = lz78::partition(n, m_threads);
+        const View seed = view.substr(0, std::min(m_seed, bounds[1]));
+
+        // The dictionaries are created and destroyed by this thread,
+        // since they may log statistics.
+        std::vector<size_t> remaining_characters(m_threads);
+        std::vector<dict_t> dicts;
+        std::vector<Env> coder_envs;
+        dicts.reserve(m_threads);
+        for(size_t i = 0; i < m_threads; ++i) {
+            const size_t chunk_n = bounds[i+1] - bounds[i];
+            remaining_characters[i] = chunk_n;
+            dicts.emplace_back(env().env_for_option("lz78trie"), chunk_n,
+                               remaining_characters[i], isqrt(chunk_n)*2);
+            coder_envs.push_back(env().env_for_option("coder"));
+        }
+
+        std::vector<std::vector<uint8_t>> chunks(m_threads);
+        std::vector<Stats> chunk_stats(m_threads);
+        parallel_for(m_threads, m_threads, [&](size_t i) {
+            io::ViewStream is(view.slice(bounds[i], bounds[i+1]));
+            Output chunk_out(chunks[i]);
+            factorize(is.stream(), dicts[i], remaining_characters[i],
+                      i == 0 ? View() : seed,
+                      std::move(coder_envs[i]), chunk_out, chunk_stats[i]);
+        });
+
+        for(const auto& s : chunk_stats) stats.factor_count += s.factor_count;
+        lz78::write_chunks(out, seed.size(), chunks);
+    }
+
+    inline void decompress_parallel(Input& input, std::ostream& out) {
+        auto view = input.as_view();
+        const lz78::Chunks chunks = lz78::read_chunks(view);
+        const size_t k = chunks.chunks.size();
+
+        std::vector<std::vector<uint8_t>> texts(k);
+        std::vector<Env> coder_envs;
+        for(size_t i = 0; i < k; ++i) {
+            coder_envs.push_back(env().env_for_option("coder"));
+        }
+
+        auto decode_chunk = [&](size_t i, lz78::Decompressor decomp, uint64_t factor_count) {
+            Input chunk_in(chunks.chunks[i]);
+            Output chunk_out(texts[i]);
+            auto os = chunk_out.as_stream();
+            defactorize(decomp, factor_count, std::move(coder_envs[i]), chunk_in, os);
+        };
+        if(k == 0) return;
+
+        // the seed is a prefix of the first chunk
+        decode_chunk(0, lz78::Decompressor(), 0);
+        CHECK_LE(chunks.seed_length, texts[0].size()) << "corrupted compressed file";
+
+        lz78::Decompressor seeded;
+        uint64_t seed_factors = 0;
+        {
+            size_t seed_remaining = chunks.seed_length;
+            dict_t dict(env().env_for_option("lz78trie"), chunks.seed_length, seed_remaining);
+            dict.add_rootnode(0);
+            parse_seed(dict, View(texts[0].data(), chunks.seed_length),
+                [&](lz78::factorid_t index, uliteral_t c) {
+                    seeded.seed(index, c);
+                    seed_factors++;
+                });
+        }
+
+        parallel_for(k - 1, m_threads, [&](size_t i) {
+            decode_chunk(i + 1, seeded, seed_factors);
+        });
+
+        for(const auto& text : texts) {
+            out.write((const char*) text.data(), text.size());
+        }
+    }
+
+public:
+    inline LZ78Compressor(Env&& env):
+        Compressor(std::move(env)),
+        m_dict_max_size(this->env().option("dict_size").as_integer()),
+        m_threads(std::max<size_t>(this->env().option("threads").as_integer(), 1)),
+        m_seed(this->env().option("seed").as_integer())
+    {
+        CHECK(m_threads == 1 || m_dict_max_size == 0) << "dict_size is not supported with multiple threads";
+    }
+
+    inline static Meta meta() {
+        Meta m("compressor", "lz78", "Lempel-Ziv 78\n\n" LZ78_DICT_SIZE_DESC "\n\n" LZ78_THREADS_DESC);
+        m.option("coder").templated<coder_t, BitCoder>("coder");
+        m.option("lz78trie").templated<dict_t, lz78::TernaryTrie>("lz78trie");
+        m.option("dict_size").dynamic(0);
+        m.option("threads").dynamic(1);
+        m.option("seed").dynamic(0);
+        return m;
+    }
+
+    virtual void compress(Input& input, Output& out) override {
+        // Stats
+        StatPhase phase1("Lz78 compression");
+        Stats stats;
+
+        if(m_threads > 1) {
+            compress_parallel(input, out, stats);
+        } else {
+            const size_t n = input.size();
+            const size_t reserved_size = isqrt(n)*2;
+            auto is = input.as_stream();
+
+            size_t remaining_characters = n; // position in the text
+            dict_t dict(env().env_for_option("lz78trie"), n, remaining_characters, reserved_size);
+            factorize(is, dict, remaining_characters, View(), env().env_for_option("coder"), out, stats);
         }
 
         IF_STATS(
-        phase1.log_stat("factor_count", stat_factor_count);
+        phase1.log_stat("factor_count", stats.factor_count);
         phase1.log_stat("dictionary_reset_counter",
-                       stat_dictionary_resets);
+                       stats.dictionary_resets);
         phase1.log_stat("max_factor_counter",
-                       stat_dict_counter_at_last_reset);
+                       stats.dict_counter_at_last_reset);
         )
     }
 
     virtual void decompress(Input& input, Output& output) override final {
         auto out = output.as_stream();
-        typename coder_t::Decoder decoder(env().env_for_option("coder"), input);
-
-        lz78::Decompressor decomp;
-        uint64_t factor_count = 0;
 
-        while (!decoder.eof()) {
-            const lz78::factorid_t index = decoder.template decode<lz78::factorid_t>(Range(factor_count));
-            const uliteral_t chr = decoder.template decode<uliteral_t>(literal_r);
-            decomp.decompress(index, chr, out);
-            factor_count++;
+        if(m_threads > 1) {
+            decompress_parallel(input, out);
+        } else {
+            lz78::Decompressor decomp;
+            defactorize(decomp, 0, env().env_for_option("coder"), input, out);
         }
 
         out.flush();
@@ -160,4 +295,3 @@ public:
 
 
 }//ns
-
@@ -2,9 +2,6 @@
 
 #include <tudocomp/Compressor.hpp>
 
-#include <sdsl/cst_fully.hpp>
-#include <sdsl/cst_sada.hpp>
-
 #include <tudocomp/Range.hpp>
 #include <tudocomp/ds/TextDS.hpp>
 
@@ -86,7 +83,7 @@ namespace lz78u {
     };
 }
 
-template<typename strategy_t, typename ref_coder_t>
+template<typename strategy_t, typename ref_coder_t, typename text_t = TextDS<>>
 class LZ78UCompressor: public Compressor {
 private:
     using node_type = lz78u::SuffixTree::node_type;
@@ -108,9 +105,11 @@ public:
         Meta m("compressor", "lz78u", "Lempel-Ziv 78 U\n\n" );
         m.option("comp").templated<strategy_t>("lz78u_strategy");
         m.option("coder").templated<ref_coder_t>("coder");
+        m.option("textds").templated<text_t, TextDS<>>("textds");
         m.option("threshold").dynamic("3");
         // m.option("dict_size").dynamic("inf");
         m.input_restrictions(io::InputRestrictions({0},true));
+        m.uses_textds<text_t>(text_t::SA | text_t::LCP);
         return m;
     }
 
@@ -123,20 +122,28 @@ public:
         auto iview = input.as_view();
         View T = iview;
 
-        lz78u::SuffixTree::cst_t backing_cst;
-        StatPhase::wrap("construct suffix tree", [&]{
-            // TODO: Specialize sdsl template for less alloc here
-            std::string bad_copy_1 = T.slice(0, T.size() - 1);
-            //std::cout << "text: " << vec_to_debug_string(bad_copy_1) << "\n";
+        auto backing_cst = StatPhase::wrap("construct suffix tree", [&]{
+            // the suffix and LCP arrays are discarded with the text ds
+            text_t text(env().env_for_option("textds"), T, text_t::SA | text_t::LCP);
+            lz78u::SuffixTree::cst_t cst(text.require_sa(), text.require_lcp());
 
-            construct_im(backing_cst, bad_copy_1, 1);
+            StatPhase::log("internal nodes", cst.internal_nodes());
+            StatPhase::log("size", cst.size_in_bytes());
+            return cst;
         });
         lz78u::SuffixTree ST(backing_cst);
 
-        const size_t max_z = T.size() * bits_for(ST.cst.csa.sigma) / bits_for(T.size());
+        size_t sigma = 0;
+        {
+            std::vector<bool> occurs(ULITERAL_MAX+1, false);
+            for(auto c : T) occurs[c] = true;
+            for(bool b : occurs) sigma += b;
+        }
+
+        const size_t max_z = T.size() * bits_for(sigma) / bits_for(T.size());
         phase1.log_stat("max z", max_z);
 
-        sdsl::int_vector<> R(ST.internal_nodes,0,bits_for(max_z));
+        DynamicIntVector R(ST.internal_nodes,0,bits_for(max_z));
 
         len_t pos = 0;
         len_t z = 0;
@@ -171,11 +178,11 @@ public:
                 for(len_t pos = begin; pos < end;) {
                     // similar to the normal LZ78U factorization, but does not introduce new factor ids
 
-                    const node_t leaf = ST.select_leaf(ST.cst.csa.isa[pos]);
+                    const node_t leaf = ST.leaf(pos);
                     len_t d = 1;
                     node_t parent = ST.root;
                     node_t node = ST.level_anc(leaf, d);
-                    while(!ST.cst.is_leaf(node) && R[ST.nid(node)] != 0) {
+                    while(!ST.is_leaf(node) && R[ST.nid(node)] != 0u) {
                         parent = node;
                         node = ST.level_anc(leaf, ++d);
                     } // not a good feature: We lost the factor ids of the leaves, since R only stores the IDs of internal nodes
@@ -224,10 +231,10 @@ public:
 
         // Skip the trailing 0
         while(pos < T.size() - 1) {
-            const node_t l = ST.select_leaf(ST.cst.csa.isa[pos]);
+            const node_t l = ST.leaf(pos);
             const len_t leaflabel = pos;
 
-            if(ST.parent(l) == ST.root || R[ST.nid(ST.parent(l))] != 0) {
+            if(ST.parent(l) == ST.root || R[ST.nid(ST.parent(l))] != 0u) {
                 const len_t parent_strdepth = ST.str_depth(ST.parent(l));
 
                 //std::cout << "out leaf: [" << (pos+parent_strdepth)  << ","<< (pos + parent_strdepth + 1) << "] ";
@@ -248,7 +255,7 @@ public:
             node_t node = ST.level_anc(l, d);
 
 
-            while(R[ST.nid(node)] != 0) {
+            while(R[ST.nid(node)] != 0u) {
                 parent = node;
                 node = ST.level_anc(l, ++d);
             }
@@ -11,6 +11,7 @@
 #include <tudocomp/compressors/lzss/LZSSFactors.hpp>
 #include <tudocomp/compressors/lzss/LZSSLiterals.hpp>
 #include <tudocomp/compressors/lzss/LZSSCoding.hpp>
+#include <tudocomp/compressors/lzss/LZSSPSVNSV.hpp>
 
 #include <tudocomp/ds/TextDS.hpp>
 
@@ -18,8 +19,11 @@
 
 namespace tdc {
 
-/// Computes the LZ77 factorization of the input using its suffix array and
-/// LCP table.
+/// Computes the LZ77 factorization of the input using its suffix array.
+///
+/// The factorization takes linear time: the previous and next smaller values
+/// of the suffix array are computed in one scan, and the factor lengths by
+/// character comparisons, whose number is linear in the factor lengths.
 template<typename coder_t, typename text_t = TextDS<>>
 class LZSSLCPCompressor : public Compressor {
 public:
@@ -28,7 +32,7 @@ public:
         m.option("coder").templated<coder_t>("coder");
         m.option("textds").templated<text_t, TextDS<>>("textds");
         m.option("threshold").dynamic(3);
-        m.uses_textds<text_t>(text_t::SA | text_t::ISA | text_t::LCP);
+        m.uses_textds<text_t>(text_t::SA);
         return m;
     }
 
@@ -45,70 +49,30 @@ public:
 
         // Construct text data structures
         text_t text = StatPhase::wrap("Construct Text DS", [&]{
-            return text_t(env().env_for_option("textds"), view,
-                    text_t::SA | text_t::ISA | text_t::LCP);
+            return text_t(env().env_for_option("textds"), view, text_t::SA);
         });
 
         auto& sa = text.require_sa();
-        auto& isa = text.require_isa();
-        auto& lcp = text.require_lcp();
 
-        // Factorize
         const len_t text_length = text.size();
+
+        lzss::PSVNSV psvnsv = StatPhase::wrap("Compute PSV and NSV", [&]{
+            return lzss::PSVNSV(sa, text_length);
+        });
+
+        // Factorize
         lzss::FactorBuffer factors;
 
         StatPhase::wrap("Factorize", [&]{
             const len_t threshold = env().option("threshold").as_integer(); //factor threshold
 
-            for(len_t i = 0; i+1 < text_length;) { // we omit T[text_length-1] since we assume that it is the \0 byte!
-                //get SA position for suffix i
-                const size_t& cur_pos = isa[i];
-			    DCHECK_NE(cur_pos,0); // isa[i] == 0 <=> T[i] = 0
-
-			    //compute naively PSV
-                //search "upwards" in LCP array
-                //include current, exclude last
-                size_t psv_lcp = lcp[cur_pos];
-                ssize_t psv_pos = cur_pos - 1;
-                if (psv_lcp > 0) {
-                    while (psv_pos >= 0 && sa[psv_pos] > sa[cur_pos]) {
-                        psv_lcp = std::min<size_t>(psv_lcp, lcp[psv_pos--]);
-                    }
-                }
-
-			    //compute naively NSV, TODO: use NSV data structure
-                //search "downwards" in LCP array
-                //exclude current, include last
-                size_t nsv_lcp = 0;
-                size_t nsv_pos = cur_pos + 1;
-                if (nsv_pos < text_length) {
-                    nsv_lcp = SSIZE_MAX;
-                    do {
-                        nsv_lcp = std::min<size_t>(nsv_lcp, lcp[nsv_pos]);
-                        if (sa[nsv_pos] < sa[cur_pos]) {
-                            break;
-                        }
-                    } while (++nsv_pos < text_length);
-
-                    if (nsv_pos >= text_length) {
-                        nsv_lcp = 0;
-                    }
-                }
-
-                //select maximum
-                const size_t& max_lcp = std::max(psv_lcp, nsv_lcp);
-                if(max_lcp >= threshold) {
-				    const ssize_t& max_pos = max_lcp == psv_lcp ? psv_pos : nsv_pos;
-				    DCHECK_LT(max_pos, text_length);
-				    DCHECK_GE(max_pos, 0);
-                    // new factor
-                    factors.emplace_back(i, sa[max_pos], max_lcp);
-
-                    i += max_lcp; //advance
-                } else {
-                    ++i; //advance
-                }
-            }
+            // we omit T[text_length-1] since we assume that it is the \0 byte!
+            lzss::factorize_greedy(view, text_length, psvnsv,
+                0, text_length - 1, threshold,
+                [&](len_t pos, len_t src, len_t len) {
+                    factors.emplace_back(pos, src, len);
+                },
+                [](len_t) {});
 
             StatPhase::log("threshold", threshold);
             StatPhase::log("factors", factors.size());
@@ -0,0 +1,247 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include <tudocomp/Compressor.hpp>
+#include <tudocomp/Literal.hpp>
+#include <tudocomp/Range.hpp>
+#include <tudocomp/util.hpp>
+
+#include <tudocomp/compressors/lzss/LZSSFactors.hpp>
+#include <tudocomp/compressors/lzss/LZSSPSVNSV.hpp>
+#include <tudocomp/ds/IntVector.hpp>
+#include <tudocomp/util/divsufsort.hpp>
+
+#include <tudocomp_stat/StatPhase.hpp>
+
+namespace tdc {
+
+/// Computes a greedy LZ77 factorization of the input stream with bounded
+/// memory.
+///
+/// The input is read into a buffer whose size is chosen such that the buffer,
+/// its suffix array and its PSV and NSV arrays fit into the given amount of
+/// memory. The buffer is factorized like in \ref LZSSLCPCompressor, except for
+/// its last eighth, which only serves as lookahead for factors starting
+/// before it. Then the buffer is shifted such that the last half of its size
+/// before the current position is kept as the window for following factors,
+/// it gets refilled from the stream and the suffix array is rebuilt.
+///
+/// Hence, factors are the longest previous factors within a window of at
+/// least half the buffer size, and the input does not need to be known as a
+/// whole.
+template<typename coder_t>
+class LZSSStreamingCompressor : public Compressor {
+private:
+    // the size of the buffer that fits into `memory` KiB
+    inline static len_t buffer_size(size_t memory) {
+        const size_t bits = memory * 1024 * 8;
+        size_t n = bits / 8;
+        for(size_t k = 0; k < 4; ++k) {
+            // text, suffix array (one bit more for divsufsort), PSV and NSV
+            n = bits / (8 + 3 * bits_for(n) + 1);
+        }
+        return std::max<size_t>(std::min<size_t>(n, INDEX_MAX), 16);
+    }
+
+    len_t m_buffer_size;
+
+    // Encodes the factorization of buf[begin, end) like lzss::encode_text,
+    // but with factor sources as distances.
+    template<typename encoder_t>
+    inline void encode_block(encoder_t& coder, const std::vector<uliteral_t>& buf,
+                             len_t begin, len_t end,
+                             const lzss::FactorBuffer& factors) const {
+
+        const len_t flen_min = factors.empty() ? 0 : factors.shortest_factor();
+        const len_t flen_max = factors.longest_factor();
+        len_t fdist_max = 0; // longest distance between two factors
+        len_t src_dist_max = 0; // longest distance to a factor's source
+        {
+            len_t p = begin;
+            for(const lzss::Factor& f : factors) {
+                fdist_max = std::max<len_t>(fdist_max, f.pos - p);
+                src_dist_max = std::max<len_t>(src_dist_max, f.pos - f.src);
+                p = f.pos + f.len;
+            }
+            fdist_max = std::max<len_t>(fdist_max, end - p);
+        }
+
+        // define ranges
+        const Range buffer_r(m_buffer_size);
+        const Range block_r(end - begin);
+        const MinDistributedRange flen_r(flen_min, flen_max);
+        const Range fdist_r(fdist_max);
+        const Range src_r(src_dist_max);
+
+        // encode ranges
+        coder.encode(end - begin, buffer_r);
+        coder.encode(flen_min, block_r);
+        coder.encode(flen_max, block_r);
+        coder.encode(fdist_max, block_r);
+        coder.encode(src_dist_max, buffer_r);
+
+        // walk over factors
+        len_t p = begin;
+        for(const lzss::Factor& f : factors) {
+            if(f.pos == p) {
+                coder.encode(false, bit_r);
+            } else {
+                coder.encode(true, bit_r);
+                coder.encode(f.pos - p, fdist_r);
+            }
+            while(p < f.pos) {
+                coder.encode(buf[p++], literal_r);
+            }
+
+            coder.encode(f.pos - f.src, src_r);
+            coder.encode(f.len, flen_r);
+            p += len_t(f.len);
+        }
+
+        if(p < end) {
+            coder.encode(true, bit_r);
+            coder.encode(end - p, fdist_r);
+        }
+        while(p < end) {
+            coder.encode(buf[p++], literal_r);
+        }
+    }
+
+public:
+    inline static Meta meta() {
+        Meta m("compressor", "lzss_stream",
+            "LZSS Factorization of a stream with bounded memory");
+        m.option("coder").templated<coder_t>("coder");
+        m.option("threshold").dynamic(3);
+        m.option("memory").dynamic(65536); // in KiB
+        return m;
+    }
+
+    /// Default constructor (not supported).
+    inline LZSSStreamingCompressor() = delete;
+
+    /// Construct the class with an environment.
+    inline LZSSStreamingCompressor(Env&& env) : Compressor(std::move(env)) {
+        m_buffer_size = buffer_size(this->env().option("memory").as_integer());
+    }
+
+    inline virtual void compress(Input& input, Output& output) override {
+        auto ins = input.as_stream();
+
+        typename coder_t::Encoder coder(env().env_for_option("coder"), output, NoLiterals());
+
+        const len_t threshold = env().option("threshold").as_integer(); //factor threshold
+        const len_t window = m_buffer_size / 2;
+        const len_t lookahead = m_buffer_size / 8;
+
+        StatPhase phase("Factorize");
+        phase.log_stat("threshold", threshold);
+        phase.log_stat("buffer_size", m_buffer_size);
+
+        std::vector<uliteral_t> buf;
+        buf.reserve(m_buffer_size);
+
+        len_t cur = 0; // the position in the buffer to continue factorizing at
+        size_t rounds = 0;
+        size_t num_factors = 0;
+
+        while(true) {
+            // refill the buffer
+            const size_t filled = buf.size();
+            buf.resize(m_buffer_size);
+            ins.read((char*) buf.data() + filled, m_buffer_size - filled);
+            buf.resize(filled + ins.gcount());
+
+            const len_t n = buf.size();
+            const bool eof = n < m_buffer_size;
+            if(cur >= n) break;
+
+            // Construct suffix array and PSV/NSV of the buffer
+            lzss::PSVNSV psvnsv = [&]{
+                DynamicIntVector sa(n, 0, bits_for(n) + 1);
+                divsufsort(buf.data(), sa, n);
+                return lzss::PSVNSV(sa, n);
+            }();
+            ++rounds;
+
+            const len_t begin = cur;
+            lzss::FactorBuffer factors;
+            cur = lzss::factorize_greedy(buf, n, psvnsv,
+                begin, eof ? n : n - lookahead, threshold,
+                [&](len_t pos, len_t src, len_t len) {
+                    factors.emplace_back(pos, src, len);
+                },
+                [](len_t) {});
+
+            encode_block(coder, buf, begin, cur, factors);
+            num_factors += factors.size();
+
+            if(eof) break;
+
+            // keep the window preceding the current position
+            const len_t drop = (cur > window) ? cur - window : 0;
+            buf.erase(buf.begin(), buf.begin() + drop);
+            cur -= drop;
+        }
+
+        phase.log_stat("rounds", rounds);
+        phase.log_stat("factors", num_factors);
+    }
+
+    inline virtual void decompress(Input& input, Output& output) override {
+        typename coder_t::Decoder decoder(env().env_for_option("coder"), input);
+        auto outs = output.as_stream();
+
+        const Range buffer_r(m_buffer_size);
+
+        // only the last m_buffer_size characters can be referenced,
+        // all before get written to the output
+        std::vector<uliteral_t> text;
+        auto flush = [&](size_t keep) {
+            if(text.size() <= keep) return;
+            const size_t num = text.size() - keep;
+            outs.write((const char*) text.data(), num);
+            text.erase(text.begin(), text.begin() + num);
+        };
+
+        while(!decoder.eof()) {
+            // decode ranges
+            const len_t block_len = decoder.template decode<len_t>(buffer_r);
+            const Range block_r(block_len);
+            const len_t flen_min = decoder.template decode<len_t>(block_r);
+            const len_t flen_max = decoder.template decode<len_t>(block_r);
+            const MinDistributedRange flen_r(flen_min, flen_max);
+            const Range fdist_r(decoder.template decode<len_t>(block_r));
+            const Range src_r(decoder.template decode<len_t>(buffer_r));
+
+            const size_t end = text.size() + block_len;
+            while(text.size() < end) {
+                len_t num = 0;
+                if(decoder.template decode<bool>(bit_r)) {
+                    num = decoder.template decode<len_t>(fdist_r);
+                }
+                while(num--) {
+                    text.push_back(decoder.template decode<uliteral_t>(literal_r));
+                }
+
+                if(text.size() < end) {
+                    const len_t dist = decoder.template decode<len_t>(src_r);
+                    const len_t len = decoder.template decode<len_t>(flen_r);
+                    DCHECK_LE(dist, text.size());
+
+                    const size_t src = text.size() - dist;
+                    for(size_t i = 0; i < len; ++i) {
+                        text.push_back(text[src + i]);
+                    }
+                }
+            }
+
+            if(text.size() >= 3 * size_t(m_buffer_size)) flush(m_buffer_size);
+        }
+        flush(0);
+    }
+};
+
+} //ns
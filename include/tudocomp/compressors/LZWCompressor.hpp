@@ -4,6 +4,7 @@
 
 #include <tudocomp/compressors/lzw/LZWDecoding.hpp>
 #include <tudocomp/compressors/lzw/LZWFactor.hpp>
+#include <tudocomp/compressors/lz78/ParallelParsing.hpp>
 
 #include <tudocomp/Range.hpp>
 #include <tudocomp/Coder.hpp>
@@ -22,34 +23,37 @@ private:
     using node_t = typename dict_t::node_t;
 
     const lz78::factorid_t m_dict_max_size {0}; //! Maximum dictionary size before reset, 0 == unlimited
-public:
-    inline LZWCompressor(Env&& env):
-        Compressor(std::move(env)),
-        m_dict_max_size(env.option("dict_size").as_integer())
-    {}
 
-    inline static Meta meta() {
-        Meta m("compressor", "lzw", "Lempel-Ziv-Welch\n\n" LZ78_DICT_SIZE_DESC);
-        m.option("coder").templated<coder_t, BitCoder>("coder");
-        m.option("lz78trie").templated<dict_t, lz78::TernaryTrie>("lz78trie");
-        m.option("dict_size").dynamic(0);
-        return m;
-    }
+    const size_t m_threads;
+    const size_t m_seed;
 
-    virtual void compress(Input& input, Output& out) override {
-        const size_t n = input.size();
-        const size_t reserved_size = isqrt(n)*2;
-        auto is = input.as_stream();
-
-        // Stats
-        StatPhase phase("LZW Compression");
-        IF_STATS(size_t stat_dictionary_resets = 0);
-        IF_STATS(size_t stat_dict_counter_at_last_reset = 0);
-        IF_STATS(size_t stat_factor_count = 0);
+    struct Stats {
         size_t factor_count = 0;
+        size_t dictionary_resets = 0;
+        size_t dict_counter_at_last_reset = 0;
+    };
+
+    /// Parses `seed` into the dictionary without encoding it.
+    /// `on_factor(index, c)` is called for every entry that is added.
+    template<class F>
+    inline static void parse_seed(dict_t& dict, View seed, F on_factor) {
+        if(seed.empty()) return;
+        node_t node = dict.get_rootnode(seed[0]);
+        for(size_t i = 1; i < seed.size(); ++i) {
+            const uliteral_t c = seed[i];
+            node_t child = dict.find_or_insert(node, c);
+            if(child.is_new()) {
+                on_factor(node.id(), c);
+                node = dict.get_rootnode(c);
+            } else {
+                node = child;
+            }
+        }
+    }
 
-        size_t remaining_characters = n; // position in the text
-        dict_t dict(env().env_for_option("lz78trie"), n, remaining_characters, reserved_size+ULITERAL_MAX+1);
+    /// Factorizes the text read from `is` with a dictionary seeded by `seed`.
+    inline void factorize(std::istream& is, dict_t& dict, size_t& remaining_characters,
+                          View seed, Env&& coder_env, Output& out, Stats& stats) const {
         auto reset_dict = [&dict] () {
             dict.clear();
             std::stringstream ss;
@@ -62,7 +66,10 @@ public:
         };
         reset_dict();
 
-        typename coder_t::Encoder coder(env().env_for_option("coder"), out, NoLiterals());
+        parse_seed(dict, seed, [](lz78::factorid_t, uliteral_t){});
+        size_t factor_count = dict.size() - (ULITERAL_MAX + 1);
+
+        typename coder_t::Encoder coder(std::move(coder_env), out, NoLiterals());
 
         char c;
         if(!is.get(c)) return;
@@ -76,7 +83,7 @@ public:
 
             if(child.is_new()) {
                 coder.encode(node.id(), Range(factor_count + ULITERAL_MAX + 1));
-                IF_STATS(stat_factor_count++);
+                stats.factor_count++;
                 factor_count++;
                 DCHECK_EQ(factor_count+ULITERAL_MAX+1, dict.size());
                 node = dict.get_rootnode(static_cast<uliteral_t>(c));
@@ -85,8 +92,8 @@ public:
                     DCHECK_GT(dict.size(),0);
                     reset_dict();
                     factor_count = 0; //coder.dictionary_reset();
-                    IF_STATS(stat_dictionary_resets++);
-                    IF_STATS(stat_dict_counter_at_last_reset = m_dict_max_size);
+                    stats.dictionary_resets++;
+                    stats.dict_counter_at_last_reset = m_dict_max_size;
                 }
             } else { // traverse further
                 node = child;
@@ -97,28 +104,22 @@ public:
         // take care of left-overs. We do not assume that the stream has a sentinel
         DCHECK_NE(node.id(), lz78::undef_id);
         coder.encode(node.id(), Range(factor_count + ULITERAL_MAX + 1)); //LZW
-        IF_STATS(stat_factor_count++);
+        stats.factor_count++;
         factor_count++;
-
-        IF_STATS(
-        phase.log_stat("factor_count", stat_factor_count);
-        phase.log_stat("dictionary_reset_counter", stat_dictionary_resets);
-        phase.log_stat("max_factor_counter", stat_dict_counter_at_last_reset);
-        )
     }
 
-    virtual void decompress(Input& input, Output& output) override final {
-        const size_t reserved_size = input.size();
-        //TODO C::decode(in, out, dms, reserved_size);
-        auto out = output.as_stream();
-        typename coder_t::Decoder decoder(env().env_for_option("coder"), input);
+    /// Decodes the factors read from `input` with a dictionary
+    /// that contains the entries of `seed` after the root entries.
+    inline void defactorize(const lzw::Seed& seed, size_t reserved_size,
+                            Env&& coder_env, Input& input, std::ostream& out) const {
+        typename coder_t::Decoder decoder(std::move(coder_env), input);
 
-        size_t counter = 0;
+        size_t counter = seed.size();
 
         //TODO file_corrupted not used!
         lzw::decode_step([&](lz78::factorid_t& entry, bool reset, bool &file_corrupted) -> bool {
             if (reset) {
-                counter = 0;
+                counter = seed.size();
             }
 
             if(decoder.eof()) {
@@ -129,10 +130,142 @@ public:
             counter++;
             entry = factor;
             return true;
-        }, out, m_dict_max_size == 0 ? lz78::DMS_MAX : m_dict_max_size, reserved_size);
+        }, out, m_dict_max_size == 0 ? lz78::DMS_MAX : m_dict_max_size, reserved_size, seed);
+    }
+
+    inline void compress_parallel(Input& input, Output& out, Stats& stats) {
+        auto view = input.as_view();
+        const size_t n = view.size();
+        const auto bounds = lz78::partition(n, m_threads);
+        const View seed = view.substr(0, std::min(m_seed, bounds[1]));
+
+        // The dictionaries are created and destroyed by this thread,
+        // since they may log statistics.
+        std::vector<size_t> remaining_characters(m_threads);
+        std::vector<dict_t> dicts;
+        std::vector<Env> coder_envs;
+        dicts.reserve(m_threads);
+        for(size_t i = 0; i < m_threads; ++i) {
+            const size_t chunk_n = bounds[i+1] - bounds[i];
+            remaining_characters[i] = chunk_n;
+            dicts.emplace_back(env().env_for_option("lz78trie"), chunk_n,
+                               remaining_characters[i], isqrt(chunk_n)*2+ULITERAL_MAX+1);
+            coder_envs.push_back(env().env_for_option("coder"));
+        }
+
+        std::vector<std::vector<uint8_t>> chunks(m_threads);
+        std::vector<Stats> chunk_stats(m_threads);
+        parallel_for(m_threads, m_threads, [&](size_t i) {
+            io::ViewStream is(view.slice(bounds[i], bounds[i+1]));
+            Output chunk_out(chunks[i]);
+            factorize(is.stream(), dicts[i], remaining_characters[i],
+                      i == 0 ? View() : seed,
+                      std::move(coder_envs[i]), chunk_out, chunk_stats[i]);
+        });
+
+        for(const auto& s : chunk_stats) stats.factor_count += s.factor_count;
+        lz78::write_chunks(out, seed.size(), chunks);
+    }
+
+    inline void decompress_parallel(Input& input, std::ostream& out) {
+        auto view = input.as_view();
+        const lz78::Chunks chunks = lz78::read_chunks(view);
+        const size_t k = chunks.chunks.size();
+
+        std::vector<std::vector<uint8_t>> texts(k);
+        std::vector<Env> coder_envs;
+        for(size_t i = 0; i < k; ++i) {
+            coder_envs.push_back(env().env_for_option("coder"));
+        }
+
+        auto decode_chunk = [&](size_t i, const lzw::Seed& seed) {
+            Input chunk_in(chunks.chunks[i]);
+            Output chunk_out(texts[i]);
+            auto os = chunk_out.as_stream();
+            defactorize(seed, chunks.chunks[i].size(), std::move(coder_envs[i]), chunk_in, os);
+        };
+        if(k == 0) return;
+
+        // the seed is a prefix of the first chunk
+        decode_chunk(0, lzw::Seed());
+        CHECK_LE(chunks.seed_length, texts[0].size()) << "corrupted compressed file";
+
+        lzw::Seed seed;
+        {
+            size_t seed_remaining = chunks.seed_length;
+            dict_t dict(env().env_for_option("lz78trie"), chunks.seed_length, seed_remaining, ULITERAL_MAX+1);
+            for(size_t i = 0; i < ULITERAL_MAX+1; ++i) {
+                dict.add_rootnode(i);
+            }
+            parse_seed(dict, View(texts[0].data(), chunks.seed_length),
+                [&](lz78::factorid_t index, uliteral_t c) {
+                    seed.emplace_back(index, c);
+                });
+        }
+
+        parallel_for(k - 1, m_threads, [&](size_t i) {
+            decode_chunk(i + 1, seed);
+        });
+
+        for(const auto& text : texts) {
+            out.write((const char*) text.data(), text.size());
+        }
+    }
+
+public:
+    inline LZWCompressor(Env&& env):
+        Compressor(std::move(env)),
+        m_dict_max_size(this->env().option("dict_size").as_integer()),
+        m_threads(std::max<size_t>(this->env().option("threads").as_integer(), 1)),
+        m_seed(this->env().option("seed").as_integer())
+    {
+        CHECK(m_threads == 1 || m_dict_max_size == 0) << "dict_size is not supported with multiple threads";
+    }
+
+    inline static Meta meta() {
+        Meta m("compressor", "lzw", "Lempel-Ziv-Welch\n\n" LZ78_DICT_SIZE_DESC "\n\n" LZ78_THREADS_DESC);
+        m.option("coder").templated<coder_t, BitCoder>("coder");
+        m.option("lz78trie").templated<dict_t, lz78::TernaryTrie>("lz78trie");
+        m.option("dict_size").dynamic(0);
+        m.option("threads").dynamic(1);
+        m.option("seed").dynamic(0);
+        return m;
+    }
+
+    virtual void compress(Input& input, Output& out) override {
+        // Stats
+        StatPhase phase("LZW Compression");
+        Stats stats;
+
+        if(m_threads > 1) {
+            compress_parallel(input, out, stats);
+        } else {
+            const size_t n = input.size();
+            const size_t reserved_size = isqrt(n)*2;
+            auto is = input.as_stream();
+
+            size_t remaining_characters = n; // position in the text
+            dict_t dict(env().env_for_option("lz78trie"), n, remaining_characters, reserved_size+ULITERAL_MAX+1);
+            factorize(is, dict, remaining_characters, View(), env().env_for_option("coder"), out, stats);
+        }
+
+        IF_STATS(
+        phase.log_stat("factor_count", stats.factor_count);
+        phase.log_stat("dictionary_reset_counter", stats.dictionary_resets);
+        phase.log_stat("max_factor_counter", stats.dict_counter_at_last_reset);
+        )
+    }
+
+    virtual void decompress(Input& input, Output& output) override final {
+        auto out = output.as_stream();
+
+        if(m_threads > 1) {
+            decompress_parallel(input, out);
+        } else {
+            defactorize(lzw::Seed(), input.size(), env().env_for_option("coder"), input, out);
+        }
     }
 
 };
 
 }
-
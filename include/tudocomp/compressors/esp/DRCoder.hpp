@@ -14,6 +14,7 @@ namespace tdc {namespace esp {
         inline static Meta meta() {
             Meta m("d_coding", "huffman");
             //m.option("coder").templated<coder_t, HuffmanCoder>("coder");
+            m.option("max_length").dynamic(32); // longest codeword in bits
             return m;
         };
 
@@ -21,7 +22,7 @@ namespace tdc {namespace esp {
 
         template<typename rhs_t>
         inline void encode(const rhs_t& rhs, std::shared_ptr<BitOStream>& out, size_t bit_width, size_t max_value) const {
-            HuffmanEncoder encoder { out, rhs };
+            HuffmanEncoder encoder { out, rhs, size_t(env().option("max_length").as_integer()) };
 
             for (size_t i = 0; i < rhs.size(); i++) {
                 encoder.encode(rhs[i]);
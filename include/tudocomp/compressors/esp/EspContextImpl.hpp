@@ -33,10 +33,8 @@ namespace tdc {namespace esp {
                 IntVector<dynamic_t>(),
             });
             round->string.width(bits_for(256 - 1));
-            round->string.reserve(input.size(), bits_for(256 - 1));
-            for (auto c : input) {
-                round->string.push_back(c);
-            }
+            round->string.resize(input.size());
+            round->string.set_range(0, input.size(), input.data());
             auto discard = std::move(input);
         }
 
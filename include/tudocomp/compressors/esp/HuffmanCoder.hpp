@@ -6,6 +6,7 @@
 #include <numeric>
 
 #include <tudocomp/Coder.hpp>
+#include <tudocomp/util/huffman.hpp>
 
 namespace tdc {namespace esp {
     namespace huff2 {
@@ -15,7 +16,6 @@ namespace tdc {namespace esp {
         using Codewords = std::vector<size_t>;
         using Counts = std::vector<size_t>;
         using MapFromEffective = std::vector<size_t>;
-        using Codelengths = std::vector<size_t>;
         using Numl = std::vector<size_t>;
         using OrderedMapFromEffective = std::vector<size_t>;
         using Firstcode = std::vector<size_t>;
@@ -38,126 +38,6 @@ namespace tdc {namespace esp {
             return map_from_effective;
         }
 
-        inline static Codelengths gen_codelengths(Counts counts,
-                                           const MapFromEffective& map_from_effective,
-                                           size_t alphabet_size) {
-            std::vector<size_t> A;
-            A.reserve(alphabet_size * 2);
-            A.resize(alphabet_size * 2);
-
-            for(size_t i = 0; i < alphabet_size; i++) {
-                DVLOG(2)
-                    << "Char " << map_from_effective[i]
-                    << " : " << size_t(counts[map_from_effective[i]])
-                    << "\t";
-                A[alphabet_size + i] = counts[map_from_effective[i]];
-                A[i] = alphabet_size + i;
-            }
-
-            // build a minHeap of A[0..size)
-            auto comp = [&A] (const size_t a, const size_t b) -> bool {
-                return A[a] > A[b];
-            };
-            std::make_heap(&A[0], &A[alphabet_size], comp);
-            DCHECK_LE(A[A[0]], A[A[1]]);
-
-            DVLOG(2) << "A: " << vec_to_debug_string(A) << "\t";
-
-            size_t h = alphabet_size - 1;
-            //builds the Huffman tree
-
-            while(h > 0) {
-                std::pop_heap(A.begin(), A.begin() + h + 1, comp);
-                const size_t m1 = A[h];  // first element from the heap (already popped)
-                --h;
-
-                std::pop_heap(A.begin(), A.begin() + h + 1, comp);
-                const size_t m2 = A[h]; //second min count
-                DCHECK_GT(m1, h);
-                DCHECK_GT(m2, h);
-
-                A[h + 1] = A[m1] + A[m2]; // create a new parent node
-                A[h] = h + 1;
-                A[m1] = A[m2] = h + 1; //parent pointer
-                std::push_heap(A.begin(), A.begin() + h + 1, comp);
-            }
-
-            A[1] = 0;
-            for(size_t i = 2; i < 2 * alphabet_size; ++i) {
-                A[i] = A[A[i]]+ 1;
-            }
-
-            Codelengths codelengths;
-            codelengths.reserve(alphabet_size);
-            codelengths.resize(alphabet_size);
-            for (size_t i = 0; i < alphabet_size; i++) {
-                DCHECK_LE(A[alphabet_size + i], 64); // the latter representation allows only codewords of length at most 64 bits
-                codelengths[i] = A[alphabet_size+i];
-                DVLOG(2)
-                    << "Char " << map_from_effective[i]
-                    << " : " << codelengths[i]
-                    << "\t";
-            }
-
-            return codelengths;
-
-        }
-
-        inline static Numl gen_numl(const OrderedCodelengths& ordered_codelengths, const size_t alphabet_size, const uint8_t longest) {
-            DCHECK_EQ(longest, *std::max_element(ordered_codelengths.begin(),
-                                                 ordered_codelengths.end()));
-            DCHECK_GT(longest, 0);
-
-            // numl : length l -> #codewords of length l
-            Numl numl;
-            numl.reserve(longest);
-            numl.resize(longest);
-
-            for (size_t i = 0; i < alphabet_size; ++i) {
-                DCHECK_LE(ordered_codelengths[i], longest);
-                DCHECK_GT(ordered_codelengths[i], 0);
-                ++numl[ordered_codelengths[i] - 1];
-            }
-
-            return numl;
-        }
-
-        inline static Firstcode gen_first_codes(const Numl& numl, const size_t longest) {
-            Firstcode firstcode;
-            firstcode.reserve(longest);
-            firstcode.resize(longest);
-
-            firstcode[longest - 1] = 0;
-            for(size_t i = longest-1; i > 0; --i) {
-                firstcode[i - 1] = (firstcode[i] + numl[i]) / 2;
-            }
-            return firstcode;
-        }
-
-        inline static Codewords gen_codewords(const OrderedCodelengths& ordered_codelengths,
-                                const size_t alphabet_size,
-                                const Numl& numl,
-                                const uint8_t longest) {
-            DCHECK_EQ(longest, *std::max_element(ordered_codelengths.begin(),
-                                                 ordered_codelengths.end()));
-            DCHECK_GT(longest,0);
-
-            auto firstcode = gen_first_codes(numl, longest);
-
-            Codewords codewords;
-            codewords.reserve(alphabet_size);
-            codewords.resize(alphabet_size);
-            for(size_t i = 0; i < alphabet_size; ++i) {
-                DCHECK_LE(ordered_codelengths[i], longest);
-                DCHECK_GT(ordered_codelengths[i], 0);
-                codewords[i] = firstcode[ordered_codelengths[i]-1]++;
-                DVLOG(2) << "codeword " << i << " : " << std::bitset<64>(codewords[i])
-                    << ", length " << ordered_codelengths[i]
-                    << "\t";
-            }
-            return codewords;
-        }
-
         inline static OrderedMapToEffective gen_ordered_map_to_effective(
             const OrderedMapFromEffective& ordered_map_from_effective,
             const size_t alphabet_size,
@@ -198,54 +78,33 @@ namespace tdc {namespace esp {
             Codewords m_codewords;
             OrderedCodelengths m_ordered_codelengths;
 
-            inline void gen_huffmantable(Counts&& counts, size_t alphabet_size) {
+            inline void gen_huffmantable(Counts&& counts, size_t alphabet_size, size_t max_length) {
                 DCHECK_GT(alphabet_size, 0);
 
-                OrderedCodelengths ordered_codelengths;
-                OrderedMapFromEffective ordered_map_from_effective;
-                size_t longest;
-
-                {
-                    auto map_from_effective = gen_effective_alphabet(counts, alphabet_size);
-                    auto codelengths = gen_codelengths(std::move(counts),
-                                                    map_from_effective,
-                                                    alphabet_size);
-                    std::vector<size_t> codeword_order;
-                    codeword_order.reserve(alphabet_size);
-                    codeword_order.resize(alphabet_size);
-                    std::iota(codeword_order.begin(), codeword_order.end(), 0);
-                    std::sort(codeword_order.begin(), codeword_order.end(),
-                              [&] (size_t i, size_t j) -> bool {
-                                  return codelengths[i] < codelengths[j];
-                              });
-                    longest = *std::max_element(codelengths.begin(),
-                                                codelengths.end());
-
-                    ordered_codelengths.reserve(alphabet_size);
-                    ordered_codelengths.resize(alphabet_size);
-
-                    ordered_map_from_effective.reserve(alphabet_size);
-                    ordered_map_from_effective.resize(alphabet_size);
-
-                    for(size_t i = 0; i < alphabet_size; ++i) {
-                        ordered_codelengths[i] = codelengths[codeword_order[i]];
-                        ordered_map_from_effective[i] = map_from_effective[codeword_order[i]];
-                    }
+                auto map_from_effective = gen_effective_alphabet(counts, alphabet_size);
+                std::vector<size_t> weights(alphabet_size);
+                for(size_t i = 0; i < alphabet_size; ++i) {
+                    weights[i] = counts[map_from_effective[i]];
                 }
 
-                auto numl = gen_numl(ordered_codelengths, alphabet_size, longest);
-                auto codewords = gen_codewords(ordered_codelengths, alphabet_size, numl, longest);
+                max_length = std::min<size_t>(huff::MAX_CODELENGTH,
+                    std::max<size_t>(max_length, bits_for(alphabet_size - 1)));
+                huff::CanonicalCode code = huff::gen_canonical_code(weights, max_length);
 
-                m_ordered_map_from_effective = std::move(ordered_map_from_effective);
-                m_codewords = std::move(codewords);
-                m_ordered_codelengths = std::move(ordered_codelengths);
-                m_effective_alphabet_size = std::move(alphabet_size);
-                m_numl = std::move(numl);
-                m_longest = std::move(longest);
+                m_ordered_map_from_effective.resize(alphabet_size);
+                m_ordered_codelengths.resize(alphabet_size);
+                for(size_t i = 0; i < alphabet_size; ++i) {
+                    m_ordered_map_from_effective[i] = map_from_effective[code.order[i]];
+                    m_ordered_codelengths[i] = code.ordered_codelengths[i];
+                }
+                m_codewords = std::move(code.codewords);
+                m_effective_alphabet_size = alphabet_size;
+                m_numl = std::move(code.numl);
+                m_longest = code.longest;
             }
 
             template<typename input_t>
-            ExtendedHuffmantable(const input_t& inp) {
+            ExtendedHuffmantable(const input_t& inp, size_t max_length) {
                 size_t max = 0;
                 for (size_t i = 0; i < inp.size(); i++) {
                     max = std::max(max, inp[i]);
@@ -269,7 +128,7 @@ namespace tdc {namespace esp {
                 if (shrunk_alphabet_size <= 1) {
                     m_effective_alphabet_size = shrunk_alphabet_size;
                 } else {
-                    gen_huffmantable(std::move(counts), shrunk_alphabet_size);
+                    gen_huffmantable(std::move(counts), shrunk_alphabet_size, max_length);
                 }
             }
         };
@@ -415,9 +274,10 @@ namespace tdc {namespace esp {
     public:
         template<typename input_t>
         HuffmanEncoder(const std::shared_ptr<BitOStream>& out,
-                       const input_t& literals):
+                       const input_t& literals,
+                       size_t max_length = huff::DEFAULT_MAX_CODELENGTH):
             m_out(out),
-            m_table(literals),
+            m_table(literals, max_length),
             m_ordered_map_to_effective {
                 m_table.m_codewords.empty()
                     ? OrderedMapToEffective()
@@ -467,7 +327,7 @@ namespace tdc {namespace esp {
                 std::move(ordered_codelengths),
                 table.m_effective_alphabet_size,
                 table.m_longest);
-            m_firstcodes = gen_first_codes(table.m_numl, table.m_longest);
+            m_firstcodes = huff::gen_first_codes(table.m_numl);
         }
 
         inline size_t decode() {
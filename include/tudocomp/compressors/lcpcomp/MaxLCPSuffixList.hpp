@@ -2,6 +2,7 @@
 
 #include <tudocomp/util.hpp>
 #include <tudocomp/ds/IntVector.hpp>
+#include <tudocomp/ds/StaticWidthView.hpp>
 
 namespace tdc {
 namespace lcpcomp {
@@ -11,7 +12,10 @@ namespace lcpcomp {
 ///
 /// Addition and removal are achieved in near-constant time.
 /// (Dinklage, 2015).
-template<class lcp_t>
+///
+/// If `W` is nonzero, it must equal `bits_for(lcp.size())` and the linked
+/// list and LCP index are accessed with that static width.
+template<class lcp_t, size_t W = 0>
 class MaxLCPSuffixList {
 
 private:
@@ -36,14 +40,36 @@ private:
     //Entry counter
     size_t m_size = 0;
 
+    /// Access to one of the integer vectors, with a static width if given.
+    template<size_t X = W>
+    inline static std::enable_if_t<X == 0, DynamicIntVector&> view(DynamicIntVector& v) {
+        return v;
+    }
+
+    template<size_t X = W>
+    inline static std::enable_if_t<X == 0, const DynamicIntVector&> view(const DynamicIntVector& v) {
+        return v;
+    }
+
+    template<size_t X = W>
+    inline static std::enable_if_t<X != 0, StaticWidthView<X>> view(DynamicIntVector& v) {
+        return static_width_view<X>(v);
+    }
+
+    template<size_t X = W>
+    inline static std::enable_if_t<X != 0, ConstStaticWidthView<X>> view(const DynamicIntVector& v) {
+        return static_width_view<X>(v);
+    }
+
     /// Lookup the LCP index.
     inline size_t lookup_lcp_index(size_t lcp) const {
         //DLOG(INFO) << "lookup_lcp_index(" << lcp << ")";
         DCHECK_LE(lcp, m_lcp_index.size());
 
+        auto&& lcp_index = view(m_lcp_index);
         size_t result = m_undef;
         while(lcp > 0 && result == m_undef) {
-            result = m_lcp_index[--lcp];
+            result = lcp_index[--lcp];
         }
 
         return result;
@@ -55,6 +81,7 @@ public:
         : m_lcp(&lcp), m_undef(m_lcp->size())
 	{
         const size_t& n = lcp.size();
+        DCHECK(W == 0 || W == bits_for(m_undef));
 
         //Initialize doubly linked list
         m_first = m_undef;
@@ -80,37 +107,40 @@ private:
     inline void insert(size_t i) {
         DCHECK(i < m_undef && !m_suffix_contained[i]);
 
+        auto&& prev_of = view(m_prev);
+        auto&& next_of = view(m_next);
+
         size_t lcp = (*m_lcp)[i];
         size_t pos = lookup_lcp_index(lcp);
         if(pos == m_undef) {
             //insert at end
             if(m_last != m_undef) {
-                m_next[m_last] = i;
+                next_of[m_last] = i;
             }
 
-            m_next[i] = m_undef;
-            m_prev[i] = m_last;
+            next_of[i] = m_undef;
+            prev_of[i] = m_last;
 
             m_last = i;
         } else {
             //insert at position
-            size_t prev = m_prev[pos];
+            size_t prev = prev_of[pos];
 
-            m_prev[i] = prev;
-            m_next[i] = pos;
+            prev_of[i] = prev;
+            next_of[i] = pos;
 
             if(prev != m_undef) {
-                m_next[prev] = i;
+                next_of[prev] = i;
             } else {
                 DCHECK(pos == m_first);
                 m_first = i;
             }
 
-            m_prev[pos] = i;
+            prev_of[pos] = i;
         }
 
         //update lcp index
-        m_lcp_index[lcp-1] = i;
+        view(m_lcp_index)[lcp-1] = i;
 
         //update first
         if(m_first == m_undef) {
@@ -127,29 +157,33 @@ public:
     inline void remove(size_t i) {
         DCHECK(i < m_undef && m_suffix_contained[i]);
 
+        auto&& prev_of = view(m_prev);
+        auto&& next_of = view(m_next);
+        auto&& lcp_index = view(m_lcp_index);
+
         //unlink
-        if(m_prev[i] != m_undef) {
-            m_next[m_prev[i]] = m_next[i];
+        if(prev_of[i] != m_undef) {
+            next_of[prev_of[i]] = next_of[i];
         } else {
             DCHECK(i == m_first);
-            m_first = m_next[i];
+            m_first = next_of[i];
         }
 
-        if(m_next[i] != m_undef) {
-            m_prev[m_next[i]] = m_prev[i];
+        if(next_of[i] != m_undef) {
+            prev_of[next_of[i]] = prev_of[i];
         } else {
             DCHECK(i == m_last);
-            m_last = m_prev[i];
+            m_last = prev_of[i];
         }
 
         //update LCP index
         size_t lcp = (*m_lcp)[i];
-        if(m_lcp_index[lcp-1] == i) {
-            size_t k = m_next[i];
+        if(lcp_index[lcp-1] == i) {
+            size_t k = next_of[i];
             if (k != m_undef && (*m_lcp)[k] == lcp) {
-                m_lcp_index[lcp-1] = k; //move to next entry with same LCP
+                lcp_index[lcp-1] = k; //move to next entry with same LCP
             } else {
-                m_lcp_index[lcp-1] = m_undef; //invalidate
+                lcp_index[lcp-1] = m_undef; //invalidate
             }
         }
 
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <type_traits>
+
+#include <tudocomp/util.hpp>
+#include <tudocomp/ds/IntVector.hpp>
+
+namespace tdc {
+namespace lcpcomp {
+
+/// A writable LCP array decoded from a read-only LCP data structure.
+class DecodedLCP : public DynamicIntVector {
+private:
+    len_t m_max;
+
+public:
+    inline DecodedLCP(DynamicIntVector&& lcp, len_t max)
+        : DynamicIntVector(std::move(lcp)), m_max(max) {
+    }
+
+    inline len_t max_lcp() const {
+        return m_max;
+    }
+};
+
+/// \cond INTERNAL
+template<typename text_t>
+inline typename text_t::lcp_type release_writable_lcp(
+    text_t& text, std::true_type) {
+
+    return text.release_lcp();
+}
+
+template<typename text_t>
+inline DecodedLCP release_writable_lcp(text_t& text, std::false_type) {
+    auto lcp = text.release_lcp();
+    const len_t max = lcp.max_lcp();
+    return DecodedLCP(lcp.relinquish(), max);
+}
+/// \endcond
+
+/// \brief Releases the LCP array from a text data structure provider so
+///        that it can be modified.
+///
+/// The factorization strategies decrease LCP entries in place. An LCP data
+/// structure that stores its array directly is released as is. Any other,
+/// e.g., \ref DACLCP, is decoded into a bit-compressed array, which is
+/// still an instance of the data type the heaps are instantiated with.
+///
+/// \param text the text data structure provider.
+/// \return the writable LCP array, providing `max_lcp()`.
+template<typename text_t>
+inline auto release_writable_lcp(text_t& text) {
+    return release_writable_lcp(text, std::is_base_of<
+        typename text_t::lcp_type::data_type, typename text_t::lcp_type>());
+}
+
+}} //ns
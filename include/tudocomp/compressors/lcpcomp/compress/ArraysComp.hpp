@@ -2,9 +2,11 @@
 
 #include <tudocomp/Algorithm.hpp>
 #include <tudocomp/ds/TextDS.hpp>
+#include <tudocomp/ds/SparseISA.hpp>
 #include <tudocomp/def.hpp>
 
 #include <tudocomp/compressors/lzss/LZSSFactors.hpp>
+#include <tudocomp/compressors/lcpcomp/WritableLCP.hpp>
 #include <tudocomp/compressors/lcpcomp/MaxLCPSuffixList.hpp>
 
 #include <tudocomp_stat/StatPhase.hpp>
@@ -39,7 +41,7 @@ public:
         auto lcp = StatPhase::wrap("Construct Index Data Structures", [&] {
             text.require(text_t::SA | text_t::ISA | text_t::LCP);
 
-            auto lcp = text.release_lcp();
+            auto lcp = release_writable_lcp(text);
             StatPhase::log("maxlcp", lcp.max_lcp());
             return lcp;
         });
@@ -69,6 +71,8 @@ public:
             StatPhase phase(std::string{"Factors at max. LCP value "}
                 + std::to_string(lcp.max_lcp()));
 
+            std::vector<len_t> ranks; // ISA entries around a factor
+
             for(size_t maxlcp = lcp.max_lcp(); maxlcp >= threshold; --maxlcp) {
                 IF_STATS({
                     const len_t maxlcpbits = bits_for(maxlcp-threshold);
@@ -95,16 +99,21 @@ public:
 
                     factors.emplace_back(pos_target, pos_source, factor_length);
 
+                    const len_t max_affect = std::min(factor_length, pos_target); //if pos_target is at the very beginning, we have less to scan
+
+                    // look up the ISA entries of [pos_target - max_affect, pos_target + factor_length) in one batch
+                    ranks.resize(max_affect + factor_length);
+                    isa_lookup_range(isa, pos_target - max_affect, max_affect + factor_length, ranks.data());
+
                     //erase suffixes on the replaced area
                     for(size_t k = 0; k < factor_length; ++k) {
-                        lcp[isa[pos_target + k]] = 0;
+                        lcp[ranks[max_affect + k]] = 0;
                     }
 
-                    const len_t max_affect = std::min(factor_length, pos_target); //if pos_target is at the very beginning, we have less to scan
                     //correct intersecting entries
                     for(len_t k = 0; k < max_affect; ++k) {
                         const len_t pos_suffix = pos_target - k - 1; DCHECK_GE(pos_target,k+1);
-                        const len_t ind_suffix = isa[pos_suffix];
+                        const len_t ind_suffix = ranks[max_affect - k - 1];
                         lcp[ind_suffix] = std::min<len_t>(k+1, lcp[ind_suffix]);
                     }
 
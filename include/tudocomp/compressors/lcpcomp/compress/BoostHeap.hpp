@@ -2,9 +2,11 @@
 
 #include <tudocomp/Algorithm.hpp>
 #include <tudocomp/ds/TextDS.hpp>
+#include <tudocomp/ds/SparseISA.hpp>
 #include <tudocomp/ds/ArrayMaxHeap.hpp>
 
 #include <tudocomp/compressors/lzss/LZSSFactors.hpp>
+#include <tudocomp/compressors/lcpcomp/WritableLCP.hpp>
 #include <boost/heap/pairing_heap.hpp>
 
 #include <tudocomp_stat/StatPhase.hpp>
@@ -46,7 +48,7 @@ public:
         auto& isa = text.require_isa();
 
         text.require_lcp();
-        auto lcp = text.release_lcp();
+        auto lcp = release_writable_lcp(text);
 
 		struct LCPCompare {
 			using lcp_t = decltype(lcp);
@@ -78,6 +80,8 @@ public:
         //Factorize
         phase.split("Process MaxLCPHeap");
 
+        std::vector<len_t> ranks; // ISA entries around a factor
+
         while(heap.size() > 0) {
             //get suffix with longest LCP
             const len_compact_t& m = heap.top();
@@ -89,18 +93,24 @@ public:
 
             factors.emplace_back(fpos, fsrc, flen);
 
+            // look up the ISA entries of [fpos - a, fpos + flen)
+            // in one batch
+            const len_t a = std::min(flen, fpos);
+            ranks.resize(a + flen);
+            isa_lookup_range(isa, fpos - a, a + flen, ranks.data());
+
             //remove overlapped entries
             for(size_t k = 0; k < flen; k++) {
-                const len_t pos = isa[fpos + k];
+                const len_t pos = ranks[a + k];
 			    if(handles[pos].node_ == nullptr) continue;
                 heap.erase(handles[pos]);
 			    handles[pos].node_ = nullptr;
             }
 
             //correct intersecting entries
-            for(size_t k = 0; k < flen && fpos > k; k++) {
+            for(size_t k = 0; k < a; k++) {
                 size_t s = fpos - k - 1;
-                size_t i = isa[s];
+                size_t i = ranks[a - k - 1];
 			    if(handles[i].node_ != nullptr) {
                     if(s + lcp[i] > fpos) {
                         size_t l = fpos - s;
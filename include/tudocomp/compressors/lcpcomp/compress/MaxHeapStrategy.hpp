@@ -2,9 +2,12 @@
 
 #include <tudocomp/Algorithm.hpp>
 #include <tudocomp/ds/TextDS.hpp>
+#include <tudocomp/ds/SparseISA.hpp>
 #include <tudocomp/ds/ArrayMaxHeap.hpp>
+#include <tudocomp/ds/BucketQueue.hpp>
 
 #include <tudocomp/compressors/lzss/LZSSFactors.hpp>
+#include <tudocomp/compressors/lcpcomp/WritableLCP.hpp>
 
 #include <tudocomp_stat/StatPhase.hpp>
 
@@ -19,10 +22,14 @@ namespace lcpcomp {
 ///
 /// This was the original naive approach in "Textkompression mithilfe von
 /// Enhanced Suffix Arrays" (BA thesis, Patrick Dinklage, 2015).
+///
+/// With the option `bucket`, a \ref BucketQueue is used instead of the
+/// heap, which applies decrease-key operations lazily.
 class MaxHeapStrategy : public Algorithm {
 public:
     inline static Meta meta() {
         Meta m("lcpcomp_comp", "heap");
+        m.option("bucket").dynamic(false);
         return m;
     }
 
@@ -44,60 +51,96 @@ public:
 
         auto& sa = text.require_sa();
         auto& isa = text.require_isa();
-        auto lcp = text.release_lcp();
+        auto lcp = release_writable_lcp(text);
 
-        auto heap = StatPhase::wrap("Construct MaxLCPHeap", [&]{
-            // Count relevant LCP entries
-            size_t heap_size = 0;
-            for(size_t i = 1; i < lcp.size(); i++) {
-                if(lcp[i] >= threshold) ++heap_size;
-            }
+        if(env().option("bucket").as_bool()) {
+            if(lcp.max_lcp() < threshold) return; // nothing to factorize
 
-            // Construct heap
-            ArrayMaxHeap<typename text_t::lcp_type::data_type> heap(lcp, lcp.size(), heap_size);
-            for(size_t i = 1; i < lcp.size(); i++) {
-                if(lcp[i] >= threshold) heap.insert(i);
-            }
+            auto queue = StatPhase::wrap("Construct BucketQueue", [&]{
+                BucketQueue<typename text_t::lcp_type::data_type> queue(
+                    lcp, lcp.size(), threshold, lcp.max_lcp());
+                for(size_t i = 1; i < lcp.size(); i++) {
+                    if(lcp[i] >= threshold) queue.insert(i);
+                }
 
-            StatPhase::log("entries", heap.size());
-            return heap;
-        });
+                StatPhase::log("entries", queue.size());
+                return queue;
+            });
+
+            StatPhase::wrap("Process BucketQueue", [&]{
+                process(queue, sa, isa, lcp, threshold, factors);
+            });
+        } else {
+            auto heap = StatPhase::wrap("Construct MaxLCPHeap", [&]{
+                // Count relevant LCP entries
+                size_t heap_size = 0;
+                for(size_t i = 1; i < lcp.size(); i++) {
+                    if(lcp[i] >= threshold) ++heap_size;
+                }
 
-        //Factorize
-        StatPhase::wrap("Process MaxLCPHeap", [&]{
-            while(heap.size() > 0) {
-                //get suffix with longest LCP
-                size_t m = heap.get_max();
+                // Construct heap
+                ArrayMaxHeap<typename text_t::lcp_type::data_type> heap(lcp, lcp.size(), heap_size);
+                for(size_t i = 1; i < lcp.size(); i++) {
+                    if(lcp[i] >= threshold) heap.insert(i);
+                }
 
-                //generate factor
-                size_t fpos = sa[m];
-                size_t fsrc = sa[m-1];
-                size_t flen = lcp[m];
+                StatPhase::log("entries", heap.size());
+                return heap;
+            });
 
-                factors.emplace_back(fpos, fsrc, flen);
+            //Factorize
+            StatPhase::wrap("Process MaxLCPHeap", [&]{
+                process(heap, sa, isa, lcp, threshold, factors);
+            });
+        }
+    }
 
-                //remove overlapped entries
-                for(size_t k = 0; k < flen; k++) {
-                    heap.remove(isa[fpos + k]);
-                }
+private:
+    template<typename heap_t, typename sa_t, typename isa_t, typename lcp_t>
+    inline static void process(heap_t& heap, const sa_t& sa, const isa_t& isa,
+                               lcp_t& lcp, const size_t threshold,
+                               lzss::FactorBuffer& factors) {
 
-                //correct intersecting entries
-                for(size_t k = 0; k < flen && fpos > k; k++) {
-                    size_t s = fpos - k - 1;
-                    size_t i = isa[s];
-                    if(heap.contains(i)) {
-                        if(s + lcp[i] > fpos) {
-                            size_t l = fpos - s;
-                            if(l >= threshold) {
-                                heap.decrease_key(i, l);
-                            } else {
-                                heap.remove(i);
-                            }
+        std::vector<size_t> ranks; // ISA entries around a factor
+
+        while(heap.size() > 0) {
+            //get suffix with longest LCP
+            size_t m = heap.get_max();
+
+            //generate factor
+            size_t fpos = sa[m];
+            size_t fsrc = sa[m-1];
+            size_t flen = lcp[m];
+
+            factors.emplace_back(fpos, fsrc, flen);
+
+            // look up the ISA entries of [fpos - a, fpos + flen)
+            // in one batch
+            const size_t a = std::min(flen, fpos);
+            ranks.resize(a + flen);
+            isa_lookup_range(isa, fpos - a, a + flen, ranks.data());
+
+            //remove overlapped entries
+            for(size_t k = 0; k < flen; k++) {
+                heap.remove(ranks[a + k]);
+            }
+
+            //correct intersecting entries
+            for(size_t k = 0; k < a; k++) {
+                size_t s = fpos - k - 1;
+                size_t i = ranks[a - k - 1];
+                if(heap.contains(i)) {
+                    if(s + lcp[i] > fpos) {
+                        size_t l = fpos - s;
+                        if(l >= threshold) {
+                            heap.decrease_key(i, l);
+                        } else {
+                            heap.remove(i);
                         }
                     }
                 }
             }
-        });
+        }
     }
 };
 
@@ -2,8 +2,12 @@
 
 #include <tudocomp/Algorithm.hpp>
 #include <tudocomp/ds/TextDS.hpp>
+#include <tudocomp/ds/SparseISA.hpp>
+#include <tudocomp/ds/StaticWidthView.hpp>
+#include <tudocomp/ds/BucketQueue.hpp>
 
 #include <tudocomp/compressors/lzss/LZSSFactors.hpp>
+#include <tudocomp/compressors/lcpcomp/WritableLCP.hpp>
 #include <tudocomp/compressors/lcpcomp/MaxLCPSuffixList.hpp>
 
 #include <tudocomp_stat/StatPhase.hpp>
@@ -19,10 +23,15 @@ namespace lcpcomp {
 ///
 /// This was the original naive approach in "Textkompression mithilfe von
 /// Enhanced Suffix Arrays" (BA thesis, Patrick Dinklage, 2015).
+///
+/// With the option `bucket`, a \ref BucketQueue is used instead of the
+/// list, which keeps one bucket per LCP value instead of a doubly linked
+/// list and applies decrease-key operations lazily.
 class MaxLCPStrategy : public Algorithm {
 public:
     inline static Meta meta() {
         Meta m("lcpcomp_comp", "max_lcp");
+        m.option("bucket").dynamic(false);
         return m;
     }
 
@@ -46,56 +55,99 @@ public:
         auto& isa = text.require_isa();
 
         text.require_lcp();
-        auto lcp = text.release_lcp();
+        auto lcp = release_writable_lcp(text);
+
+        if(env().option("bucket").as_bool()) {
+            if(lcp.max_lcp() < threshold) return; // nothing to factorize
 
-        auto list = StatPhase::wrap("Construct MaxLCPSuffixList", [&]{
-            MaxLCPSuffixList<typename text_t::lcp_type::data_type> list(
-                lcp, threshold, lcp.max_lcp());
+            auto queue = StatPhase::wrap("Construct BucketQueue", [&]{
+                BucketQueue<typename text_t::lcp_type::data_type> queue(
+                    lcp, lcp.size(), threshold, lcp.max_lcp());
+                for(size_t i = 1; i < lcp.size(); i++) {
+                    if(lcp[i] >= threshold) queue.insert(i);
+                }
 
-            StatPhase::log("entries", list.size());
-            return list;
+                StatPhase::log("entries", queue.size());
+                return queue;
+            });
+
+            StatPhase::wrap("Process BucketQueue", [&]{
+                process(queue, sa, isa, lcp, threshold, factors);
+                StatPhase::log("num_factors", factors.size());
+            });
+            return;
+        }
+
+        // the list's arrays have the width of the text positions,
+        // instantiate the factorization for it
+        with_static_width(bits_for(lcp.size()), [&](auto w) {
+            using list_t = MaxLCPSuffixList<
+                typename text_t::lcp_type::data_type, decltype(w)::value>;
+
+            auto list = StatPhase::wrap("Construct MaxLCPSuffixList", [&]{
+                list_t list(lcp, threshold, lcp.max_lcp());
+
+                StatPhase::log("entries", list.size());
+                return list;
+            });
+
+            //Factorize
+            StatPhase::wrap("Process MaxLCPSuffixList", [&]{
+                process(list, sa, isa, lcp, threshold, factors);
+                StatPhase::log("num_factors", factors.size());
+            });
         });
+    }
 
-        //Factorize
-        StatPhase::wrap("Process MaxLCPSuffixList", [&]{
-            while(list.size() > 0) {
-                //get suffix with longest LCP
-                size_t m = list.get_max();
+private:
+    template<typename list_t, typename sa_t, typename isa_t, typename lcp_t>
+    inline static void process(list_t& list, const sa_t& sa, const isa_t& isa,
+                               lcp_t& lcp, const size_t threshold,
+                               lzss::FactorBuffer& factors) {
 
-                //generate factor
-                size_t fpos = sa[m];
-                size_t fsrc = sa[m-1];
-                size_t flen = lcp[m];
+        std::vector<size_t> ranks; // ISA entries around a factor
 
-                factors.emplace_back(fpos, fsrc, flen);
+        while(list.size() > 0) {
+            //get suffix with longest LCP
+            size_t m = list.get_max();
 
-                //remove overlapped entries
-                for(size_t k = 0; k < flen; k++) {
-                    size_t i = isa[fpos + k];
-                    if(list.contains(i)) {
-                        list.remove(i);
-                    }
+            //generate factor
+            size_t fpos = sa[m];
+            size_t fsrc = sa[m-1];
+            size_t flen = lcp[m];
+
+            factors.emplace_back(fpos, fsrc, flen);
+
+            // look up the ISA entries of [fpos - a, fpos + flen)
+            // in one batch
+            const size_t a = std::min(flen, fpos);
+            ranks.resize(a + flen);
+            isa_lookup_range(isa, fpos - a, a + flen, ranks.data());
+
+            //remove overlapped entries
+            for(size_t k = 0; k < flen; k++) {
+                size_t i = ranks[a + k];
+                if(list.contains(i)) {
+                    list.remove(i);
                 }
+            }
 
-                //correct intersecting entries
-                for(size_t k = 0; k < flen && fpos > k; k++) {
-                    size_t s = fpos - k - 1;
-                    size_t i = isa[s];
-                    if(list.contains(i)) {
-                        if(s + lcp[i] > fpos) {
-                            size_t l = fpos - s;
-                            if(l >= threshold) {
-                                list.decrease_key(i, l);
-                            } else {
-                                list.remove(i);
-                            }
+            //correct intersecting entries
+            for(size_t k = 0; k < a; k++) {
+                size_t s = fpos - k - 1;
+                size_t i = ranks[a - k - 1];
+                if(list.contains(i)) {
+                    if(s + lcp[i] > fpos) {
+                        size_t l = fpos - s;
+                        if(l >= threshold) {
+                            list.decrease_key(i, l);
+                        } else {
+                            list.remove(i);
                         }
                     }
                 }
             }
-
-            StatPhase::log("num_factors", factors.size());
-        });
+        }
     }
 };
 
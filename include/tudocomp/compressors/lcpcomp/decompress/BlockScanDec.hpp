@@ -0,0 +1,306 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+#include <tudocomp/def.hpp>
+#include <tudocomp/ds/IntVector.hpp>
+#include <tudocomp/Algorithm.hpp>
+#include <tudocomp/util/parallel_for.hpp>
+
+#include <tudocomp_stat/StatPhase.hpp>
+
+namespace tdc {
+namespace lcpcomp {
+
+/**
+ * Decodes like \ref ScanDec, but resolves the pending factors block-wise.
+ *
+ * The text is divided into blocks of "block_size" characters.
+ * Factors whose source is not yet decoded are split at the block borders
+ * of their source and kept in one contiguous array,
+ * grouped by the block of their source.
+ * A scan resolves the groups from left to right such that all reads
+ * of a group stay within one block of the text.
+ *
+ * With "threads" larger than 1, the scans are done in parallel.
+ * A parallel scan first collects, for all groups in parallel, the runs of
+ * characters whose source is already decoded, and then copies these runs
+ * in parallel. Hence the i-th scan decodes all characters whose chain of
+ * references to a literal has length i, so the scans process the levels
+ * of the dependency graph of the factors one after another.
+ * As all copies of a scan have disjoint targets and only read characters
+ * decoded before, they are independent of each other.
+ *
+ * The characters still missing after the scans are decoded by following
+ * their chains of references with an explicit stack. The source of a
+ * position is looked up in the pending factors sorted by target position,
+ * so no buckets per text position are needed.
+ */
+class BlockScanDec : public Algorithm {
+public:
+    inline static Meta meta() {
+        Meta m("lcpcomp_dec", "block_scan");
+        m.option("scans").dynamic(6);
+        m.option("block_size").dynamic(1 << 18);
+        m.option("threads").dynamic(1);
+        return m;
+    }
+
+private:
+    struct Factor {
+        len_compact_t target;
+        len_compact_t source;
+        len_compact_t length;
+    };
+
+    const size_t m_scans; // number of scan rounds
+    const len_t m_block_size;
+    const size_t m_threads;
+
+    len_t m_cursor;
+
+    IntVector<uliteral_t> m_buffer;
+
+    // pending factors, grouped by the block of their source
+    // after the first scan: group b is [m_group_begin[b], m_group_end[b])
+    std::vector<Factor> m_factors;
+    std::vector<size_t> m_group_begin;
+    std::vector<size_t> m_group_end;
+
+    IF_STATS(len_t m_longest_chain = 0);
+
+    inline bool is_decoded(len_t pos) const {
+        return m_buffer[pos] != 0;
+    }
+
+    inline void group_factors() {
+        const size_t blocks = (m_buffer.size() + m_block_size - 1) / m_block_size;
+
+        // splits a factor at the block borders of its source
+        auto for_each_piece = [&](Factor f, auto g) {
+            while(f.length > 0) {
+                const len_t block = f.source / m_block_size;
+                const len_t piece = std::min<len_t>(f.length,
+                    (block + 1) * m_block_size - f.source);
+                g(block, Factor { f.target, f.source, len_compact_t(piece) });
+                f.target += piece;
+                f.source += piece;
+                f.length -= piece;
+            }
+        };
+
+        m_group_begin.assign(blocks + 1, 0);
+        for(const Factor& f : m_factors) {
+            for_each_piece(f, [&](len_t block, const Factor&) {
+                ++m_group_begin[block + 1];
+            });
+        }
+        for(size_t b = 0; b < blocks; ++b) {
+            m_group_begin[b + 1] += m_group_begin[b];
+        }
+
+        m_group_end.assign(m_group_begin.begin(), m_group_begin.end() - 1);
+        std::vector<Factor> grouped(m_group_begin.back());
+        for(const Factor& f : m_factors) {
+            for_each_piece(f, [&](len_t block, const Factor& piece) {
+                grouped[m_group_end[block]++] = piece;
+            });
+        }
+        m_group_begin.pop_back();
+        m_factors.swap(grouped);
+    }
+
+    // copies all decoded characters of the pending factors
+    // and shrinks each factor to the range of its missing characters
+    inline void scan() {
+        for(size_t b = 0; b < m_group_begin.size(); ++b) {
+            size_t kept = m_group_begin[b];
+            for(size_t j = m_group_begin[b]; j < m_group_end[b]; ++j) {
+                const Factor f = m_factors[j];
+                len_t first = f.length;
+                len_t last = 0;
+                for(len_t i = 0; i < f.length; ++i) {
+                    const uliteral_t c = m_buffer[f.source + i];
+                    if(c) {
+                        m_buffer[f.target + i] = c;
+                    } else {
+                        first = std::min(first, i);
+                        last = i + 1;
+                    }
+                }
+                if(first < last) {
+                    m_factors[kept++] = Factor {
+                        len_compact_t(f.target + first),
+                        len_compact_t(f.source + first),
+                        len_compact_t(last - first) };
+                }
+            }
+            m_group_end[b] = kept;
+        }
+    }
+
+    // like scan, but determines the runs of decodable characters of all
+    // groups before copying them, such that both steps can run in parallel
+    inline void scan_parallel(std::vector<std::vector<Factor>>& copies) {
+        parallel_for(m_group_begin.size(), m_threads, [&](size_t b) {
+            std::vector<Factor>& runs = copies[b];
+            runs.clear();
+
+            size_t kept = m_group_begin[b];
+            for(size_t j = m_group_begin[b]; j < m_group_end[b]; ++j) {
+                const Factor f = m_factors[j];
+                len_t first = f.length;
+                len_t last = 0;
+                len_t run = 0; // start of the current run of decodable characters
+                for(len_t i = 0; i <= f.length; ++i) {
+                    // a character is decodable if its source is decoded, but
+                    // not itself: a decoded target may be a source of another
+                    // copy in this scan
+                    if(i < f.length
+                        && !m_buffer[f.target + i] && m_buffer[f.source + i]) {
+                        continue;
+                    }
+                    if(run < i) {
+                        runs.push_back(Factor {
+                            len_compact_t(f.target + run),
+                            len_compact_t(f.source + run),
+                            len_compact_t(i - run) });
+                    }
+                    run = i + 1;
+                    if(i < f.length && !m_buffer[f.target + i]) {
+                        first = std::min(first, i);
+                        last = i + 1;
+                    }
+                }
+                if(first < last) {
+                    m_factors[kept++] = Factor {
+                        len_compact_t(f.target + first),
+                        len_compact_t(f.source + first),
+                        len_compact_t(last - first) };
+                }
+            }
+            m_group_end[b] = kept;
+        });
+
+        parallel_for(m_group_begin.size(), m_threads, [&](size_t b) {
+            for(const Factor& f : copies[b]) {
+                for(len_t i = 0; i < f.length; ++i) {
+                    m_buffer[f.target + i] = m_buffer[f.source + i];
+                }
+            }
+        });
+    }
+
+    // moves the groups to the front and sorts the factors by target position
+    inline void ungroup_factors() {
+        if(!m_group_begin.empty()) {
+            size_t kept = 0;
+            for(size_t b = 0; b < m_group_begin.size(); ++b) {
+                for(size_t j = m_group_begin[b]; j < m_group_end[b]; ++j) {
+                    m_factors[kept++] = m_factors[j];
+                }
+            }
+            m_factors.resize(kept);
+            std::vector<size_t>().swap(m_group_begin);
+            std::vector<size_t>().swap(m_group_end);
+        }
+        std::sort(m_factors.begin(), m_factors.end(),
+            [](const Factor& a, const Factor& b) { return a.target < b.target; });
+    }
+
+    // the position whose character is copied to the pending position `pos`
+    inline len_t source_of(len_t pos) const {
+        auto it = std::upper_bound(m_factors.begin(), m_factors.end(), pos,
+            [](len_t p, const Factor& f) { return p < f.target; });
+        DCHECK(it != m_factors.begin());
+        --it;
+        DCHECK_LT(pos, it->target + it->length);
+        return it->source + (pos - it->target);
+    }
+
+public:
+    inline BlockScanDec(Env&& env, len_t size)
+        : Algorithm(std::move(env))
+        , m_scans(this->env().option("scans").as_integer())
+        , m_block_size(std::max<len_t>(this->env().option("block_size").as_integer(), 1))
+        , m_threads(std::max<size_t>(this->env().option("threads").as_integer(), 1))
+        , m_cursor(0)
+        , m_buffer(size, 0)
+    { }
+
+    inline void decode_literal(uliteral_t c) {
+        m_buffer[m_cursor++] = c;
+        DCHECK(c != 0 || m_cursor == m_buffer.size()); // we assume that the text to restore does not contain a NULL-byte but at its very end
+    }
+
+    inline void decode_factor(const len_t source_position, const len_t factor_length) {
+        bool factor_stored = false;
+        for(len_t i = 0; i < factor_length; ++i) {
+            const len_t src_pos = source_position+i;
+            if(m_buffer[src_pos]) {
+                m_buffer[m_cursor] = m_buffer[src_pos];
+            }
+            else if(factor_stored == false) {
+                factor_stored = true;
+                m_factors.push_back(Factor {
+                    len_compact_t(m_cursor),
+                    len_compact_t(src_pos),
+                    len_compact_t(factor_length-i) });
+            }
+            ++m_cursor;
+        }
+    }
+
+    inline void decode_lazy() {
+        StatPhase::log("remaining factors", m_factors.size());
+        StatPhase::log("scans", m_scans);
+        if(m_scans == 0 || m_factors.empty()) return;
+
+        group_factors();
+        StatPhase::log("pieces", m_factors.size());
+        if(m_threads > 1) {
+            std::vector<std::vector<Factor>> copies(m_group_begin.size());
+            for(size_t s = 0; s < m_scans; ++s) {
+                scan_parallel(copies);
+            }
+        } else {
+            for(size_t s = 0; s < m_scans; ++s) {
+                scan();
+            }
+        }
+    }
+
+    inline void decode_eagerly() {
+        ungroup_factors();
+        StatPhase::log("remaining factors", m_factors.size());
+
+        std::vector<len_compact_t> chain;
+        for(size_t j = 0; j < m_factors.size(); ++j) {
+            const Factor f = m_factors[j];
+            for(len_t i = 0; i < f.length; ++i) {
+                len_t pos = f.target + i;
+                while(!is_decoded(pos)) {
+                    chain.push_back(pos);
+                    pos = source_of(pos);
+                    DCHECK_LE(chain.size(), m_buffer.size()) << "cyclic references";
+                }
+                const uliteral_t c = m_buffer[pos];
+                for(const len_t p : chain) m_buffer[p] = c;
+                IF_STATS(m_longest_chain = std::max<len_t>(m_longest_chain, chain.size()));
+                chain.clear();
+            }
+        }
+        std::vector<Factor>().swap(m_factors);
+    }
+
+    IF_STATS(
+    inline len_t longest_chain() const {
+        return m_longest_chain;
+    })
+
+    inline void write_to(std::ostream& out) const {
+        for(auto c : m_buffer) out << c;
+    }
+};
+
+}} //ns
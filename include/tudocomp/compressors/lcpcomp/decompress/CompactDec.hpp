@@ -32,27 +32,41 @@ private:
 
     len_t m_cursor;
     IF_STATS(len_t m_longest_chain);
-    IF_STATS(len_t m_current_chain);
 
     IntVector<uliteral_t> m_buffer;
 
-    inline void decode_literal_at(len_t pos, uliteral_t c) {
-		IF_STATS(++m_current_chain);
-        IF_STATS(m_longest_chain = std::max(m_longest_chain, m_current_chain));
-
-        m_buffer[pos] = c;
-		DCHECK(c != 0 || pos == m_buffer.size()-1); // we assume that the text to restore does not contain a NULL-byte but at its very end
+    // positions that still need to be decoded by decode_literal_at
+    std::vector<len_compact_t> m_worklist;
+    IF_STATS(std::vector<len_compact_t> m_chain_lengths); // parallel to m_worklist
 
-        if(m_fwd[pos] != nullptr) {
-            const len_compact_t*const& bucket = m_fwd[pos];
-            for(size_t i = 1; i < bucket[0]; ++i) {
-                decode_literal_at(bucket[i], c); // recursion
+    // Decodes `pos` and all positions waiting for it.
+    // As these chains can be very long, an explicit worklist is used
+    // instead of recursion.
+    inline void decode_literal_at(len_t pos, uliteral_t c) {
+        DCHECK(m_worklist.empty());
+        m_worklist.push_back(pos);
+        IF_STATS(m_chain_lengths.push_back(1));
+
+        while(!m_worklist.empty()) {
+            const len_t p = m_worklist.back();
+            m_worklist.pop_back();
+            IF_STATS(const len_t chain = m_chain_lengths.back());
+            IF_STATS(m_chain_lengths.pop_back());
+            IF_STATS(m_longest_chain = std::max(m_longest_chain, chain));
+
+            m_buffer[p] = c;
+            DCHECK(c != 0 || p == m_buffer.size()-1); // we assume that the text to restore does not contain a NULL-byte but at its very end
+
+            if(m_fwd[p] != nullptr) {
+                const len_compact_t*const& bucket = m_fwd[p];
+                for(size_t i = 1; i < bucket[0]; ++i) {
+                    m_worklist.push_back(bucket[i]);
+                    IF_STATS(m_chain_lengths.push_back(chain + 1));
+                }
+                free(m_fwd[p]);
+                m_fwd[p] = nullptr;
             }
-            free(m_fwd[pos]);
-            m_fwd[pos] = nullptr;
         }
-
-        IF_STATS(--m_current_chain);
     }
 
 public:
@@ -60,10 +74,11 @@ public:
         Algorithm(std::move(*this)),
         m_fwd(std::move(other.m_fwd)),
         m_cursor(std::move(other.m_cursor)),
-        m_buffer(std::move(other.m_buffer))
+        m_buffer(std::move(other.m_buffer)),
+        m_worklist(std::move(other.m_worklist))
     {
         IF_STATS(m_longest_chain = std::move(other.m_longest_chain));
-        IF_STATS(m_current_chain = std::move(other.m_current_chain));
+        IF_STATS(m_chain_lengths = std::move(other.m_chain_lengths));
 
         other.m_fwd = nullptr;
     }
@@ -81,7 +96,6 @@ public:
         : Algorithm(std::move(env)), m_cursor(0), m_buffer(size,0) {
 
         IF_STATS(m_longest_chain = 0);
-        IF_STATS(m_current_chain = 0);
 
         m_fwd = new len_compact_t*[size];
         std::fill(m_fwd,m_fwd+size,nullptr);
@@ -27,31 +27,42 @@ private:
 
     len_t m_cursor;
 
+    // positions that still need to be decoded by decode_literal_at,
+    // together with the length of the chain leading to them
+    std::vector<std::pair<len_compact_t, len_compact_t>> m_worklist;
+
     //stats:
     len_t m_longest_chain;
-    len_t m_current_chain;
     len_t m_max_depth;
 
+    // Decodes `pos` and all positions waiting for it.
+    // As these chains can be very long, an explicit worklist is used
+    // instead of recursion.
     inline void decode_literal_at(len_t pos, uliteral_t c) {
-        ++m_current_chain;
-        m_longest_chain = std::max(m_longest_chain, m_current_chain);
-        m_max_depth = std::max<len_t>(m_max_depth, m_fwd[pos].size());
+        DCHECK(m_worklist.empty());
+        m_worklist.emplace_back(pos, 1);
 
-        m_buffer[pos] = c;
-        m_decoded[pos] = 1;
+        while(!m_worklist.empty()) {
+            const len_t p = m_worklist.back().first;
+            const len_t chain = m_worklist.back().second;
+            m_worklist.pop_back();
 
-        for(auto fwd : m_fwd[pos]) {
-            decode_literal_at(fwd, c); // recursion
-        }
-        std::vector<len_compact_t>().swap(m_fwd[pos]); // forces vector to drop to capacity 0
-//        m_fwd[pos].clear();
+            m_longest_chain = std::max(m_longest_chain, chain);
+            m_max_depth = std::max<len_t>(m_max_depth, m_fwd[p].size());
+
+            m_buffer[p] = c;
+            m_decoded[p] = 1;
 
-        --m_current_chain;
+            for(auto fwd : m_fwd[p]) {
+                m_worklist.emplace_back(fwd, chain + 1);
+            }
+            std::vector<len_compact_t>().swap(m_fwd[p]); // forces vector to drop to capacity 0
+        }
     }
 
 public:
     inline DecodeForwardQueueListBuffer(Env&& env, len_t size)
-        : Algorithm(std::move(env)), m_cursor(0), m_longest_chain(0), m_current_chain(0), m_max_depth(0) {
+        : Algorithm(std::move(env)), m_cursor(0), m_longest_chain(0), m_max_depth(0) {
 
         m_buffer.resize(size, 0);
         m_fwd.resize(size, std::vector<len_compact_t>());
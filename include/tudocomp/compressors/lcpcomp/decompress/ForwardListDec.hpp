@@ -0,0 +1,138 @@
+#pragma once
+
+#include <vector>
+#include <tudocomp/def.hpp>
+#include <tudocomp/ds/IntVector.hpp>
+#include <tudocomp/Algorithm.hpp>
+
+namespace tdc {
+namespace lcpcomp {
+
+/**
+ * Decodes like \ref CompactDec, but stores the lists of positions waiting
+ * for a position to get decoded as singly linked lists in one arena.
+ *
+ * Each text position stores the index of the head of its list,
+ * each list node stores a waiting position and the index of the next node.
+ * Nodes of decoded positions are put on a free list and get reused,
+ * so the arena never holds more nodes than there are waiting positions
+ * at the same time.
+ * Chains of waiting positions are resolved with an explicit worklist
+ * instead of recursion.
+ */
+class ForwardListDec : public Algorithm {
+public:
+    inline static Meta meta() {
+        Meta m("lcpcomp_dec", "forward_list");
+        return m;
+    }
+    inline void decode_lazy() const {
+    }
+    inline void decode_eagerly() const {
+    }
+
+private:
+    // the null index, node 0 of the arena is never used
+    static constexpr len_t NIL = 0;
+
+    struct Node {
+        len_compact_t target; // position waiting for the character
+        len_compact_t next;   // next node in the list
+    };
+
+    IntVector<uliteral_t> m_buffer;
+    std::vector<len_compact_t> m_head; // list of waiting positions for each position
+    std::vector<Node> m_arena;
+    len_t m_free = NIL; // list of unused nodes in the arena
+
+    // positions that still need to be decoded by decode_literal_at
+    std::vector<len_compact_t> m_worklist;
+    IF_STATS(std::vector<len_compact_t> m_chain_lengths); // parallel to m_worklist
+
+    len_t m_cursor;
+    IF_STATS(len_t m_longest_chain = 0);
+
+    inline void push_front(len_t src, len_t target) {
+        len_t node;
+        if(m_free != NIL) {
+            node = m_free;
+            m_free = m_arena[node].next;
+        } else {
+            node = m_arena.size();
+            m_arena.emplace_back();
+        }
+        m_arena[node] = Node { len_compact_t(target), m_head[src] };
+        m_head[src] = node;
+    }
+
+    // Decodes `pos` and all positions waiting for it.
+    inline void decode_literal_at(len_t pos, uliteral_t c) {
+        DCHECK(m_worklist.empty());
+        m_worklist.push_back(pos);
+        IF_STATS(m_chain_lengths.push_back(1));
+
+        while(!m_worklist.empty()) {
+            const len_t p = m_worklist.back();
+            m_worklist.pop_back();
+            IF_STATS(const len_t chain = m_chain_lengths.back());
+            IF_STATS(m_chain_lengths.pop_back());
+            IF_STATS(m_longest_chain = std::max(m_longest_chain, chain));
+
+            m_buffer[p] = c;
+            DCHECK(c != 0 || p == m_buffer.size()-1); // we assume that the text to restore does not contain a NULL-byte but at its very end
+
+            const len_t first = m_head[p];
+            if(first == NIL) continue;
+            m_head[p] = NIL;
+
+            len_t last = first;
+            while(true) {
+                m_worklist.push_back(m_arena[last].target);
+                IF_STATS(m_chain_lengths.push_back(chain + 1));
+
+                if(m_arena[last].next == NIL) break;
+                last = m_arena[last].next;
+            }
+
+            // the whole list becomes free
+            m_arena[last].next = m_free;
+            m_free = first;
+        }
+    }
+
+public:
+    inline ForwardListDec(Env&& env, len_t size)
+        : Algorithm(std::move(env))
+        , m_buffer(size, 0)
+        , m_head(size, len_compact_t(NIL))
+        , m_arena(1)
+        , m_cursor(0)
+    { }
+
+    inline void decode_literal(uliteral_t c) {
+        decode_literal_at(m_cursor++, c);
+    }
+
+    inline void decode_factor(len_t pos, len_t num) {
+        for(len_t i = 0; i < num; i++) {
+            const len_t src = pos+i;
+            if(m_buffer[src]) {
+                decode_literal_at(m_cursor, m_buffer[src]);
+            } else {
+                push_front(src, m_cursor);
+            }
+            ++m_cursor;
+        }
+    }
+
+    IF_STATS(
+    inline len_t longest_chain() const {
+        return m_longest_chain;
+    })
+
+    inline void write_to(std::ostream& out) const {
+        for(auto c : m_buffer) out << c;
+    }
+};
+
+}} //ns
@@ -1,10 +1,9 @@
 #pragma once
 
 #include <vector>
-#include <sdsl/int_vector.hpp>
-#include <sdsl/rank_support.hpp>
 #include <tudocomp/def.hpp>
 #include <tudocomp/ds/IntVector.hpp>
+#include <tudocomp/ds/RankSelect.hpp>
 #include <tudocomp/Algorithm.hpp>
 #include <algorithm>
 
@@ -25,8 +24,7 @@ namespace lcpcomp {
 	class EagerScanDec {
 		Env& m_env;
 		IntVector<uliteral_t>& m_buffer;
-		const sdsl::bit_vector m_bv;
-		const sdsl::bit_vector::rank_1_type m_rank;
+		const RankSelect m_bv;
 		const len_t m_empty_entries;
 		len_compact_t**const m_fwd = nullptr;
 
@@ -37,15 +35,14 @@ namespace lcpcomp {
 		EagerScanDec(Env& env, IntVector<uliteral_t>& buffer)
 			: m_env(env)
 			, m_buffer { buffer }
-			, m_bv ( [&buffer] () -> sdsl::bit_vector {
-				sdsl::bit_vector bv { buffer.size(),0 };
+			, m_bv ( [&buffer] () -> RankSelect {
+				BitVector bv(buffer.size(), 0);
 				for(len_t i = 0; i < buffer.size(); ++i) {
 					if(buffer[i]) continue;
 					bv[i] = 1;
 				}
-				return bv;
+				return RankSelect(bv);
 			}() )
-			, m_rank { &m_bv }
 			//, m_empty_entries { static_cast<len_t>( buffer.size()) }
 			, m_empty_entries { static_cast<len_t>(std::count_if(buffer.cbegin(), buffer.cend(), [] (const uliteral_t& i) { return i == 0; })) }
 			, m_fwd { new len_compact_t*[m_empty_entries+1] }
@@ -55,7 +52,7 @@ namespace lcpcomp {
 
 		len_t rank(len_t i) const {
 			DCHECK(m_bv[i]);
-			return m_rank.rank(i+1);
+			return m_bv.rank1(i);
 		}
 
 		void decode(const std::vector<len_compact_t>& m_target_pos, const std::vector<len_compact_t>& m_source_pos, const std::vector<len_compact_t>& m_length) {
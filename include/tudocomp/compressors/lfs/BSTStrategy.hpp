@@ -22,9 +22,9 @@ class BSTStrategy : public Algorithm {
 private:
 
     //(position in text, non_terminal_symbol_number, length_of_symbol);
-    typedef std::tuple<uint,uint,uint> non_term;
+    typedef std::tuple<len_t,len_t,len_t> non_term;
     typedef std::vector<non_term> non_terminal_symbols;
-    typedef std::vector<std::pair<uint,uint>> rules;
+    typedef std::vector<std::pair<len_t,len_t>> rules;
     typedef uint node_type;
 
 
@@ -4,6 +4,7 @@
 #include <tudocomp/io.hpp>
 #include <tudocomp/ds/IntVector.hpp>
 #include <tudocomp/ds/TextDS.hpp>
+#include <tudocomp/ds/LCPIntervals.hpp>
 #include <tudocomp/Algorithm.hpp>
 
 #include <vector>
@@ -17,9 +18,9 @@ class ESAStrategy : public Algorithm {
 private:
 
     //(position in text, non_terminal_symbol_number, length_of_symbol);
-    typedef std::tuple<uint,uint,uint> non_term;
+    typedef std::tuple<len_t,len_t,len_t> non_term;
     typedef std::vector<non_term> non_terminal_symbols;
-    typedef std::vector<std::pair<uint,uint>> rules;
+    typedef std::vector<std::pair<len_t,len_t>> rules;
 
     BitVector dead_positions;
 
@@ -47,8 +48,10 @@ private:
 
 
 
-    //could be node_type
-    std::vector<std::vector<uint> > lcp_bins;
+    // lcp interval boundaries, sorted by factor length, and the start of
+    // each length
+    DynamicIntVector lcp_bins;
+    DynamicIntVector lcp_bin_start;
 public:
 
     using Algorithm::Algorithm; //import constructor
@@ -78,58 +81,80 @@ public:
 
         StatPhase::wrap("computing lrf occurences", [&]{
 
-        // iterate over lcp array, add indexes with non overlapping prefix length greater than min_lrf_length to vector
+        // enumerate the lcp intervals, and bin each by the length of the
+        // longest prefix that occurs twice without overlapping
 
 
         StatPhase::wrap("computing lrf occs", [&]{
 
-        DLOG(INFO) << "iterate over lcp";
-        uint dif ;
-        uint factor_length;
-
-        uint max = 0;
-
-        for(uint i = 1; i<lcp_t.size(); i++){
-
-
-            if(lcp_t[i] >= min_lrf){
-                if(max < lcp_t[i]){
-                    max = lcp_t[i];
-                    lcp_bins.resize(max+1);
+        DLOG(INFO) << "enumerate lcp intervals";
+        const size_t n = lcp_t.size();
+        const uint8_t w = bits_for(n);
+
+        // the smallest and largest starting position below each interval,
+        // by interval id, the parent may be opened after its child is closed
+        DynamicIntVector min_pos(n, n, w);
+        DynamicIntVector max_pos(n, 0, w);
+
+        // factor length and a boundary inside the interval, in postorder
+        DynamicIntVector lengths;
+        DynamicIntVector boundaries;
+        lengths.width(w);
+        boundaries.width(w);
+
+        size_t max = 0;
+
+        LCPIntervals intervals;
+        intervals.enumerate(lcp_t, 0, n - 1,
+            [&](const LCPInterval& iv) {
+                const size_t lo = min_pos[iv.id];
+                const size_t hi = max_pos[iv.id];
+                if(iv.parent != iv.id) {
+                    min_pos[iv.parent] = std::min(size_t(min_pos[iv.parent]), lo);
+                    max_pos[iv.parent] = std::max(size_t(max_pos[iv.parent]), hi);
                 }
-                //compute length of non-overlapping factor:
-
-                dif = std::abs((long)(sa_t[i-1] - sa_t[i]));
-                factor_length = lcp_t[i];
-                factor_length = std::min(factor_length, dif);
-
-                //maybe greater non-overlapping factor possible with smaller suffix?
-                int j =i-1;
-                uint alt_dif;
-                while(j>0 && lcp_t[j]>factor_length ){
-                    alt_dif = std::abs((long)(sa_t[j] - sa_t[i]));
-                    if(alt_dif>dif){
-                        dif = alt_dif;
-                    }
-                    j--;
-
 
+                //compute length of non-overlapping factor:
+                const size_t factor_length = std::min(iv.lcp, hi - lo);
+                if(iv.lcp >= min_lrf && factor_length >= min_lrf){
+                    lengths.push_back(factor_length);
+                    boundaries.push_back(iv.lb + 1);
+                    max = std::max(max, factor_length);
                 }
-                factor_length = lcp_t[i];
-                factor_length = std::min(factor_length, dif);
-                //second is position in suffix array
-                //first is length of common prefix
+            },
+            [&](size_t rank, size_t parent) {
+                const size_t pos = sa_t[rank];
+                min_pos[parent] = std::min(size_t(min_pos[parent]), pos);
+                max_pos[parent] = std::max(size_t(max_pos[parent]), pos);
+            });
+        min_pos = DynamicIntVector();
+        max_pos = DynamicIntVector();
+
+        // counting sort by factor length
+        if(lengths.size() > 0) {
+            lcp_bin_start = DynamicIntVector(max + 2, 0, w);
+            for(size_t k = 0; k < lengths.size(); k++) {
+                lcp_bin_start[lengths[k] + 1] = lcp_bin_start[lengths[k] + 1] + 1;
+            }
+            for(size_t l = 1; l < max + 2; l++) {
+                lcp_bin_start[l] = lcp_bin_start[l] + lcp_bin_start[l - 1];
+            }
 
-                lcp_bins[factor_length].push_back(i);
+            DynamicIntVector fill(lcp_bin_start);
+            lcp_bins = DynamicIntVector(lengths.size(), 0, w);
+            for(size_t k = 0; k < lengths.size(); k++) {
+                lcp_bins[fill[lengths[k]]] = boundaries[k];
+                fill[lengths[k]] = fill[lengths[k]] + 1;
             }
         }
 
-        DLOG(INFO)<<"max lcp: "<<max;
+        DLOG(INFO)<<"max factor length: "<<max;
         DLOG(INFO)<<"lcp bins: "<<lcp_bins.size();
 
         });
 
-        if(lcp_bins.size()< min_lrf){
+        const size_t num_bins = (lcp_bin_start.size() > 0) ? lcp_bin_start.size() - 1 : 0;
+        if(num_bins < min_lrf){
             DLOG(INFO)<<"nothing to replace, returning";
             return;
         }
@@ -145,11 +170,11 @@ public:
             // Pop PQ, Select occurences of suffix, check if contains replaced symbols
         dead_positions = BitVector(t.size(), 0);
 
-        nts_symbols.reserve(lcp_bins.size());
+        nts_symbols.reserve(num_bins);
         uint non_terminal_symbol_number = 0;
 
-        for(uint lcp_len = lcp_bins.size()-1; lcp_len>= min_lrf; lcp_len--){
-            for(auto bin_it = lcp_bins[lcp_len].begin(); bin_it!=lcp_bins[lcp_len].end(); bin_it++){
+        for(uint lcp_len = num_bins-1; lcp_len>= min_lrf; lcp_len--){
+            for(size_t bin_it = lcp_bin_start[lcp_len]; bin_it < size_t(lcp_bin_start[lcp_len + 1]); bin_it++){
 
 
 
@@ -162,7 +187,7 @@ public:
                 // and ceck in bitvector viable starting positions
                 // there is no 1 bit on the corresponding positions
                 // it suffices to check start and end position, because lrf can only be same length and shorter
-                uint i = *bin_it;
+                uint i = lcp_bins[bin_it];
 
                 uint shorter_dif = lcp_len;
 
@@ -180,7 +205,7 @@ public:
                     i--;
 
                 }
-                i = *bin_it;
+                i = lcp_bins[bin_it];
                 while(i< lcp_t.size() &&  lcp_t[i]>=lcp_len){
 
                     if(!dead_positions[sa_t[i]]  && !dead_positions[sa_t[i]+lcp_len-1]){
@@ -201,7 +226,7 @@ public:
 
 
 
-                        uint offset = sa_t[*bin_it];
+                        uint offset = sa_t[lcp_bins[bin_it]];
                         std::pair<uint,uint> longest_repeating_factor(offset, lcp_len);
                         for (std::vector<uint>::iterator it=selected_starting_positions.begin(); it!=selected_starting_positions.end(); ++it){
                             for(uint k = 0; k<lcp_len; k++){
@@ -42,10 +42,10 @@ template<typename literal_coder_t, typename len_coder_t >
 class EncodeStrategy : public Algorithm {
 private:
 
-    typedef std::tuple<uint,uint,uint> non_term;
+    typedef std::tuple<len_t,len_t,len_t> non_term;
     typedef std::vector<non_term> non_terminal_symbols;
 
-    typedef std::vector<std::pair<uint,uint>> rules;
+    typedef std::vector<std::pair<len_t,len_t>> rules;
 
 public:
 
@@ -79,11 +79,11 @@ public:
 
         auto it = dictionary.begin();
 
-        Range intrange (0, UINT_MAX);//uint32_r
+        Range intrange (0, INDEX_MAX);
         if(dictionary.size() >=1 ){
 
-            std::pair<uint,uint> symbol = *it;
-            uint last_length=symbol.second;
+            std::pair<len_t,len_t> symbol = *it;
+            len_t last_length=symbol.second;
             Range s_length_r (0,last_length);
             len_coder.encode(last_length,intrange);
             it++;
@@ -104,20 +104,20 @@ public:
         long buf_size = bitout->tellp();
 
         StatPhase::log("Bytes Length Encoding", buf_size);
-        uint literals=0;
+        len_t literals=0;
 
 
         DLOG(INFO) << "encoding dictionary symbols";
         // encode dictionary strings:
         if(dictionary.size() >=1 ){
             auto it = dictionary.begin();
-            std::pair<uint,uint> symbol;
+            std::pair<len_t,len_t> symbol;
 
              while(it != dictionary.end()){
             //first length of non terminal symbol
                 symbol = *it;
 
-                for(uint k = 0; k<symbol.second; k++){
+                for(len_t k = 0; k<symbol.second; k++){
                     lit_coder.encode(in[symbol.first + k],literal_r);
                     literals++;
                 }
@@ -134,15 +134,15 @@ public:
 
         Range dict_r(0, dictionary.size());
         //encode string
-        uint pos = 0;
-        uint start_position;
-        uint symbol_number ;
-        uint symbol_length;
+        len_t pos = 0;
+        len_t start_position;
+        len_t symbol_number ;
+        len_t symbol_length;
         bool first_char = true;
         for(auto it = nts_symbols.begin(); it!= nts_symbols.end(); it++){
 
 
-            std::tuple<uint,uint,uint> next_position = *it;
+            non_term next_position = *it;
 
             start_position = std::get<0>(next_position);
             symbol_number =std::get<1>(next_position);
@@ -200,35 +200,35 @@ public:
             env().env_for_option("lfs_len_coder"),
             bitin
         );
-        Range int_r (0,UINT_MAX);
+        Range int_r (0,INDEX_MAX);
 
-        uint symbol_length = len_decoder.template decode<uint>(int_r);
+        len_t symbol_length = len_decoder.template decode<len_t>(int_r);
         Range slength_r (0, symbol_length);
-        std::vector<uint> dict_lengths;
+        std::vector<len_t> dict_lengths;
         dict_lengths.reserve(symbol_length);
         dict_lengths.push_back(symbol_length);
         while(symbol_length>0){
 
-            uint current_delta = len_decoder.template decode<uint>(slength_r);
+            len_t current_delta = len_decoder.template decode<len_t>(slength_r);
             symbol_length-=current_delta;
             dict_lengths.push_back(symbol_length);
         }
         dict_lengths.pop_back();
 
         std::vector<std::string> dictionary;
-        uint dictionary_size = dict_lengths.size();
+        size_t dictionary_size = dict_lengths.size();
 
         Range dictionary_r (0, dictionary_size);
 
 
-        uint length_of_symbol;
+        len_t length_of_symbol;
         std::string non_terminal_symbol;
         DLOG(INFO) << "reading dictionary";
-        for(uint i = 0; i< dict_lengths.size();i++){
+        for(size_t i = 0; i< dict_lengths.size();i++){
             non_terminal_symbol ="";
             char c1;
             length_of_symbol=dict_lengths[i];
-            for(uint i =0; i< length_of_symbol;i++){
+            for(len_t i =0; i< length_of_symbol;i++){
                 c1 = lit_decoder.template decode<char>(literal_r);
                 non_terminal_symbol += c1;
             }
@@ -240,7 +240,7 @@ public:
             //decode bit
             bool bit1 = lit_decoder.template decode<bool>(bit_r);
             char c1;
-            uint symbol_number;
+            len_t symbol_number;
             // if bit = 0 its a literal
             if(!bit1){
                 c1 = lit_decoder.template decode<char>(literal_r); // Dekodiere Literal
@@ -248,7 +248,7 @@ public:
                 ostream << c1;
             } else {
             //else its a non-terminal
-                symbol_number = lit_decoder.template decode<uint>(dictionary_r); // Dekodiere Literal
+                symbol_number = lit_decoder.template decode<len_t>(dictionary_r); // Dekodiere Literal
 
                 if(symbol_number < dictionary.size()){
 
@@ -9,10 +9,11 @@
 #include <tudocomp/util.hpp>
 #include <tudocomp/io.hpp>
 #include <tudocomp/ds/IntVector.hpp>
+#include <tudocomp/ds/TextDS.hpp>
+#include <tudocomp/ds/CompactSuffixTree.hpp>
 #include <tudocomp_stat/StatPhase.hpp>
 
-//sdsl include stree:
-#include <sdsl/suffix_trees.hpp>
+#include <tudocomp/compressors/lfs/NodeBegins.hpp>
 
 
 //includes encoding:
@@ -31,7 +32,7 @@
 namespace tdc {
 namespace lfs {
 
-template<typename literal_coder_t = HuffmanCoder, typename len_coder_t = EliasGammaCoder >
+template<typename literal_coder_t = HuffmanCoder, typename len_coder_t = EliasGammaCoder, typename text_t = TextDS<> >
 class LFS2Compressor : public Compressor {
 private:
 
@@ -39,34 +40,33 @@ private:
 
 
     //Suffix Tree type + st
-    typedef sdsl::cst_sct3< sdsl::csa_bitcompressed<> > cst_t;
+    typedef CompactSuffixTree cst_t;
     cst_t stree;
 
     using node_type = typename cst_t::node_type;
 
     //Stores nts_symbols of first layer
-    IntVector<uint> first_layer_nts;
+    IntVector<len_compact_t> first_layer_nts;
     // offset to begin of last nts +1. if ==0 no substitution
-    IntVector<uint> fl_offsets;
+    IntVector<len_compact_t> fl_offsets;
     // stores subs in first layer symbols
-    IntVector<uint> second_layer_nts;
+    IntVector<len_compact_t> second_layer_nts;
     // dead pos in first layer
     BitVector second_layer_dead;
 
 
     //pair contains begin pos, length
-    std::vector<std::pair<uint, uint> > non_terminal_symbols;
+    std::vector<std::pair<len_t, len_t> > non_terminal_symbols;
 
 
     //stores node_ids of corresponding factor length
-    std::vector<std::vector<uint> > bins;
+    std::vector<std::vector<node_type> > bins;
 
 
     //stores beginning positions corresponding to node_ids
-    std::vector<std::vector<uint> > node_begins;
+    NodeBegins node_begins;
 
     bool exact;
-    uint size;
 
 
 
@@ -81,6 +81,8 @@ public:
         m.option("exact").dynamic(0);
         m.option("lfs2_lit_coder").templated<literal_coder_t, HuffmanCoder>("lfs2_lit_coder");
         m.option("lfs2_len_coder").templated<len_coder_t, EliasGammaCoder>("lfs2_len_coder");
+        m.option("textds").templated<text_t, TextDS<>>("textds");
+        m.uses_textds<text_t>(text_t::SA | text_t::LCP);
 
         return m;
     }
@@ -92,7 +94,7 @@ public:
         DLOG(INFO) << "Compressor lfs2 instantiated";
     }
     inline virtual void compress(Input& input, Output& output) override {
-        uint min_lrf = env().option("min_lrf").as_integer();
+        len_t min_lrf = env().option("min_lrf").as_integer();
         uint temp = env().option("exact").as_integer();
         exact=false;
         if(temp > 0){
@@ -103,9 +105,9 @@ public:
 
 
         //create vectors:
-        first_layer_nts = IntVector<uint>(input.size(), 0);
-        fl_offsets = IntVector<uint>(input.size(), 0);
-        second_layer_nts = IntVector<uint>(input.size(), 0);
+        first_layer_nts = IntVector<len_compact_t>(input.size(), 0);
+        fl_offsets = IntVector<len_compact_t>(input.size(), 0);
+        second_layer_nts = IntVector<len_compact_t>(input.size(), 0);
         second_layer_dead = BitVector(input.size(), 0);
 
 
@@ -116,123 +118,67 @@ public:
 
 
         StatPhase::wrap("Constructing ST", [&]{
-            size =  in.size();
-            //remove sentinel because sdsl cant handle that
-            while(in[size-1] == 0){
-                size--;
-            }
-
+            // the suffix and LCP arrays are discarded with the text ds,
+            // only a copy of the suffix array is kept for the node begins
+            text_t t(env().env_for_option("textds"), in, text_t::SA | text_t::LCP);
+            stree = cst_t(t.require_sa(), t.require_lcp());
+            node_begins = NodeBegins(stree, t.require_sa());
 
-
-            std::string in_string ((const char*) in.data(), size);
-            sdsl::construct_im(stree, in_string , 1);
+            StatPhase::log("size", stree.size_in_bytes() + node_begins.size_in_bytes());
         });
 
 
 
         StatPhase::wrap("Computing LRF", [&]{
-            bins.resize(200);
-            uint node_counter = 0;
-
-            typedef sdsl::cst_bfs_iterator<cst_t> iterator;
-            iterator begin = iterator(&stree, stree.root());
-            iterator end   = iterator(&stree, stree.root(), true, true);
 
             StatPhase::wrap("Iterate over ST", [&]{
                 DLOG(INFO)<<"iterate st";
 
-                for (iterator it = begin; it != end; ++it) {
-
-                    if(!stree.is_leaf(*it)){
-
-                        if(bins.size() <= stree.depth(*it)) {
+                size_t max_depth = 0;
+                for(node_type node = 0; node < stree.internal_nodes(); node++){
+                    max_depth = std::max(max_depth, stree.str_depth(node));
+                }
+                bins.resize(max_depth + 1);
 
-                            uint resize = bins.size()*2;
-                            while (resize<= stree.depth(*it)) {
-                                resize*=2;
-                            }
-                            bins.resize(resize);
-                        }
-                        bins[stree.depth(*it)].push_back(stree.id(*it));
-                        node_counter++;
-                    }
+                for(node_type node = 0; node < stree.internal_nodes(); node++){
+                    bins[stree.str_depth(node)].push_back(node);
                 }
             });
-            node_begins.resize(node_counter);
 
-            uint nts_number = 1 ;
+            len_t nts_number = 1 ;
             StatPhase::wrap("Iterate over Node Bins", [&]{
                 //iterate node bins top down
                 DLOG(INFO)<<"iterate over Node Bins";
-                for(uint i = bins.size()-1; i>=min_lrf; i--){
+                for(len_t i = bins.size()-1; i>=min_lrf; i--){
 
                     //iterate over ids in bin:
                     while(!bins[i].empty()){
-                        uint id = bins[i].back();
+                        node_type node = bins[i].back();
                         bins[i].pop_back();
-                        node_type node = stree.inv_id(id);
-                        uint no_leaf_id = id - stree.size();
 
                         //get bps of node
 
-                        if(node_begins[no_leaf_id].empty()){
+                        if(!node_begins.computed(node)){
                             //get leaves or merge child vectors
-                            std::vector<uint> offsets;
-                            std::vector<uint> leaf_bps;
-
-                            for (auto & child : stree.children(node)) {
-                                if(stree.is_leaf(child)){
-
-
-                                        leaf_bps.push_back(stree.csa[stree.lb(child)]);
-
-
-                                } else {
-                                    int child_id = stree.id(child) - stree.size();
-                                    if(!node_begins[child_id ].empty()){
-                                        //append child list, remember offset
-                                        offsets.push_back(node_begins[no_leaf_id].size());
-
-
-                                        node_begins[no_leaf_id].insert(node_begins[no_leaf_id].end(),node_begins[child_id ].begin(), node_begins[child_id].end());
-
-                                        node_begins[child_id] = std::vector<uint>();
-
-                                    }
-                                }
-                            }
-                            std::sort(leaf_bps.begin(), leaf_bps.end());
-
-                            offsets.push_back(node_begins[no_leaf_id].size());
-                            node_begins[no_leaf_id].insert(node_begins[no_leaf_id].end(),leaf_bps.begin(), leaf_bps.end());
-
-                            //inplace merge with offset
-                            for(uint k = 0; k < offsets.size()-1; k++){
-                                std::inplace_merge(node_begins[no_leaf_id].begin(), node_begins[no_leaf_id].begin()+ offsets[k], node_begins[no_leaf_id].begin()+ offsets[k+1]);
-
-                            }
-                            //now inplace merge to end
-                            std::inplace_merge(node_begins[no_leaf_id].begin(), node_begins[no_leaf_id].begin()+ offsets.back(), node_begins[no_leaf_id].end());
-
-
-
+                            node_begins.compute(node, [](len_t){ return true; });
                         }
                         //if still empty, because everything is substituted...
-                        if(node_begins[no_leaf_id].empty()){
+                        if(node_begins.empty(node)){
                             continue;
                         }
                         //check if viable lrf, else sort higher!
-                        if((node_begins[no_leaf_id].size()>=2)){
+                        if((node_begins.size(node)>=2)){
 
-                            if (( (uint)( node_begins[no_leaf_id].back() - node_begins[no_leaf_id].front() )) >= i ){
+                            if (( (len_t)( node_begins.back(node) - node_begins.front(node) )) >= i ){
 
                                 //greedily iterate over occurences
                                 signed long last =  0 - (long) i;
-                                std::vector<uint> first_layer_viable;
-                                std::vector<uint> second_layer_viable;
-                                for(uint occurence : node_begins[no_leaf_id]){
+                                std::vector<len_t> first_layer_viable;
+                                std::vector<len_t> second_layer_viable;
+                                for(size_t k = 0; k < node_begins.size(node); k++){
+                                    len_t occurence = node_begins.at(node, k);
                                     //check for viability
-                                    if( (last+i <= (long) occurence)){
+                                    if( (last + (long) i <= (long) occurence)){
                                         if(fl_offsets[occurence] == 0){
                                             if(fl_offsets[occurence + i -1] == 0){
                                                 //Position is firs layer viable
@@ -241,7 +187,7 @@ public:
                                             }
                                         } else {
                                             //find nts number of symbol that corresponds to substitued occ
-                                            uint parent_nts= first_layer_nts[ occurence - (fl_offsets[occurence] -1) ];
+                                            len_t parent_nts= first_layer_nts[ occurence - (fl_offsets[occurence] -1) ];
                                             auto nts = non_terminal_symbols[parent_nts-1];
                                             //if length of parent nts is greater than current len + offset
                                             if(nts.second >=fl_offsets[occurence]-1 + i ){
@@ -258,32 +204,32 @@ public:
 
                                 //if at least 2 first level layer occs viable:
                                 if(first_layer_viable.size() >=1 &&(first_layer_viable.size() + second_layer_viable.size() >= 2) ) {
-                                    std::pair<uint,uint> nts = std::make_pair(first_layer_viable.front(), i);
+                                    std::pair<len_t,len_t> nts = std::make_pair(first_layer_viable.front(), i);
                                     non_terminal_symbols.push_back(nts);
 
                                     //iterate over vector, make first layer unviable:
-                                    for(uint occ : first_layer_viable){
+                                    for(len_t occ : first_layer_viable){
                                         first_layer_nts[occ]= nts_number;
 
-                                        for(uint nts_length =0; nts_length < i; nts_length++){
+                                        for(len_t nts_length =0; nts_length < i; nts_length++){
                                             fl_offsets[occ + nts_length] = nts_length+1;
                                         }
                                     }
 
 
 
-                                    for(uint sl_occ :second_layer_viable){
-                                        uint parent_nts= first_layer_nts[ sl_occ - (fl_offsets[sl_occ] -1) ];
+                                    for(len_t sl_occ :second_layer_viable){
+                                        len_t parent_nts= first_layer_nts[ sl_occ - (fl_offsets[sl_occ] -1) ];
 
                                         auto parent_sym = non_terminal_symbols[parent_nts-1];
-                                        uint parent_start= parent_sym.first;
-                                        uint sl_start = (parent_start + fl_offsets[sl_occ] -1);
-                                        uint sl_end = sl_start+i-1;
+                                        len_t parent_start= parent_sym.first;
+                                        len_t sl_start = (parent_start + fl_offsets[sl_occ] -1);
+                                        len_t sl_end = sl_start+i-1;
                                         if(second_layer_dead[sl_start] == (uint)0 && second_layer_dead[sl_end] == (uint)0){
 
                                             second_layer_nts[sl_start]=nts_number;
 
-                                            for(uint dead = sl_start; dead<=sl_end;dead++){
+                                            for(len_t dead = sl_start; dead<=sl_end;dead++){
                                                 second_layer_dead[dead]=1;
                                             }
                                         }
@@ -299,13 +245,13 @@ public:
                             } else {
                                 if(exact){
                                     //readd node if lrf shorter
-                                    uint min_shorter = node_begins[no_leaf_id].back()   - node_begins[no_leaf_id].front();
+                                    len_t min_shorter = node_begins.back(node)   - node_begins.front(node);
                                     //check if parent subs this lrf
                                     node_type parent = stree.parent(node);
-                                    uint depth = stree.depth(parent);
+                                    len_t depth = stree.str_depth(parent);
                                     if(depth < (min_shorter)){
                                         //just re-add node, if the possible replaceable lrf is longer than dpeth of parent node
-                                        bins[min_shorter].push_back(stree.id(node));
+                                        bins[min_shorter].push_back(node);
                                     }
 
 
@@ -324,16 +270,16 @@ public:
 
         DLOG(INFO)<<"Computing symbol depth";
 
-        IntVector<uint> nts_depth(non_terminal_symbols.size(), 0);
+        IntVector<len_compact_t> nts_depth(non_terminal_symbols.size(), 0);
 
-        for(uint nts_num =0; nts_num<non_terminal_symbols.size(); nts_num++){
+        for(size_t nts_num =0; nts_num<non_terminal_symbols.size(); nts_num++){
             auto symbol = non_terminal_symbols[nts_num];
-            uint cur_depth = nts_depth[nts_num];
+            len_t cur_depth = nts_depth[nts_num];
 
-            for(uint pos = symbol.first; pos < symbol.second + symbol.first ; pos++){
+            for(len_t pos = symbol.first; pos < symbol.second + symbol.first ; pos++){
                 if(second_layer_nts[pos]>0){
 
-                    uint symbol_num = second_layer_nts[pos] -1;
+                    len_t symbol_num = second_layer_nts[pos] -1;
                     if(nts_depth[symbol_num]< cur_depth+1){
                         nts_depth[symbol_num]= cur_depth+1;
                     }
@@ -350,13 +296,13 @@ public:
         std::sort(nts_depth.begin(), nts_depth.end());
         if(nts_depth.size()>0){
 
-            uint max_depth = nts_depth[nts_depth.size()-1];
+            len_t max_depth = nts_depth[nts_depth.size()-1];
 
             DLOG(INFO)<<"Max CFG Depth: "<< max_depth;
             DLOG(INFO)<<"Number of CFG rules: "<< non_terminal_symbols.size();
 
             if(nts_depth.size()>=4){
-                uint quarter = nts_depth.size() /4;
+                size_t quarter = nts_depth.size() /4;
 
                 StatPhase::log("25 \% quantil CFG Depth", nts_depth[quarter -1]);
                 StatPhase::log("50 \% quantil CFG Depth", nts_depth[(2*quarter) -1]);
@@ -375,16 +321,16 @@ public:
 
         std::stringstream literals;
 
-        for(uint position = 0; position< in.size(); position++){
+        for(len_t position = 0; position< in.size(); position++){
             if(fl_offsets[position]==0){
                 literals << in[position];
             }
         }
-        for(uint nts_num = 0; nts_num<non_terminal_symbols.size(); nts_num++){
+        for(size_t nts_num = 0; nts_num<non_terminal_symbols.size(); nts_num++){
 
             auto symbol = non_terminal_symbols[nts_num];
 
-            for(uint pos = symbol.first; pos < symbol.second + symbol.first; pos++){
+            for(len_t pos = symbol.first; pos < symbol.second + symbol.first; pos++){
                 if(second_layer_nts[pos] == 0 && pos < in.size()){
                     literals<< in[pos];
 
@@ -411,16 +357,16 @@ public:
 
             //encode lengths:
             DLOG(INFO)<<"number nts: " << non_terminal_symbols.size();
-            Range intrange (0, UINT_MAX);
+            Range intrange (0, INDEX_MAX);
             //encode first length:
             if(non_terminal_symbols.size()>=1){
                 auto symbol = non_terminal_symbols[0];
-                uint last_length=symbol.second;
+                len_t last_length=symbol.second;
                 //Range for encoding nts number
                 Range s_length_r (0,last_length);
                 len_coder.encode(last_length,intrange);
                 //encode delta length  of following symbols
-                for(uint nts_num = 1; nts_num < non_terminal_symbols.size(); nts_num++){
+                for(size_t nts_num = 1; nts_num < non_terminal_symbols.size(); nts_num++){
                     symbol = non_terminal_symbols[nts_num];
                     len_coder.encode(last_length-symbol.second,s_length_r);
                     last_length=symbol.second;
@@ -442,16 +388,16 @@ public:
 
 
             DLOG(INFO) << "encoding dictionary symbols";
-            uint dict_literals=0;
+            len_t dict_literals=0;
 
             // encode dictionary strings, backwards, to directly decode strings:
             if(non_terminal_symbols.size()>=1){
-                std::pair<uint,uint> symbol;
+                std::pair<len_t,len_t> symbol;
                 for(long nts_num =non_terminal_symbols.size()-1; nts_num >= 0; nts_num--){
 
                     symbol = non_terminal_symbols[nts_num];
 
-                    for(uint pos = symbol.first; pos < symbol.second + symbol.first ; pos++){
+                    for(len_t pos = symbol.first; pos < symbol.second + symbol.first ; pos++){
                         if(second_layer_nts[pos] > 0){
                             lit_coder.encode(1, bit_r);
                             lit_coder.encode(second_layer_nts[pos], dict_r);
@@ -472,7 +418,7 @@ public:
                 }
             }
 
-             uint literals=0;
+             len_t literals=0;
 
 
 
@@ -486,7 +432,7 @@ public:
             //encode start symbol
 
             DLOG(INFO)<<"encode start symbol";
-            for(uint pos = 0; pos < in.size(); pos++){
+            for(len_t pos = 0; pos < in.size(); pos++){
                 if(first_layer_nts[pos]>0){
                     lit_coder.encode(1, bit_r);
                     lit_coder.encode(first_layer_nts[pos], dict_r);
@@ -537,16 +483,16 @@ public:
             env().env_for_option("lfs2_len_coder"),
             bitin
         );
-        Range int_r (0,UINT_MAX);
+        Range int_r (0,INDEX_MAX);
 
-        uint symbol_length = len_decoder.template decode<uint>(int_r);
+        len_t symbol_length = len_decoder.template decode<len_t>(int_r);
         Range slength_r (0, symbol_length);
-        std::vector<uint> dict_lengths;
+        std::vector<len_t> dict_lengths;
         dict_lengths.reserve(symbol_length);
         dict_lengths.push_back(symbol_length);
         while(symbol_length>0){
 
-            uint current_delta = len_decoder.template decode<uint>(slength_r);
+            len_t current_delta = len_decoder.template decode<len_t>(slength_r);
             symbol_length-=current_delta;
             dict_lengths.push_back(symbol_length);
         }
@@ -557,7 +503,7 @@ public:
 
 
         std::vector<std::string> dictionary;
-        uint dictionary_size = dict_lengths.size();
+        size_t dictionary_size = dict_lengths.size();
 
         Range dictionary_r (0, dictionary_size);
 
@@ -565,7 +511,7 @@ public:
         dictionary.resize(dict_lengths.size());
 
         std::stringstream ss;
-        uint symbol_number;
+        len_t symbol_number;
         char c1;
 
         DLOG(INFO) << "reading dictionary";
@@ -580,7 +526,7 @@ public:
 
                 if(bit1){
                     //bit = 1, is nts, decode nts num and copy
-                    symbol_number = lit_decoder.template decode<uint>(dictionary_r);
+                    symbol_number = lit_decoder.template decode<len_t>(dictionary_r);
 
                     symbol_number-=1;
 
@@ -614,7 +560,7 @@ public:
             //decode bit
             bool bit1 = lit_decoder.template decode<bool>(bit_r);
             char c1;
-            uint symbol_number;
+            len_t symbol_number;
             // if bit = 0 its a literal
             if(!bit1){
                 c1 = lit_decoder.template decode<char>(literal_r); // Dekodiere Literal
@@ -622,7 +568,7 @@ public:
                 ostream << c1;
             } else {
             //else its a non-terminal
-                symbol_number = lit_decoder.template decode<uint>(dictionary_r); // Dekodiere Literal
+                symbol_number = lit_decoder.template decode<len_t>(dictionary_r); // Dekodiere Literal
                 symbol_number-=1;
 
                 if(symbol_number < dictionary.size()){
@@ -28,9 +28,9 @@ template<typename comp_strategy_t , typename coding_strat_t = EncodeStrategy<Huf
 class LFSCompressor : public Compressor {
 private:
 
-    typedef std::tuple<uint,uint,uint> non_term;
+    typedef std::tuple<len_t,len_t,len_t> non_term;
     typedef std::vector<non_term> non_terminal_symbols;
-    typedef std::vector<std::pair<uint,uint>> rules;
+    typedef std::vector<std::pair<len_t,len_t>> rules;
 
 
 public:
@@ -0,0 +1,181 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+
+#include <tudocomp/def.hpp>
+#include <tudocomp/util.hpp>
+#include <tudocomp/ds/IntVector.hpp>
+#include <tudocomp/ds/CompactSuffixTree.hpp>
+
+namespace tdc {
+namespace lfs {
+
+/// \brief Stores the sorted beginning positions of the internal nodes of a
+///        \ref CompactSuffixTree in a single flat array.
+///
+/// The array starts as a copy of the suffix array, so the leaves below an
+/// internal node `v` occupy the interval `[lb(v), rb(v)]`. Once all internal
+/// children of `v` are computed, \ref compute merges their positions and
+/// those of its leaf children into the front of that interval, sorted by
+/// text position. As the interval of a node contains those of its children,
+/// no further memory is needed, but the positions of the children are lost.
+///
+/// The longest first substitution strategies process the nodes by
+/// decreasing string depth, so the children of a node are always computed
+/// before it.
+class NodeBegins {
+private:
+    const CompactSuffixTree* m_st;
+
+    // the positions of internal node v are m_pos[lb(v), lb(v) + m_count[v])
+    DynamicIntVector m_pos;
+    DynamicIntVector m_count;
+    BitVector m_computed;
+
+    // reused across nodes
+    std::vector<len_t> m_buffer;
+    std::vector<len_t> m_leaves;
+    std::vector<size_t> m_offsets;
+
+public:
+    using node_type = CompactSuffixTree::node_type;
+
+    /// \brief Constructs an empty instance.
+    inline NodeBegins() : m_st(nullptr) {
+    }
+
+    /// \brief Constructor.
+    ///
+    /// \param st the suffix tree.
+    /// \param sa the suffix array the tree was constructed from.
+    template<typename sa_t>
+    inline NodeBegins(const CompactSuffixTree& st, const sa_t& sa) : m_st(&st) {
+        const size_t n = st.size();
+        const uint8_t w = bits_for(n);
+
+        m_pos = DynamicIntVector(n, 0, w);
+        for(size_t i = 0; i < n; i++) m_pos[i] = sa[i];
+
+        m_count = DynamicIntVector(st.internal_nodes(), 0, w);
+        m_computed = BitVector(st.internal_nodes(), 0);
+    }
+
+    /// \brief Tests whether the positions of a node have been computed.
+    inline bool computed(node_type v) const {
+        return m_computed[v];
+    }
+
+    /// \brief The number of positions of a computed node.
+    inline size_t size(node_type v) const {
+        DCHECK(computed(v));
+        return m_count[v];
+    }
+
+    /// \brief Tests whether a computed node has no positions.
+    inline bool empty(node_type v) const {
+        return size(v) == 0;
+    }
+
+    /// \brief The k-th smallest position of a computed node.
+    inline len_t at(node_type v, size_t k) const {
+        DCHECK_LT(k, size(v));
+        return m_pos[m_st->lb(v) + k];
+    }
+
+    /// \brief The smallest position of a computed, non-empty node.
+    inline len_t front(node_type v) const {
+        return at(v, 0);
+    }
+
+    /// \brief The largest position of a computed, non-empty node.
+    inline len_t back(node_type v) const {
+        return at(v, size(v) - 1);
+    }
+
+    /// \brief Computes the positions of a node from those of its children.
+    ///
+    /// All internal children must have been computed before.
+    ///
+    /// \param v the internal node.
+    /// \param keep_leaf a predicate that decides whether the position of a
+    ///                  leaf child is included.
+    template<typename leaf_pred_t>
+    inline void compute(node_type v, leaf_pred_t keep_leaf) {
+        DCHECK(!computed(v));
+
+        m_buffer.clear();
+        m_leaves.clear();
+        m_offsets.clear();
+
+        // append the sorted positions of the internal children, and collect
+        // the leaf children in the gaps between them
+        auto add_leaves = [&](size_t from, size_t to) {
+            for(size_t i = from; i < to; i++) {
+                const len_t p = m_pos[i];
+                if(keep_leaf(p)) m_leaves.push_back(p);
+            }
+        };
+
+        size_t next = m_st->lb(v);
+        m_st->for_each_internal_child(v, [&](node_type c) {
+            DCHECK(computed(c));
+            const size_t lb = m_st->lb(c);
+            add_leaves(next, lb);
+            next = m_st->rb(c) + 1;
+
+            const size_t count = m_count[c];
+            if(count > 0) {
+                m_offsets.push_back(m_buffer.size());
+                for(size_t k = 0; k < count; k++) m_buffer.push_back(m_pos[lb + k]);
+            }
+        });
+        add_leaves(next, m_st->rb(v) + 1);
+
+        // the leaves form one more sorted run
+        if(!m_leaves.empty()) {
+            std::sort(m_leaves.begin(), m_leaves.end());
+            m_offsets.push_back(m_buffer.size());
+            m_buffer.insert(m_buffer.end(), m_leaves.begin(), m_leaves.end());
+        }
+
+        // merge the runs
+        for(size_t k = 1; k < m_offsets.size(); k++) {
+            const size_t end = (k + 1 < m_offsets.size())
+                ? m_offsets[k + 1] : m_buffer.size();
+            std::inplace_merge(m_buffer.begin(),
+                               m_buffer.begin() + m_offsets[k],
+                               m_buffer.begin() + end);
+        }
+
+        const size_t lb = m_st->lb(v);
+        for(size_t k = 0; k < m_buffer.size(); k++) m_pos[lb + k] = m_buffer[k];
+        m_count[v] = m_buffer.size();
+        m_computed[v] = 1;
+    }
+
+    /// \brief Removes positions from a computed node.
+    ///
+    /// \param v the internal node.
+    /// \param keep a predicate that is called for each position in
+    ///             ascending order and decides whether it is kept.
+    template<typename pred_t>
+    inline void retain(node_type v, pred_t keep) {
+        const size_t lb = m_st->lb(v);
+        const size_t count = size(v);
+
+        size_t kept = 0;
+        for(size_t k = 0; k < count; k++) {
+            const len_t p = m_pos[lb + k];
+            if(keep(p)) m_pos[lb + kept++] = p;
+        }
+        m_count[v] = kept;
+    }
+
+    /// \brief The size of the data structure in bytes.
+    inline size_t size_in_bytes() const {
+        return (m_pos.bit_size() + m_count.bit_size() + m_computed.bit_size()) / 8;
+    }
+};
+
+}} //ns
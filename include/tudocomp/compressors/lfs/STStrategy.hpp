@@ -3,14 +3,15 @@
 #include <vector>
 #include <tuple>
 
-#include <unordered_map>
-
 
 #include <tudocomp/util.hpp>
 #include <tudocomp/io.hpp>
 #include <tudocomp/ds/IntVector.hpp>
 #include <tudocomp/Algorithm.hpp>
-#include <tudocomp/ds/SuffixTree.hpp>
+#include <tudocomp/ds/TextDS.hpp>
+#include <tudocomp/ds/CompactSuffixTree.hpp>
+
+#include <tudocomp/compressors/lfs/NodeBegins.hpp>
 
 
 
@@ -18,96 +19,49 @@
 namespace tdc {
 namespace lfs {
 
+template<typename text_t = TextDS<>>
 class STStrategy : public Algorithm {
 private:
 
-    typedef std::tuple<uint,uint,uint> non_term;
+    typedef std::tuple<len_t,len_t,len_t> non_term;
     typedef std::vector<non_term> non_terminal_symbols;
-    typedef std::vector<std::pair<uint,uint>> rules;
+    typedef std::vector<std::pair<len_t,len_t>> rules;
 
+    typedef CompactSuffixTree cst_t;
+    using node_type = typename cst_t::node_type;
 
-    SuffixTree stree;
-    uint min_lrf;
+    cst_t stree;
+    len_t min_lrf;
 
     BitVector dead_positions;
 
-    std::vector<std::vector<SuffixTree::STNode*> > bins;
+    std::vector<std::vector<node_type> > bins;
 
-        std::unordered_map<SuffixTree::STNode *, std::vector<uint> > beginning_positions;
+    NodeBegins beginning_positions;
 
     //stats
-    uint node_count;
-    uint max_depth;
-
-
-
-
-    inline virtual void compute_string_depth(SuffixTree::STNode* node, uint str_depth){
-        //resize if str depth grater than bins size
-
-
+    size_t max_depth;
 
 
 
-        SuffixTree::STInnerNode * inner = dynamic_cast<SuffixTree::STInnerNode *>(node);
-        if(inner){
 
-            inner->string_depth = str_depth;
-
-            if(str_depth>= bins.size()){
-                bins.resize(bins.size()*2);
-
-                std::cerr<<"resizing: "<<bins.size();
-            }
-
-            if(str_depth>max_depth){
-                max_depth=str_depth;
-            }
-            node_count++;
-            if(str_depth>0){
-
-                bins[str_depth].push_back(node);
-            }
 
+    inline virtual std::vector<len_t> select_starting_positions(node_type node, len_t length){
 
-            auto it = inner->child_nodes.begin();
-            while (it != inner->child_nodes.end()){
-                auto child = *it;
 
-                SuffixTree::STInnerNode * child_inner = dynamic_cast<SuffixTree::STInnerNode *>(child.second);
-                if(child_inner){
-                    child_inner->parent = inner;
-
-                    uint child_depth = (str_depth+stree.edge_length(child.second));
-                    compute_string_depth( child.second, child_depth);
-                }
-                it++;
-            }
-
-        }
-    }
-
-
-
-
-
-    inline virtual std::vector<uint> select_starting_positions(SuffixTree::STNode * node, uint length){
-
-
-        std::vector<uint> starting_positions = beginning_positions[node];
-        std::vector<uint> selected_starting_positions;
+        std::vector<len_t> selected_starting_positions;
 
         long min_shorter = 1;
 
         //select occurences greedily non-overlapping:
-        selected_starting_positions.reserve(starting_positions.size());
+        selected_starting_positions.reserve(beginning_positions.size(node));
 
         long last =  0- (long) length - 1;
         long current;
-        for (auto it=starting_positions.begin(); it!=starting_positions.end(); ++it){
+        for (size_t k = 0; k < beginning_positions.size(node); k++){
 
-            current = (long) *it;
-            if(last+length <= current && !dead_positions[current] && !dead_positions[current+length-1]){
+            current = (long) beginning_positions.at(node, k);
+            if(last + (long) length <= current && !dead_positions[current] && !dead_positions[current+length-1]){
 
                 selected_starting_positions.push_back(current);
                 last = current;
@@ -125,15 +79,13 @@ private:
 
         }
 
-        if(min_shorter < length){
+        if(min_shorter < (long) length){
 
-            if(min_shorter >= (int) min_lrf){
+            if(min_shorter >= (long) min_lrf){
                 //check if parent node is shorter
-                SuffixTree::STInnerNode * inner = dynamic_cast<SuffixTree::STInnerNode *>(node);
-
-                SuffixTree::STInnerNode * parent = inner->parent;
-                uint depth = parent->string_depth;
-                if(depth < (uint)(min_shorter)){
+                node_type parent = stree.parent(node);
+                len_t depth = stree.str_depth(parent);
+                if(depth < (len_t)(min_shorter)){
 
                     //just re-add node, if the possible replaceable lrf is longer than dpeth of parent node
                     bins[min_shorter].push_back(node);
@@ -152,6 +104,8 @@ public:
     inline static Meta meta() {
         Meta m("lfs_comp", "st");
         m.option("min_lrf").dynamic(2);
+        m.option("textds").templated<text_t, TextDS<>>("textds");
+        m.uses_textds<text_t>(text_t::SA | text_t::LCP);
         return m;
     }
 
@@ -160,107 +114,78 @@ public:
         min_lrf = env().option("min_lrf").as_integer();
 
         StatPhase::wrap("Constructing ST", [&]{
-            stree = SuffixTree(input);
+            // the suffix and LCP arrays are discarded with the text ds,
+            // only a copy of the suffix array is kept for the node begins
+            text_t t(env().env_for_option("textds"), input, text_t::SA | text_t::LCP);
+            stree = cst_t(t.require_sa(), t.require_lcp());
+            beginning_positions = NodeBegins(stree, t.require_sa());
+
+            StatPhase::log("size", stree.size_in_bytes() + beginning_positions.size_in_bytes());
         });
 
 
         StatPhase::wrap("Computing String Depth", [&]{
-            bins.resize(200);
-            node_count=0;
             max_depth=0;
-            compute_string_depth(stree.get_root(),0);
+            for(node_type node = 0; node < stree.internal_nodes(); node++){
+                max_depth = std::max(max_depth, stree.str_depth(node));
+            }
+            bins.resize(max_depth + 1);
+
+            for(node_type node = 0; node < stree.internal_nodes(); node++){
+                if(stree.str_depth(node) > 0){
+                    bins[stree.str_depth(node)].push_back(node);
+                }
+            }
         });
 
-        StatPhase::log("Number of inner Nodes", node_count);
+        StatPhase::log("Number of inner Nodes", stree.internal_nodes());
         StatPhase::log("Max Depth inner Nodes", max_depth);
         DLOG(INFO)<<"max depth: "<<max_depth;
 
 
 
         StatPhase::wrap("Computing LRF Substitution", [&]{
-            dead_positions = BitVector(stree.get_size(), 0);
-            uint nts_number =0;
-
-            beginning_positions.reserve(node_count);
+            dead_positions = BitVector(stree.size(), 0);
+            len_t nts_number =0;
 
-            uint rd_counter =0;
+            size_t rd_counter =0;
 
 
 
-            for(uint i = bins.size()-1; i>=min_lrf; i--){
+            for(len_t i = bins.size()-1; i>=min_lrf; i--){
                 auto bin_it = bins[i].begin();
                 while (bin_it!= bins[i].end()){
 
-                    SuffixTree::STNode * node = *bin_it;
-
-                    auto bp = beginning_positions.find(node);
+                    node_type node = *bin_it;
 
                     //no begin poss found, get from children
 
-                    if(bp == beginning_positions.end()){
-
-                        std::vector<uint> positions;
+                    if(!beginning_positions.computed(node)){
 
-                        SuffixTree::STInnerNode * inner = dynamic_cast<SuffixTree::STInnerNode *>(node);
-                        auto it = inner->child_nodes.begin();
-                        while (it != inner->child_nodes.end()){
-                            auto child = *it;
-
-                            SuffixTree::STNode * child_node = child.second;
-
-                            if(SuffixTree::STInnerNode * inner_child = dynamic_cast<SuffixTree::STInnerNode *>(child_node)){
-                                auto child_bp = beginning_positions.find(inner_child);
-                                if(child_bp != beginning_positions.end()){
-
-                                    positions.insert(positions.end(), (*child_bp).second.begin(), (*child_bp).second.end());
-
-                                    beginning_positions.erase((*child_bp).first);
-
-
-                                }
+                        beginning_positions.compute(node, [](len_t){ return true; });
 
-
-                            }
-                            if(SuffixTree::STLeaf * leaf_child = dynamic_cast<SuffixTree::STLeaf *>(child_node)){
-                                positions.push_back(leaf_child->suffix);
-
-                            }
-
-
-
-
-                            it++;
-                        }
-                        std::sort(positions.begin(), positions.end());
-
-                        uint real_depth = positions.back() - positions.front();
+                        len_t real_depth = beginning_positions.back(node) - beginning_positions.front(node);
 
                         if(real_depth<i){
                             rd_counter++;
                         }
 
-                        beginning_positions[node]=positions;
-
-
-
-
                     }
-                    std::vector<uint> & begin_pos = beginning_positions[node];
 
                     //check if repeating factor:
-                    if(begin_pos.size() >= 2 && ( (begin_pos.back() ) - (begin_pos.front()) >= i)){
+                    if(beginning_positions.size(node) >= 2 && ( (beginning_positions.back(node)) - (beginning_positions.front(node)) >= i)){
 
                         //check dead positions:
                         if(!(
-                                dead_positions[(begin_pos.back())]              ||
-                                dead_positions[(begin_pos.front())]
+                                dead_positions[(beginning_positions.back(node))]              ||
+                                dead_positions[(beginning_positions.front(node))]
                                 )
 
 
                                 ){
 
 
-                            std::vector<uint> sel_pos = select_starting_positions(node, i);
+                            std::vector<len_t> sel_pos = select_starting_positions(node, i);
 
 
 
@@ -271,7 +196,7 @@ public:
                                 continue;
                             }
                             //vector of text position, length
-                            std::pair<uint,uint> rule = std::make_pair(sel_pos.at(0), i);
+                            std::pair<len_t,len_t> rule = std::make_pair(sel_pos.at(0), i);
                             dictionary.push_back(rule);
 
                         //iterate over selected pos, add non terminal symbols
@@ -279,7 +204,7 @@ public:
                                 non_term nts = std::make_tuple(*bp_it, nts_number, i);
                                 nts_symbols.push_back(nts);
                                 //mark as used
-                                for(uint pos = 0; pos<i;pos++){
+                                for(len_t pos = 0; pos<i;pos++){
                                     dead_positions[pos+ *bp_it] = 1;
                                 }
                             }
@@ -21,6 +21,16 @@ class BinaryTrie : public Algorithm, public LZ78Trie<> {
         size_t m_resizes = 0;
         size_t m_specialresizes = 0;
     )
+
+    inline void grow() {
+        const size_t newbound = expected_capacity(size());
+        m_first_child.reserve   (newbound);
+        m_next_sibling.reserve  (newbound);
+        m_literal.reserve       (newbound);
+        IF_STATS(++m_resizes);
+        // the estimate needs less space than doubling the size
+        IF_STATS(if(newbound < size()*2) ++m_specialresizes);
+    }
 public:
     inline static Meta meta() {
         Meta m("lz78trie", "binary", "Lempel-Ziv 78 Binary Trie");
@@ -54,6 +64,7 @@ public:
 
     inline node_t add_rootnode(uliteral_t c) {
         DCHECK_EQ(c, size());
+        if(m_first_child.capacity() == m_first_child.size()) grow();
         m_first_child.push_back(undef_id);
         m_next_sibling.push_back(undef_id);
         m_literal.push_back(c);
@@ -90,16 +101,8 @@ public:
                 node = m_next_sibling[node];
             }
         }
-        if(m_first_child.capacity() == m_first_child.size()) {
-            const size_t newbound =    m_first_child.size()+expected_number_of_remaining_elements(size());
-            if(newbound < m_first_child.size()*2 ) {
-                m_first_child.reserve   (newbound);
-                m_next_sibling.reserve  (newbound);
-                m_literal.reserve       (newbound);
-                IF_STATS(++m_specialresizes);
-            }
-            IF_STATS(++m_resizes);
-        }
+        // grow to the expected number of nodes instead of doubling the size
+        if(m_first_child.capacity() == m_first_child.size()) grow();
         m_first_child.push_back(undef_id);
         m_next_sibling.push_back(undef_id);
         m_literal.push_back(c);
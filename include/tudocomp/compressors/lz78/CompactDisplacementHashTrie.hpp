@@ -0,0 +1,98 @@
+#pragma once
+
+#include <tudocomp/Algorithm.hpp>
+#include <tudocomp/compressors/lz78/LZ78Trie.hpp>
+#include <tudocomp/compressors/lz78/squeeze_node.hpp>
+#include <tudocomp/util/compact_displacement_hash.hpp>
+
+#include <tudocomp_stat/StatPhase.hpp>
+
+namespace tdc {
+namespace lz78 {
+
+/// \brief LZ78 Trie backed by a \ref compact_displacement_hash.
+///
+/// Both the quotients of the keys and the factor ids are stored bit-packed.
+/// The width of the factor ids grows with the size of the dictionary.
+class CompactDisplacementHashTrie : public Algorithm, public LZ78Trie<> {
+    compact_displacement_hash m_table;
+    size_t m_key_width = 0;
+
+    inline size_t key_width(uint64_t key) {
+        m_key_width = std::max(m_key_width, size_t(bits_for(key)));
+        return m_key_width;
+    }
+
+public:
+    inline static Meta meta() {
+        Meta m("lz78trie", "compact_displacement_hash", "Compact Displacement Hash Trie");
+        m.option("load_factor").dynamic(75);
+        return m;
+    }
+
+    inline CompactDisplacementHashTrie(Env&& env, const size_t n, const size_t& remaining_characters, factorid_t reserve = 0)
+        : Algorithm(std::move(env))
+        , LZ78Trie(n,remaining_characters)
+        , m_table(zero_or_next_power_of_two(reserve), 0)
+    {
+        const size_t load_factor = this->env().option("load_factor").as_integer();
+        CHECK(load_factor > 0 && load_factor < 100) << "load_factor has to be in (0,100)";
+        m_table.max_load_factor(load_factor/100.0f);
+    }
+
+    IF_STATS(
+        MoveGuard m_guard;
+        inline ~CompactDisplacementHashTrie() {
+            if (m_guard) {
+                StatPhase::log("table size", m_table.table_size());
+                StatPhase::log("entries", m_table.size());
+                StatPhase::log("value width", m_table.value_width());
+            }
+        }
+    )
+    CompactDisplacementHashTrie(CompactDisplacementHashTrie&& other) = default;
+    CompactDisplacementHashTrie& operator=(CompactDisplacementHashTrie&& other) = default;
+
+    inline node_t add_rootnode(uliteral_t c) {
+        auto key = create_node(0, c);
+        auto value = size();
+
+        m_table.index(key, key_width(key), bits_for(value)) = value;
+        return node_t(value, true);
+    }
+
+    inline node_t get_rootnode(uliteral_t c) const {
+        return node_t(c, false);
+    }
+
+    inline void clear() {
+    }
+
+    inline node_t find_or_insert(const node_t& parent_w, uliteral_t c) {
+        auto parent = parent_w.id();
+
+        // if we add a new node, its index will be equal to the current size of the dictionary
+        const factorid_t newleaf_id = size();
+
+        // Use 0 as special value for map lookup
+        // if val == 0, then it got default constructed, which means
+        // it is new
+        DCHECK_NE(newleaf_id, 0);
+
+        auto key = create_node(parent,c);
+        auto val = m_table.index(key, key_width(key), bits_for(newleaf_id));
+        if (val == 0u) {
+            val = newleaf_id;
+            DCHECK_EQ(val, newleaf_id);
+            return node_t(newleaf_id, true);
+        } else {
+            return node_t(uint64_t(val), false);
+        }
+    }
+
+    inline size_t size() const {
+        return m_table.size();
+    }
+};
+
+}} //ns
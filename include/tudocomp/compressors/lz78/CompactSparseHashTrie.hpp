@@ -25,6 +25,7 @@ public:
     inline static Meta meta() {
         Meta m("lz78trie", "compact_sparse_hash", "Compact Sparse Hash Trie");
         //m.option("load_factor").dynamic(30);
+        m.option("incremental_growth").dynamic(false);
         return m;
     }
 
@@ -34,6 +35,14 @@ public:
         , m_table(zero_or_next_power_of_two(reserve), 0)
     {
         //m_table.max_load_factor(this->env().option("load_factor").as_integer()/100.0f );
+        if (this->env().option("incremental_growth").as_bool()) {
+            m_table.incremental_growth(true);
+
+            // A growing key width would force a full rebuild of the table,
+            // so we fix it to the width of the largest possible key.
+            // The node ids are bounded by n plus the number of root nodes.
+            m_key_width = bits_for(n + ULITERAL_MAX + 1) + 8 * sizeof(uliteral_t);
+        }
     }
 
     IF_STATS(
@@ -0,0 +1,235 @@
+#pragma once
+
+#include <vector>
+#include <tudocomp/Algorithm.hpp>
+#include <tudocomp/util/Hash.hpp>
+#include <tudocomp/compressors/lz78/LZ78Trie.hpp>
+#include <tudocomp/compressors/lz78/squeeze_node.hpp>
+#include <tudocomp_stat/StatPhase.hpp>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace tdc {
+namespace lz78 {
+
+/// \brief LZ78 Trie backed by an open addressing hash table whose slots
+/// are probed in groups of 16.
+///
+/// Each slot stores the key (parent id, edge label) inline next to the
+/// child's id, so a successful lookup touches a single slot.
+/// Next to the slots, the table keeps one control byte per slot that is
+/// either empty or holds 7 bits of the key's hash value.
+/// A lookup compares all 16 control bytes of a group at once
+/// (with SSE2 if available) and only inspects the slots whose control byte
+/// matches. While a group is examined, the next group of the probe sequence
+/// is prefetched.
+///
+/// Since LZ78 tries never delete single nodes, no tombstones are needed.
+template<class HashFunction = VignaHasher>
+class GroupHashTrie : public Algorithm, public LZ78Trie<> {
+    static constexpr size_t GROUP_SIZE = 16;
+    static constexpr uint8_t EMPTY = 0x80;
+
+    struct Slot {
+        factorid_t parent;
+        factorid_t id;
+        uliteral_t c;
+    };
+
+    HashFunction m_hash;
+    std::vector<uint8_t> m_ctrl;
+    std::vector<Slot> m_slots;
+    size_t m_group_mask = 0;
+    size_t m_entries = 0;
+    size_t m_max_entries = 0;
+    float m_load_factor;
+
+    IF_STATS(
+        size_t m_resizes = 0;
+        size_t m_probes = 0;
+    )
+
+    /// Bit mask of the slots in the group starting at `ctrl` whose control
+    /// byte equals `h2`.
+    inline static uint32_t match(const uint8_t* ctrl, uint8_t h2) {
+#ifdef __SSE2__
+        const __m128i group = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl));
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(h2)));
+#else
+        uint32_t mask = 0;
+        for(size_t j = 0; j < GROUP_SIZE; ++j) {
+            mask |= uint32_t(ctrl[j] == h2) << j;
+        }
+        return mask;
+#endif
+    }
+
+    /// Bit mask of the empty slots in the group starting at `ctrl`.
+    /// Only empty slots have the most significant bit set.
+    inline static uint32_t match_empty(const uint8_t* ctrl) {
+#ifdef __SSE2__
+        return _mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl)));
+#else
+        uint32_t mask = 0;
+        for(size_t j = 0; j < GROUP_SIZE; ++j) {
+            mask |= uint32_t(ctrl[j] >> 7) << j;
+        }
+        return mask;
+#endif
+    }
+
+    inline size_t hash(factorid_t parent, uliteral_t c) {
+        return m_hash(static_cast<uint64_t>(create_node(parent, c)));
+    }
+
+    inline size_t table_size() const {
+        return m_ctrl.size();
+    }
+
+    inline void allocate(size_t groups) {
+        DCHECK_EQ(groups & (groups-1), 0U);
+        m_ctrl.assign(groups * GROUP_SIZE, uint8_t(EMPTY));
+        m_slots.resize(groups * GROUP_SIZE);
+        m_group_mask = groups - 1;
+        m_max_entries = table_size() * m_load_factor;
+    }
+
+    /// Stores a key that is known to be absent in the first empty slot of
+    /// its probe sequence. Does not check the load factor.
+    inline void place(const Slot& slot, size_t h) {
+        size_t group = (h >> 7) & m_group_mask;
+        for(size_t step = 1; ; ++step) {
+            const uint8_t* ctrl = m_ctrl.data() + group * GROUP_SIZE;
+            const uint32_t empty = match_empty(ctrl);
+            if(empty != 0) {
+                const size_t pos = group * GROUP_SIZE + __builtin_ctz(empty);
+                m_ctrl[pos] = h & 0x7F;
+                m_slots[pos] = slot;
+                return;
+            }
+            group = (group + step) & m_group_mask; // triangular probing visits every group
+        }
+    }
+
+    inline void grow() {
+        IF_STATS(++m_resizes);
+        // jump directly to the expected final size if it is known to be larger
+        const size_t expected_size =
+            (m_entries + 1 + expected_number_of_remaining_elements(m_entries)) / m_load_factor;
+        const size_t groups = std::max<size_t>(
+            (m_group_mask + 1) * 2,
+            zero_or_next_power_of_two(idiv_ceil(expected_size, GROUP_SIZE)));
+
+        std::vector<uint8_t> old_ctrl;
+        std::vector<Slot> old_slots;
+        std::swap(old_ctrl, m_ctrl);
+        std::swap(old_slots, m_slots);
+        allocate(groups);
+
+        for(size_t i = 0; i < old_ctrl.size(); ++i) {
+            if(old_ctrl[i] & EMPTY) continue;
+            const Slot& slot = old_slots[i];
+            place(slot, hash(slot.parent, slot.c));
+        }
+    }
+
+public:
+    inline static Meta meta() {
+        Meta m("lz78trie", "group_hash", "Hash Trie with group-wise probing");
+        m.option("hash_function").templated<HashFunction, VignaHasher>("hash_function");
+        m.option("load_factor").dynamic(87);
+        return m;
+    }
+
+    inline GroupHashTrie(Env&& env, const size_t n, const size_t& remaining_characters, factorid_t reserve = 0)
+        : Algorithm(std::move(env))
+        , LZ78Trie(n, remaining_characters)
+        , m_hash(this->env().env_for_option("hash_function"))
+        , m_load_factor(this->env().option("load_factor").as_integer()/100.0f)
+    {
+        CHECK(m_load_factor > 0 && m_load_factor < 1) << "load_factor has to be in (0,100)";
+        const size_t groups = idiv_ceil(size_t(reserve / m_load_factor) + 1, GROUP_SIZE);
+        allocate(std::max<size_t>(zero_or_next_power_of_two(groups), 1));
+    }
+
+    IF_STATS(
+        MoveGuard m_guard;
+        inline ~GroupHashTrie() {
+            if (m_guard) {
+                StatPhase::log("table size", table_size());
+                StatPhase::log("load factor", m_load_factor);
+                StatPhase::log("entries", m_entries);
+                StatPhase::log("resizes", m_resizes);
+                StatPhase::log("probes", m_probes);
+                StatPhase::log("load ratio", m_entries*100/table_size());
+            }
+        }
+    )
+    GroupHashTrie(GroupHashTrie&& other) = default;
+    GroupHashTrie& operator=(GroupHashTrie&& other) = default;
+
+    inline node_t add_rootnode(uliteral_t c) {
+        const factorid_t id = size();
+        if(tdc_unlikely(m_entries >= m_max_entries)) grow();
+        place(Slot { 0, id, c }, hash(0, c));
+        ++m_entries;
+        return node_t(id, true);
+    }
+
+    inline node_t get_rootnode(uliteral_t c) const {
+        return node_t(c, false);
+    }
+
+    inline void clear() {
+        std::fill(m_ctrl.begin(), m_ctrl.end(), uint8_t(EMPTY));
+        m_entries = 0;
+    }
+
+    inline node_t find_or_insert(const node_t& parent_w, uliteral_t c) {
+        const factorid_t parent = parent_w.id();
+        const size_t h = hash(parent, c);
+        const uint8_t h2 = h & 0x7F;
+
+        size_t group = (h >> 7) & m_group_mask;
+        for(size_t step = 1; ; ++step) {
+            const size_t next_group = (group + step) & m_group_mask;
+            __builtin_prefetch(m_ctrl.data() + next_group * GROUP_SIZE);
+            __builtin_prefetch(m_slots.data() + next_group * GROUP_SIZE);
+
+            const uint8_t* ctrl = m_ctrl.data() + group * GROUP_SIZE;
+            const Slot* slots = m_slots.data() + group * GROUP_SIZE;
+            for(uint32_t candidates = match(ctrl, h2); candidates != 0; candidates &= candidates - 1) {
+                const Slot& slot = slots[__builtin_ctz(candidates)];
+                if(slot.parent == parent && slot.c == c) {
+                    return node_t(slot.id, false);
+                }
+            }
+            const uint32_t empty = match_empty(ctrl);
+            if(empty != 0) {
+                //! if we add a new node, its index will be equal to the current size of the dictionary
+                const factorid_t newleaf_id = size();
+                if(tdc_unlikely(m_entries >= m_max_entries)) {
+                    grow();
+                    place(Slot { parent, newleaf_id, c }, h);
+                } else {
+                    const size_t pos = group * GROUP_SIZE + __builtin_ctz(empty);
+                    m_ctrl[pos] = h2;
+                    m_slots[pos] = Slot { parent, newleaf_id, c };
+                }
+                ++m_entries;
+                return node_t(newleaf_id, true);
+            }
+            IF_STATS(++m_probes);
+            group = next_group;
+        }
+    }
+
+    inline size_t size() const {
+        return m_entries;
+    }
+};
+
+}} //ns
+
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <limits>
 #include <cstddef>
 #include <cstdint>
@@ -52,6 +53,15 @@ protected:
         return lz78_expected_number_of_remaining_elements(z, m_n, m_remaining_characters);
     }
 
+    /// Capacity for an array of `z` nodes that is full.
+    ///
+    /// The array is grown to the expected final number of nodes,
+    /// but at least by a quarter and at most to twice its size.
+    inline size_t expected_capacity(const size_t z) const {
+        const size_t expected = z + expected_number_of_remaining_elements(z);
+        return std::min(std::max(expected, z + z/4 + 1), 2*z + 1);
+    }
+
     /**
      * The dictionary can store multiple root nodes
      * For LZ78, we use a root node with the id = c = 0.
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include <tudocomp/io.hpp>
+#include <tudocomp/io/ViewStream.hpp>
+#include <tudocomp/util/parallel_for.hpp>
+#include <tudocomp/util/vbyte.hpp>
+
+namespace tdc {
+namespace lz78 {
+
+#define LZ78_THREADS_DESC \
+            "If `threads` is larger than 1, the input is split into that many\n" \
+            "chunks that are factorized and decoded independently in parallel.\n" \
+            "All chunks but the first one seed their dictionary by parsing the\n" \
+            "first `seed` characters of the input beforehand."
+
+/// Returns the boundaries of `parts` consecutive chunks of about equal size
+/// that cover a text of length `n`. Chunk `i` is `[bounds[i], bounds[i+1])`.
+inline std::vector<size_t> partition(size_t n, size_t parts) {
+    DCHECK_GT(parts, 0U);
+    std::vector<size_t> bounds(parts + 1);
+    for(size_t i = 0; i <= parts; ++i) {
+        bounds[i] = i * (n / parts) + std::min(i, n % parts);
+    }
+    return bounds;
+}
+
+/// Writes independently encoded chunks to the output.
+///
+/// The chunks are preceded by their count, the length of the seed and
+/// their sizes in bytes, all stored as vbytes.
+inline void write_chunks(Output& output, size_t seed_length,
+                         const std::vector<std::vector<uint8_t>>& chunks) {
+    auto os = output.as_stream();
+    write_vbyte(os, chunks.size());
+    write_vbyte(os, seed_length);
+    for(const auto& chunk : chunks) write_vbyte(os, chunk.size());
+    for(const auto& chunk : chunks) {
+        os.write((const char*) chunk.data(), chunk.size());
+    }
+}
+
+/// The chunks of an input written by \ref write_chunks.
+struct Chunks {
+    size_t seed_length;
+    std::vector<View> chunks;
+};
+
+/// Splits the output of \ref write_chunks into its chunks.
+/// The chunks refer to the memory of `in`.
+inline Chunks read_chunks(View in) {
+    io::ViewStream vs(in);
+    std::istream& is = vs.stream();
+
+    const size_t count = read_vbyte<size_t>(is);
+    Chunks ret { read_vbyte<size_t>(is), {} };
+    std::vector<size_t> sizes(count);
+    for(auto& size : sizes) size = read_vbyte<size_t>(is);
+
+    size_t offset = in.size() - is.rdbuf()->in_avail();
+    ret.chunks.reserve(count);
+    for(const size_t size : sizes) {
+        CHECK_LE(offset + size, in.size()) << "corrupted compressed file";
+        ret.chunks.push_back(in.substr(offset, size));
+        offset += size;
+    }
+    return ret;
+}
+
+}} //ns
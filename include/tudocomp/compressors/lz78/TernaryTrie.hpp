@@ -18,11 +18,32 @@ class TernaryTrie : public Algorithm, public LZ78Trie<> {
     /*
      * The trie is not stored in standard form. Each node stores the pointer to its first child (first as first come first served).
      * The other children are stored in left_sibling/right_sibling of the first child (structured as a binary tree where the first child is the root, and the binary tree is sorted by the character of the trie edge)
+     *
+     * All fields of a node are stored next to each other,
+     * such that a step in the binary tree touches a single cache line.
      */
-    std::vector<factorid_t> first_child;
-    std::vector<factorid_t> left_sibling;
-    std::vector<factorid_t> right_sibling;
-    std::vector<uliteral_t> literal;
+    struct Node {
+        factorid_t first_child;
+        factorid_t left_sibling;
+        factorid_t right_sibling;
+        uliteral_t literal;
+    };
+    std::vector<Node> m_nodes;
+
+    IF_STATS(
+        size_t m_resizes = 0;
+        size_t m_specialresizes = 0;
+        // nodes visited in the sibling trees, each one touching a single cache line
+        size_t m_steps = 0;
+    )
+
+    inline void grow() {
+        const size_t newbound = expected_capacity(m_nodes.size());
+        m_nodes.reserve(newbound);
+        IF_STATS(++m_resizes);
+        // the estimate needs less space than doubling the size
+        IF_STATS(if(newbound < m_nodes.size()*2) ++m_specialresizes);
+    }
 
 public:
     inline static Meta meta() {
@@ -36,26 +57,19 @@ public:
         , LZ78Trie(n, remaining_characters)
     {
         if(reserve > 0) {
-            first_child.reserve(reserve);
-            left_sibling.reserve(reserve);
-            right_sibling.reserve(reserve);
-            literal.reserve(reserve);
+            m_nodes.reserve(reserve);
         }
     }
 
-    IF_STATS(
-        size_t m_resizes = 0;
-        size_t m_specialresizes = 0;
-        )
-
     IF_STATS(
         MoveGuard m_guard;
         inline ~TernaryTrie() {
             if (m_guard) {
                 StatPhase::log("resizes", m_resizes);
                 StatPhase::log("special resizes", m_specialresizes);
-                StatPhase::log("table size", first_child.capacity());
-                StatPhase::log("load ratio", first_child.size()*100/first_child.capacity());
+                StatPhase::log("tree steps", m_steps);
+                StatPhase::log("table size", m_nodes.capacity());
+                StatPhase::log("load ratio", m_nodes.size()*100/m_nodes.capacity());
             }
         }
     )
@@ -64,10 +78,8 @@ public:
 
     inline node_t add_rootnode(uliteral_t c) {
         DCHECK_EQ(c, size());
-        first_child.push_back(undef_id);
-        left_sibling.push_back(undef_id);
-        right_sibling.push_back(undef_id);
-        literal.push_back(c);
+        if(m_nodes.capacity() == m_nodes.size()) grow();
+        m_nodes.push_back(Node { undef_id, undef_id, undef_id, c });
         return node_t(c, true);
     }
 
@@ -76,10 +88,7 @@ public:
     }
 
     inline void clear() {
-        first_child.clear();
-        left_sibling.clear();
-        right_sibling.clear();
-        literal.clear();
+        m_nodes.clear();
     }
 
     inline node_t find_or_insert(const node_t& parent_w, uliteral_t c) {
@@ -90,53 +99,42 @@ public:
         DCHECK_LT(parent, size());
 
 
-        if(first_child[parent] == undef_id) {
-            first_child[parent] = newleaf_id;
+        if(m_nodes[parent].first_child == undef_id) {
+            m_nodes[parent].first_child = newleaf_id;
         } else {
-            factorid_t node = first_child[parent];
+            factorid_t node = m_nodes[parent].first_child;
             while(true) { // search the binary tree stored in parent (following left/right siblings)
-                if(c < literal[node]) {
-                    if (left_sibling[node] == undef_id) {
-                        left_sibling[node] = newleaf_id;
+                Node& n = m_nodes[node];
+                IF_STATS(++m_steps);
+                if(c < n.literal) {
+                    if (n.left_sibling == undef_id) {
+                        n.left_sibling = newleaf_id;
                         break;
                     }
                     else
-                        node = left_sibling[node];
+                        node = n.left_sibling;
                 }
-                else if (c > literal[node]) {
-                    if (right_sibling[node] == undef_id) {
-                        right_sibling[node] = newleaf_id;
+                else if (c > n.literal) {
+                    if (n.right_sibling == undef_id) {
+                        n.right_sibling = newleaf_id;
                         break;
                     }
                     else
-                        node = right_sibling[node];
+                        node = n.right_sibling;
                 }
                 else /* c == literal[node] -> node is the node we want to find */ {
                     return node_t(node, false);
                 }
             }
         }
-        // do not double the size if we only need fewer space
-        if(first_child.capacity() == first_child.size()) {
-            const size_t newbound =    first_child.size()+expected_number_of_remaining_elements(size());
-            if(newbound < first_child.size()*2 ) {
-                first_child.reserve   (newbound);
-                left_sibling.reserve  (newbound);
-                right_sibling.reserve (newbound);
-                literal.reserve       (newbound);
-                IF_STATS(++m_specialresizes);
-            }
-            IF_STATS(++m_resizes);
-        }
-        first_child.push_back(undef_id);
-        left_sibling.push_back(undef_id);
-        right_sibling.push_back(undef_id);
-        literal.push_back(c);
+        // grow to the expected number of nodes instead of doubling the size
+        if(m_nodes.capacity() == m_nodes.size()) grow();
+        m_nodes.push_back(Node { undef_id, undef_id, undef_id, c });
         return node_t(size() - 1, true);
     }
 
     inline size_t size() const {
-        return first_child.size();
+        return m_nodes.size();
     }
 };
 
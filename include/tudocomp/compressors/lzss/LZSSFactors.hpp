@@ -1,6 +1,7 @@
 #pragma once
 
 #include <algorithm>
+#include <iterator>
 #include <vector>
 #include <tudocomp/def.hpp>
 
@@ -20,77 +21,218 @@ public:
 }  __attribute__((__packed__));
 
 
+/// Stores factors with bit-packed fields.
+///
+/// The width of each field is the width of its largest value so far,
+/// that is, at most `bits_for(n)` for a text of length `n`.
 class FactorBuffer {
 private:
-    std::vector<Factor> m_factors;
+    DynamicIntVector m_pos;
+    DynamicIntVector m_src;
+    DynamicIntVector m_len;
     bool m_sorted; //! factors need to be sorted before they are output
 
     len_t m_shortest_factor;
     len_t m_longest_factor;
 
+    /// Buckets up to this size are sorted by insertion sort.
+    static constexpr size_t SORT_INSERTION_THRESHOLD = 32;
+
+    /// Maximum number of bits of a position that are sorted in one pass.
+    static constexpr size_t SORT_MAX_RADIX_BITS = 12;
+
+    inline static void widen(DynamicIntVector& v, len_t x) {
+        const uint8_t w = bits_for(x);
+        if(w > v.width()) v.width(w);
+    }
+
+    inline void swap_factors(size_t i, size_t j) {
+        const len_t pos = m_pos[i], src = m_src[i], len = m_len[i];
+        m_pos[i] = len_t(m_pos[j]); m_src[i] = len_t(m_src[j]); m_len[i] = len_t(m_len[j]);
+        m_pos[j] = pos; m_src[j] = src; m_len[j] = len;
+    }
+
+    inline void insertion_sort(size_t l, size_t r) {
+        for(size_t i = l + 1; i < r; ++i) {
+            for(size_t j = i; j > l && m_pos[j-1] > m_pos[j]; --j) {
+                swap_factors(j-1, j);
+            }
+        }
+    }
+
+    /// In-place MSD radix sort (American flag sort) of the factors in
+    /// `[l, r)` by the lowest `bits` bits of their positions.
+    /// Positions are distinct, so stability is not required.
+    inline void radix_sort(size_t l, size_t r, size_t bits) {
+        if(r - l <= SORT_INSERTION_THRESHOLD) {
+            insertion_sort(l, r);
+            return;
+        }
+
+        // choose the number of buckets depending on the number of factors
+        const size_t radix_bits = std::min(bits,
+            std::min(SORT_MAX_RADIX_BITS, size_t(bits_for(r - l))));
+        const size_t radix = 1ULL << radix_bits;
+        const size_t shift = bits - radix_bits;
+        const size_t mask = radix - 1;
+
+        std::vector<size_t> head(radix, 0);
+        for(size_t i = l; i < r; ++i) ++head[(len_t(m_pos[i]) >> shift) & mask];
+
+        std::vector<size_t> tail(radix);
+        for(size_t b = 0, sum = l; b < radix; ++b) {
+            const size_t count = head[b];
+            head[b] = sum;
+            sum += count;
+            tail[b] = sum;
+        }
+
+        // move each factor directly into its bucket, following the cycles
+        // of the permutation to write every factor only once
+        for(size_t b = 0; b < radix; ++b) {
+            while(head[b] < tail[b]) {
+                len_t pos = m_pos[head[b]];
+                size_t d = (pos >> shift) & mask;
+                if(d == b) {
+                    ++head[b];
+                    continue;
+                }
+                len_t src = m_src[head[b]];
+                len_t len = m_len[head[b]];
+                do {
+                    const size_t j = head[d]++;
+                    const len_t next_pos = m_pos[j];
+                    const len_t next_src = m_src[j];
+                    const len_t next_len = m_len[j];
+                    m_pos[j] = pos; m_src[j] = src; m_len[j] = len;
+                    pos = next_pos; src = next_src; len = next_len;
+                    d = (pos >> shift) & mask;
+                } while(d != b);
+                const size_t j = head[b]++;
+                m_pos[j] = pos; m_src[j] = src; m_len[j] = len;
+            }
+        }
+
+        if(shift == 0) return;
+        for(size_t b = 0, begin = l; b < radix; ++b) {
+            if(tail[b] - begin > 1) radix_sort(begin, tail[b], shift);
+            begin = tail[b];
+        }
+    }
+
 public:
-    using const_iterator = std::vector<Factor>::const_iterator;
+    class const_iterator {
+        const FactorBuffer* m_buffer;
+        size_t m_i;
+
+        struct arrow_proxy {
+            Factor factor;
+            inline const Factor* operator->() const { return &factor; }
+        };
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = Factor;
+        using difference_type = std::ptrdiff_t;
+        using pointer = arrow_proxy;
+        using reference = Factor;
+
+        inline const_iterator(const FactorBuffer* buffer, size_t i)
+            : m_buffer(buffer), m_i(i) {}
+
+        inline Factor operator*() const { return (*m_buffer)[m_i]; }
+        inline arrow_proxy operator->() const { return arrow_proxy { **this }; }
+        inline Factor operator[](difference_type d) const { return *(*this + d); }
+
+        inline const_iterator& operator++() { ++m_i; return *this; }
+        inline const_iterator& operator--() { --m_i; return *this; }
+        inline const_iterator operator++(int) { auto r = *this; ++m_i; return r; }
+        inline const_iterator operator--(int) { auto r = *this; --m_i; return r; }
+        inline const_iterator& operator+=(difference_type d) { m_i += d; return *this; }
+        inline const_iterator& operator-=(difference_type d) { m_i -= d; return *this; }
+        inline const_iterator operator+(difference_type d) const { return const_iterator(m_buffer, m_i + d); }
+        inline const_iterator operator-(difference_type d) const { return const_iterator(m_buffer, m_i - d); }
+        inline difference_type operator-(const const_iterator& other) const { return difference_type(m_i) - difference_type(other.m_i); }
+
+        inline bool operator==(const const_iterator& other) const { return m_i == other.m_i; }
+        inline bool operator!=(const const_iterator& other) const { return m_i != other.m_i; }
+        inline bool operator<(const const_iterator& other) const { return m_i < other.m_i; }
+        inline bool operator>(const const_iterator& other) const { return m_i > other.m_i; }
+        inline bool operator<=(const const_iterator& other) const { return m_i <= other.m_i; }
+        inline bool operator>=(const const_iterator& other) const { return m_i >= other.m_i; }
+    };
 
     inline FactorBuffer()
-        : m_sorted(true)
+        : m_pos(0, 0, 1)
+        , m_src(0, 0, 1)
+        , m_len(0, 0, 1)
+        , m_sorted(true)
         , m_shortest_factor(INDEX_MAX)
         , m_longest_factor(0)
     {
     }
 
     inline void emplace_back(len_t fpos, len_t fsrc, len_t flen) {
-        m_sorted = m_sorted && (m_factors.empty() || fpos >= m_factors.back().pos);
-        m_factors.emplace_back(fpos, fsrc, flen);
+        m_sorted = m_sorted && (m_pos.empty() || fpos >= len_t(m_pos.back()));
+
+        widen(m_pos, fpos);
+        widen(m_src, fsrc);
+        widen(m_len, flen);
+        m_pos.push_back(fpos);
+        m_src.push_back(fsrc);
+        m_len.push_back(flen);
 
         m_shortest_factor = std::min(m_shortest_factor, flen);
         m_longest_factor = std::max(m_longest_factor, flen);
     }
 
+    inline Factor operator[](size_t i) const {
+        return Factor(m_pos[i], m_src[i], m_len[i]);
+    }
+
     inline const_iterator begin() const {
-        return m_factors.cbegin();
+        return const_iterator(this, 0);
     }
 
     inline const_iterator end() const {
-        return m_factors.cend();
+        return const_iterator(this, size());
     }
 
     inline bool empty() const {
-        return m_factors.empty();
+        return m_pos.empty();
     }
 
     inline size_t size() const {
-        return m_factors.size();
+        return m_pos.size();
     }
 
     inline bool is_sorted() const {
         return m_sorted;
     }
 
-    inline void sort() { //TODO: use radix sort
+    /// Sorts the factors by their positions in time linear in their number.
+    inline void sort() {
         if(!m_sorted) {
-            std::sort(m_factors.begin(), m_factors.end(),
-                [](const Factor& a, const Factor& b) -> bool { return a.pos < b.pos; });
-
+            radix_sort(0, size(), m_pos.width());
             m_sorted = true;
         }
     }
 
 public:
     inline void flatten() {
-        if(m_factors.empty()) return; //nothing to do
+        if(empty()) return; //nothing to do
 
         CHECK(m_sorted)
             << "factors need to be sorted before they can be flattened";
 
         // create pos -> factor map
-        auto& last = m_factors.back();
+        const Factor last = (*this)[size() - 1];
         DynamicIntVector fmap(
             last.pos + last.len,
             0,
-            bits_for(m_factors.size() + 1));
+            bits_for(size() + 1));
 
-        for(size_t i = 0; i < m_factors.size(); i++) {
-            auto& f = m_factors[i];
+        for(size_t i = 0; i < size(); i++) {
+            const Factor f = (*this)[i];
             for(size_t j = 0; j < f.len; j++) {
                 fmap[f.pos + j] = i + 1;
             }
@@ -99,12 +241,13 @@ public:
         // process factors
         size_t num_flattened = 0;
         size_t max_depth = 0;
-        for(auto& f : m_factors) {
+        for(size_t i = 0; i < size(); i++) {
+            const Factor f = (*this)[i];
             size_t depth = 0;
 
             size_t src = f.src;
             while(src < fmap.size() && fmap[src]) {
-                auto& s = m_factors[fmap[src] - 1];
+                const Factor s = (*this)[fmap[src] - 1];
 
                 size_t d = src - s.pos;
                 if((s.src + d + f.len) <= (s.src + s.len)) {
@@ -120,7 +263,8 @@ public:
             }
             
             if(depth) {
-                f.src = src;
+                widen(m_src, src);
+                m_src[i] = src;
 
                 ++num_flattened;
                 max_depth = std::max(max_depth, depth);
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <algorithm>
+
+#include <tudocomp/def.hpp>
+#include <tudocomp/util.hpp>
+#include <tudocomp/ds/IntVector.hpp>
+
+namespace tdc {
+namespace lzss {
+
+/// Previous and next smaller values of a suffix array, in text order.
+///
+/// For a text position `i`, `psv(i)` and `nsv(i)` are the text positions
+/// of the suffixes lexicographically preceding and succeeding suffix `i`
+/// that are closest to it in the suffix array among all suffixes starting
+/// before `i`, or `undef()` if there is no such suffix.
+/// The longest previous factor starting at `i` is the longer of the common
+/// prefixes of suffix `i` with these two suffixes.
+///
+/// Both arrays are computed in one scan of the suffix array with a stack of
+/// increasing text positions, which is stored implicitly in the PSV array
+/// (the element below `i` on the stack is `psv(i)`).
+/// They are bit-packed with `bits_for(n)` bits per entry.
+class PSVNSV {
+    len_t m_undef;
+    DynamicIntVector m_psv;
+    DynamicIntVector m_nsv;
+
+public:
+    template<typename sa_t>
+    inline PSVNSV(const sa_t& sa, len_t n)
+        : m_undef(n)
+        , m_psv(n, 0, bits_for(n))
+        , m_nsv(n, 0, bits_for(n))
+    {
+        len_t top = m_undef;
+        for(len_t j = 0; j < n; ++j) {
+            const len_t i = sa[j];
+            while(top != m_undef && top > i) {
+                m_nsv[top] = i;
+                top = m_psv[top];
+            }
+            m_psv[i] = top;
+            top = i;
+        }
+        while(top != m_undef) {
+            m_nsv[top] = m_undef;
+            top = m_psv[top];
+        }
+    }
+
+    inline len_t undef() const { return m_undef; }
+    inline len_t psv(len_t i) const { return m_psv[i]; }
+    inline len_t nsv(len_t i) const { return m_nsv[i]; }
+};
+
+/// Computes the greedy LZ77 factorization of `text[begin, ...)` with the
+/// longest previous factors found by \ref PSVNSV.
+///
+/// Factorization stops at the first factor or literal starting at or after
+/// `end`; factors may extend up to `text_length`.
+/// Calls `factor(pos, src, len)` for each factor of length at least
+/// `threshold` and `literal(pos)` for all other positions.
+///
+/// The number of character comparisons is linear in the length of the
+/// factorized text.
+///
+/// \return the position at which the factorization stopped.
+template<typename text_t, typename factor_f, typename literal_f>
+inline len_t factorize_greedy(const text_t& text, const len_t text_length,
+                              const PSVNSV& psvnsv,
+                              len_t begin, const len_t end, const len_t threshold,
+                              factor_f factor, literal_f literal) {
+
+    // the length of the common prefix of suffixes i and j < i
+    auto lce = [&](len_t i, len_t j) -> len_t {
+        if(j == psvnsv.undef()) return 0;
+        len_t l = 0;
+        while(i + l < text_length && text[i + l] == text[j + l]) ++l;
+        return l;
+    };
+
+    len_t i = begin;
+    while(i < end) {
+        const len_t psv_pos = psvnsv.psv(i);
+        const len_t nsv_pos = psvnsv.nsv(i);
+        const len_t psv_lcp = lce(i, psv_pos);
+        const len_t nsv_lcp = lce(i, nsv_pos);
+
+        //select maximum
+        const len_t max_lcp = std::max(psv_lcp, nsv_lcp);
+        if(max_lcp >= threshold && max_lcp > 0) {
+            const len_t max_pos = max_lcp == psv_lcp ? psv_pos : nsv_pos;
+            DCHECK_LT(max_pos, i);
+            factor(i, max_pos, max_lcp);
+            i += max_lcp; //advance
+        } else {
+            literal(i);
+            ++i; //advance
+        }
+    }
+    return i;
+}
+
+}} //ns
@@ -9,12 +9,18 @@ namespace lzw {
 
 using CodeType = lz78::factorid_t;
 
+/// Dictionary entries added after the root entries on each reset,
+/// as pairs of the parent's code and the appended character.
+using Seed = std::vector<std::pair<CodeType, uliteral_t>>;
+
 template<class F>
 void decode_step(F next_code_callback,
                  std::ostream& out,
                  const CodeType dms,
-                 const CodeType reserve_dms) {
+                 const CodeType reserve_dms,
+                 const Seed& seed = Seed()) {
     std::vector<std::pair<CodeType, uliteral_t>> dictionary;
+    std::vector<uliteral_t> buffer; // String rebuilt by rebuild_string
 
     // "named" lambda function, used to reset the dictionary to its initial contents
     const auto reset_dictionary = [&] {
@@ -26,24 +32,24 @@ void decode_step(F next_code_callback,
 
         for (long int c = minc; c <= maxc; ++c)
             dictionary.push_back({dms, static_cast<uliteral_t> (c)});
+
+        dictionary.insert(dictionary.end(), seed.begin(), seed.end());
     };
 
     const auto rebuild_string = [&](CodeType k) -> const std::vector<uliteral_t> * {
-        static std::vector<uliteral_t> s; // String
-
-        s.clear();
+        buffer.clear();
 
         // the length of a string cannot exceed the dictionary's number of entries
-        s.reserve(reserve_dms);
+        buffer.reserve(reserve_dms);
 
         while (k != dms)
         {
-            s.push_back(dictionary[k].second);
+            buffer.push_back(dictionary[k].second);
             k = dictionary[k].first;
         }
 
-        std::reverse(s.begin(), s.end());
-        return &s;
+        std::reverse(buffer.begin(), buffer.end());
+        return &buffer;
     };
 
     reset_dictionary();
@@ -1,11 +1,20 @@
 #pragma once
 
+#include <cstring>
+
 #include <tudocomp/ds/IntVector.hpp>
 #include <tudocomp/util.hpp>
 
 namespace tdc {
 
 /// \brief Base for data structures that use an integer array as a storage.
+///
+/// If the bit width of the array is a multiple of 8, e.g., in
+/// \ref CompressMode::aligned, the array is accessed bytewise: each element
+/// is read or written with a single unaligned load or store of 8 bytes at
+/// its byte position, instead of being assembled from the one or two words
+/// it is packed into. This requires the little-endian layout of the packed
+/// words, on other platforms all accesses use the bit-packed path.
 class ArrayDS: public DynamicIntVector {
 public:
     /// \brief The type of integer array to use as storage.
@@ -27,6 +36,23 @@ protected:
         (iv_t&)(*this) = std::move(iv);
         IF_DEBUG(m_is_initialized = true;)
     }
+
+    // if the i-th element can be accessed bytewise, yields its first byte
+    inline const uint8_t* byte_ptr(size_t i) const {
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        const uint8_t w = width();
+        if(w % 8 == 0) {
+            // the 8 bytes read must not exceed the last word
+            const uint64_t pos = uint64_t(i) * (w / 8);
+            const uint64_t words = (uint64_t(size()) * w + 63) / 64;
+            if(tdc_likely(pos + 8 <= words * 8)) {
+                return reinterpret_cast<const uint8_t*>(data()) + pos;
+            }
+        }
+#endif
+        return nullptr;
+    }
+
 public:
     inline ArrayDS() {}
     inline ArrayDS(const ArrayDS& other) = delete;
@@ -42,6 +68,38 @@ public:
     /// \brief The data structure's data type.
     using data_type = iv_t;
 
+    using DynamicIntVector::operator[];
+
+    /// \brief Reads the i-th element, see \ref get.
+    inline uint64_t operator[](size_t i) const {
+        return get(i);
+    }
+
+    /// \brief Reads the i-th element, bytewise if the width permits.
+    inline uint64_t get(size_t i) const {
+        DCHECK_LT(i, size());
+        if(const uint8_t* p = byte_ptr(i)) {
+            uint64_t x;
+            std::memcpy(&x, p, 8);
+            return x & (uint64_t(-1) >> (64 - width()));
+        }
+        return DynamicIntVector::operator[](i);
+    }
+
+    /// \brief Writes the i-th element, bytewise if the width permits.
+    inline void set(size_t i, uint64_t v) {
+        DCHECK_LT(i, size());
+        if(uint8_t* p = const_cast<uint8_t*>(byte_ptr(i))) {
+            const uint64_t mask = uint64_t(-1) >> (64 - width());
+            uint64_t x;
+            std::memcpy(&x, p, 8);
+            x = (x & ~mask) | (v & mask);
+            std::memcpy(p, &x, 8);
+        } else {
+            DynamicIntVector::operator[](i) = v;
+        }
+    }
+
     /// \brief Forces the data structure to relinquish its data storage.
     ///
     /// This is done by moving the ownership of the storage to the caller.
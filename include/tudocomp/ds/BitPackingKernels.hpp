@@ -0,0 +1,210 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include <glog/logging.h>
+
+/// \cond INTERNAL
+
+namespace tdc {
+namespace int_vector {
+/// Bulk access to bit packed integers of a width `W` that is known at
+/// compile time.
+///
+/// Elements are stored like in `sdsl::bits`: element `i` occupies the bits
+/// `[i * W, (i + 1) * W)` of the backing words, starting at the least
+/// significant bit of a word and continuing in the next one.
+///
+/// Every 64 elements start at a word boundary again, so aligned blocks of
+/// 64 elements span exactly `W` words at bit offsets that are constants
+/// for each element of the block. The block kernels unpack or pack them
+/// without any variable shifts, and only the elements before the first and
+/// after the last aligned block of a range are accessed one at a time.
+namespace kernels {
+    constexpr size_t BLOCK = 64;
+
+    template<size_t W>
+    constexpr uint64_t mask() {
+        return (~uint64_t(0)) >> (64 - W);
+    }
+
+    template<size_t W>
+    inline uint64_t read(const uint64_t* words, uint64_t bit) {
+        const uint64_t* p = words + bit / 64;
+        const size_t o = bit % 64;
+
+        uint64_t v = p[0] >> o;
+        if(o + W > 64) v |= p[1] << (64 - o);
+        return v & mask<W>();
+    }
+
+    template<size_t W>
+    inline void write(uint64_t* words, uint64_t bit, uint64_t v) {
+        uint64_t* p = words + bit / 64;
+        const size_t o = bit % 64;
+
+        v &= mask<W>();
+        p[0] = (p[0] & ~(mask<W>() << o)) | (v << o);
+        if(o + W > 64) {
+            p[1] = (p[1] & ~(mask<W>() >> (64 - o))) | (v >> (64 - o));
+        }
+    }
+
+    template<size_t W, typename out_t, size_t... J>
+    inline void unpack_block(const uint64_t* in, out_t* out, std::index_sequence<J...>) {
+        using expand = int[];
+        (void) expand { (out[J] = out_t(read<W>(in, J * W)), 0)... };
+    }
+
+    /// Unpacks the 64 elements stored in the `W` words `in`.
+    ///
+    /// The loop over the elements is expanded at compile time, such that all
+    /// bit offsets are constants.
+    template<size_t W, typename out_t>
+    inline void unpack_block(const uint64_t* in, out_t* out) {
+        unpack_block<W>(in, out, std::make_index_sequence<BLOCK>());
+    }
+
+    template<size_t W, size_t J, typename in_t>
+    inline void pack_element(const in_t* in, uint64_t* out) {
+        constexpr size_t k = (J * W) / 64;
+        constexpr size_t o = (J * W) % 64;
+
+        const uint64_t v = uint64_t(in[J]) & mask<W>();
+        // the first element touching a word starts at its lowest bit,
+        // or is the one that spills over into it
+        if(o == 0) out[k] = v; else out[k] |= v << o;
+        if(o + W > 64) out[k + 1] = v >> ((64 - o) % 64);
+    }
+
+    template<size_t W, typename in_t, size_t... J>
+    inline void pack_block(const in_t* in, uint64_t* out, std::index_sequence<J...>) {
+        using expand = int[];
+        (void) expand { (pack_element<W, J>(in, out), 0)... };
+    }
+
+    /// Packs 64 elements into the `W` words `out`, overwriting them.
+    template<size_t W, typename in_t>
+    inline void pack_block(const in_t* in, uint64_t* out) {
+        pack_block<W>(in, out, std::make_index_sequence<BLOCK>());
+    }
+
+    /// Unpacks the elements `[i, i + n)` to `out`.
+    template<size_t W, typename out_t>
+    inline void unpack(const uint64_t* words, uint64_t i, uint64_t n, out_t* out) {
+        const uint64_t end = i + n;
+        for(; i < end && i % BLOCK != 0; ++i) {
+            *out++ = out_t(read<W>(words, i * W));
+        }
+        for(; i + BLOCK <= end; i += BLOCK, out += BLOCK) {
+            unpack_block<W>(words + (i / BLOCK) * W, out);
+        }
+        for(; i < end; ++i) {
+            *out++ = out_t(read<W>(words, i * W));
+        }
+    }
+
+    /// Packs `n` elements from `in` into the elements `[i, i + n)`.
+    template<size_t W, typename in_t>
+    inline void pack(uint64_t* words, uint64_t i, uint64_t n, const in_t* in) {
+        const uint64_t end = i + n;
+        for(; i < end && i % BLOCK != 0; ++i) {
+            write<W>(words, i * W, uint64_t(*in++));
+        }
+        for(; i + BLOCK <= end; i += BLOCK, in += BLOCK) {
+            pack_block<W>(in, words + (i / BLOCK) * W);
+        }
+        for(; i < end; ++i) {
+            write<W>(words, i * W, uint64_t(*in++));
+        }
+    }
+
+    /// Sets the elements `[i, i + n)` to `v`.
+    ///
+    /// The aligned blocks are copies of one packed block of 64 times `v`.
+    template<size_t W>
+    inline void fill(uint64_t* words, uint64_t i, uint64_t n, uint64_t v) {
+        const uint64_t end = i + n;
+        for(; i < end && i % BLOCK != 0; ++i) {
+            write<W>(words, i * W, v);
+        }
+        if(i + BLOCK <= end) {
+            uint64_t values[BLOCK];
+            std::fill(values, values + BLOCK, v);
+            uint64_t pattern[W];
+            pack_block<W>(values, pattern);
+
+            for(; i + BLOCK <= end; i += BLOCK) {
+                std::copy(pattern, pattern + W, words + (i / BLOCK) * W);
+            }
+        }
+        for(; i < end; ++i) {
+            write<W>(words, i * W, v);
+        }
+    }
+
+    /// Calls `f(std::integral_constant<size_t, W>())` with `W = w`.
+    template<size_t W = 1>
+    struct WidthDispatch {
+        template<typename F>
+        inline static void call(uint8_t w, F&& f) {
+            if(w == W) {
+                f(std::integral_constant<size_t, W>());
+            } else {
+                WidthDispatch<W + 1>::call(w, f);
+            }
+        }
+    };
+
+    template<>
+    struct WidthDispatch<65> {
+        template<typename F>
+        inline static void call(uint8_t w, F&&) {
+            DCHECK(false) << "invalid bit width " << size_t(w);
+        }
+    };
+
+    template<typename F>
+    inline void dispatch_width(uint8_t w, F&& f) {
+        WidthDispatch<>::call(w, f);
+    }
+
+    /// Moves the first `n` elements of width `old_width` into the grid of
+    /// width `new_width` within the same words.
+    ///
+    /// Elements are moved in chunks through a buffer, front to back when
+    /// shrinking and back to front when growing, such that no chunk
+    /// overwrites elements that were not moved yet.
+    inline void convert_width(uint64_t* words, uint64_t n,
+                              uint8_t old_width, uint8_t new_width) {
+        constexpr uint64_t CHUNK = 16 * BLOCK;
+        uint64_t buffer[CHUNK];
+
+        auto move_chunk = [&](uint64_t i) {
+            const uint64_t len = std::min(CHUNK, n - i);
+            dispatch_width(old_width, [&](auto w) {
+                unpack<decltype(w)::value>(words, i, len, buffer);
+            });
+            dispatch_width(new_width, [&](auto w) {
+                pack<decltype(w)::value>(words, i, len, (const uint64_t*) buffer);
+            });
+        };
+
+        if(new_width < old_width) {
+            for(uint64_t i = 0; i < n; i += CHUNK) move_chunk(i);
+        } else if(new_width > old_width) {
+            for(uint64_t i = ((n + CHUNK - 1) / CHUNK) * CHUNK; i > 0; i -= CHUNK) {
+                move_chunk(i - CHUNK);
+            }
+        }
+    }
+}
+
+}}
+
+/// \endcond
+
@@ -105,12 +105,7 @@ namespace int_vector {
             DCHECK_EQ(converted_size, this->m_vec.capacity());
         }
         inline BitPackingVector(size_type n, const value_type& val): BitPackingVector(n) {
-            auto ptr = this->m_vec.data();
-            uint8_t offset = 0;
-
-            for (size_t i = 0; i < n; i++) {
-                bits::write_int_and_move(ptr, val, offset, this->width());
-            }
+            fill(0, n, val);
         }
 
         inline BitPackingVector(size_type n, const value_type& val, uint8_t width):
@@ -234,9 +229,7 @@ namespace int_vector {
             auto old_size = size();
             resize(n);
             if (old_size < n) {
-                for (auto a = begin() + old_size, b = end(); a != b; ++a) {
-                    *a = val;
-                }
+                fill(old_size, n - old_size, val);
             }
         }
 
@@ -485,60 +478,55 @@ namespace int_vector {
             auto common_size = std::min(old_size, new_size);
 
             if (old_width < new_width) {
-                // grow
-
-                // Read from position of last element in the old width grid,
-                // and write to position of last element in the new width grid
-                auto old_p = bitpos2backingpos_w(elem2bits_w(common_size, old_width));
-                auto new_p = bitpos2backingpos_w(elem2bits_w(common_size, new_width));
-
-                // make room for new bits, reallocating as needed
+                // grow: make room for new bits, reallocating as needed,
+                // then move elements into the new width grid back to front
                 this->m_vec.resize(bits2backing_w(new_bit_size));
-                this->set_width_raw(w);
-                this->m_real_size = new_size;
-
-                uint64_t* old_ptr = this->m_vec.data() + old_p.pos;
-                uint64_t* new_ptr = this->m_vec.data() + new_p.pos;
-
-                // move elements into new width grid
-                for (uint64_t i = 0; i < common_size; i++) {
-                    sdsl::bits::move_left((const uint64_t*&) old_ptr, old_p.offset, old_width);
-                    auto v = sdsl::bits::read_int(           old_ptr, old_p.offset, old_width);
-
-                    sdsl::bits::move_left((const uint64_t*&) new_ptr,    new_p.offset, new_width);
-                    sdsl::bits::write_int(                   new_ptr, v, new_p.offset, new_width);
-                }
+                kernels::convert_width(this->m_vec.data(), common_size, old_width, new_width);
             } else if (old_width > new_width) {
-                // shrink
-
-                uint64_t* old_ptr = this->m_vec.data();
-                uint64_t* new_ptr = this->m_vec.data();
-
-                uint8_t old_offset = 0;
-                uint8_t new_offset = 0;
-
-                // move elements into new width grid
-                for (uint64_t i = 0; i < common_size; i++) {
-                    auto v = sdsl::bits::read_int_and_move((const uint64_t*&) old_ptr, old_offset, old_width);
-                    sdsl::bits::write_int_and_move(new_ptr, v, new_offset, new_width);
-                }
-
-                // remove extra bits, dropping as needed
+                // shrink: move elements into the new width grid front to
+                // back, then remove extra bits, dropping as needed
+                kernels::convert_width(this->m_vec.data(), common_size, old_width, new_width);
+                this->m_vec.resize(bits2backing_w(new_bit_size));
+            } else {
                 this->m_vec.resize(bits2backing_w(new_bit_size));
-                this->set_width_raw(w);
-                this->m_real_size = new_size;
             }
+            this->set_width_raw(w);
+            this->m_real_size = new_size;
 
             // initialize new elements correctly
             if (old_size < new_size) {
-                auto a = this->begin() + old_size;
-                auto b = this->end();
-                for(; a != b; ++a) {
-                    *a = val;
-                }
+                fill(old_size, new_size - old_size, val);
             }
         }
 
+        /// Copies the elements `[i, i + n)` to `out`.
+        template<class U>
+        inline void get_range(size_type i, size_type n, U* out) const {
+            DCHECK_LE(i + n, size());
+            this->with_static_width([&](auto w) {
+                kernels::unpack<decltype(w)::value>(this->m_vec.data(), i, n, out);
+            });
+        }
+
+        /// Overwrites the elements `[i, i + n)` with the values of `in`,
+        /// truncated to the width of the vector.
+        template<class U>
+        inline void set_range(size_type i, size_type n, const U* in) {
+            DCHECK_LE(i + n, size());
+            this->with_static_width([&](auto w) {
+                kernels::pack<decltype(w)::value>(this->m_vec.data(), i, n, in);
+            });
+        }
+
+        /// Overwrites the elements `[i, i + n)` with `val`.
+        inline void fill(size_type i, size_type n, const value_type& val) {
+            DCHECK_LE(i + n, size());
+            const uint64_t v = uint64_t(val);
+            this->with_static_width([&](auto w) {
+                kernels::fill<decltype(w)::value>(this->m_vec.data(), i, n, v);
+            });
+        }
+
         inline void bit_reserve(uint64_t n) {
             this->m_vec.reserve(bits2backing(n));
         }
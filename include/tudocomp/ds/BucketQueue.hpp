@@ -0,0 +1,204 @@
+#pragma once
+
+#include <tudocomp/def.hpp>
+#include <tudocomp/util.hpp>
+#include <tudocomp/ds/IntVector.hpp>
+
+namespace tdc {
+
+/// \brief Represents a monotone max bucket queue backed by an external array
+///        of keys, with lazy deletion and decrease-key.
+///
+/// Like \ref ArrayMaxHeap, the queue induces an order on the indices of the
+/// key array it is backed by. There is one bucket for every key in
+/// `[min_key, max_key]`, and buckets are stacks linked through a single
+/// bit-packed array, so every item is in at most one bucket at any time.
+///
+/// Neither \ref remove nor \ref decrease_key touch the buckets: the former
+/// only clears the item's membership bit, the latter only writes the new key
+/// into the key array. An item whose key no longer matches its bucket is
+/// moved down to the bucket of its new key (or dropped, if its key fell below
+/// `min_key`) once it reaches the top of its bucket. Hence, all decrease-key
+/// operations issued between two calls to \ref get_max are applied in one
+/// batch, and each of them costs constant time.
+///
+/// The maximum key may only decrease over time, unless new items with a
+/// larger key are inserted, which holds for the lcpcomp strategies.
+///
+/// \tparam array_t The key array type. Must support the `[]` operator.
+template<typename array_t>
+class BucketQueue {
+
+private:
+    // the array
+    array_t* m_array;
+
+    // undefined item
+    size_t m_undef;
+
+    // the key of bucket 0
+    size_t m_min_key;
+
+    // the key of the current topmost bucket
+    size_t m_top;
+
+    // bucket heads by key - m_min_key and the links of the stacks
+    DynamicIntVector m_head;
+    DynamicIntVector m_next;
+
+    // membership
+    BitVector m_contained;
+    size_t m_size;
+
+    inline void push(size_t key, len_t i) {
+        m_next[i] = m_head[key - m_min_key];
+        m_head[key - m_min_key] = i;
+    }
+
+    inline len_t pop(size_t key) {
+        const len_t i = m_head[key - m_min_key];
+        m_head[key - m_min_key] = m_next[i];
+        return i;
+    }
+
+    // moves the topmost bucket down to the first one whose top item is
+    // valid, moving or dropping all stale items on the way
+    inline void settle() {
+        DCHECK_GT(m_size, 0U) << "no valid item left in the queue";
+        while(true) {
+            const size_t i = m_head[m_top - m_min_key];
+            if(i == m_undef) {
+                DCHECK_GT(m_top, m_min_key);
+                --m_top;
+            } else if(!m_contained[i]) {
+                pop(m_top); // removed
+            } else {
+                const size_t key = (*m_array)[i];
+                DCHECK_LE(key, m_top) << "keys may only be decreased";
+                if(key == m_top) return;
+
+                pop(m_top);
+                if(key >= m_min_key) {
+                    push(key, i); // decreased
+                } else {
+                    m_contained[i] = 0; // decreased below the minimum
+                    --m_size;
+                }
+            }
+        }
+    }
+
+public:
+    /// \brief Default constructor.
+    ///
+    /// Note that the constructor will not insert any items into the queue and
+    /// serves merely for initialization.
+    ///
+    /// \param array The array of keys sorted by this queue.
+    /// \param array_size The size of the key array.
+    /// \param min_key The minimum key of an item in the queue.
+    /// \param max_key The maximum key of an item in the queue.
+    inline BucketQueue(array_t& array, const size_t array_size,
+                       const size_t min_key, const size_t max_key)
+        : m_array(&array), m_undef(array_size),
+          m_min_key(min_key), m_top(min_key), m_size(0)
+    {
+        DCHECK_LE(min_key, max_key);
+        m_head = DynamicIntVector(max_key - min_key + 1, m_undef, bits_for(m_undef));
+        m_next = DynamicIntVector(array_size, m_undef, bits_for(m_undef));
+        m_contained = BitVector(array_size, 0);
+    }
+
+    /// \brief Inserts an item into the queue.
+    ///
+    /// Every item may be inserted only once.
+    ///
+    /// \param i The index of the item in the key array. The key is retrieved
+    ///          from there.
+    inline void insert(len_t i) {
+        DCHECK(!m_contained[i]) << "trying to insert an item that's already in the queue";
+
+        const size_t key = (*m_array)[i];
+        DCHECK_GE(key, m_min_key);
+        DCHECK_LT(key - m_min_key, m_head.size());
+
+        push(key, i);
+        m_top = std::max(m_top, key);
+
+        m_contained[i] = 1;
+        ++m_size;
+    }
+
+    /// \brief Removes an item from the queue.
+    ///
+    /// \param i The index of the item in the key array.
+    inline void remove(len_t i) {
+        if(m_contained[i]) { // never mind if it's not in the queue
+            m_contained[i] = 0;
+            --m_size;
+        }
+    }
+
+    /// \brief Decreases the key of an item in the queue.
+    ///
+    /// If the new key is less than the minimum key, the item is removed.
+    ///
+    /// \tparam key_t the key type.
+    /// \param i The index of the item in the key array.
+    /// \param value The new key value.
+    template<typename key_t>
+    inline void decrease_key(len_t i, key_t value) {
+        DCHECK(m_contained[i]) << "trying to decrease_key on an item that's not in the queue";
+        DCHECK_LE(size_t(value), size_t((*m_array)[i]));
+
+        (*m_array)[i] = value;
+        if(size_t(value) < m_min_key) remove(i);
+    }
+
+    /// \brief Checks whether or not an item is contained in this queue.
+    ///
+    /// \param i The index of the item in the key array.
+    /// \return \e true if the item is contained in the queue, \e false otherwise.
+    inline bool contains(len_t i) const {
+        return m_contained[i];
+    }
+
+    /// \brief Yields the number of items currently stored in the queue.
+    /// \return The number of items currently stored in the queue.
+    inline size_t size() const {
+        return m_size;
+    }
+
+    /// \brief Tests whether the queue is empty.
+    inline bool empty() const {
+        return m_size == 0;
+    }
+
+    /// \brief Gets an item with the maximum key from the queue.
+    ///
+    /// Applies all pending removals and decrease-key operations that
+    /// affect the buckets above it.
+    ///
+    /// \return The index in the key array that points to the largest key.
+    inline size_t get_max() {
+        settle();
+        return m_head[m_top - m_min_key];
+    }
+
+    /// \brief Gets the top (maximum) item from the queue.
+    /// \return The index in the key array that points to the largest key.
+    inline size_t top() {
+        return get_max();
+    }
+
+    /// \brief Gets an item's key.
+    ///
+    /// \param i The index of the item in the key array.
+    /// \return The item's key, retrieved from the key array.
+    inline len_t key(len_t i) const {
+        return (*m_array)[i];
+    }
+};
+
+} //ns
+
@@ -0,0 +1,262 @@
+#pragma once
+
+#include <vector>
+
+#include <tudocomp/def.hpp>
+#include <tudocomp/util.hpp>
+#include <tudocomp/ds/IntVector.hpp>
+#include <tudocomp/ds/LCPIntervals.hpp>
+
+#include <glog/logging.h>
+
+namespace tdc {
+
+/// \brief A suffix tree stored in a few bit-packed arrays, constructed from
+///        the suffix and LCP arrays.
+///
+/// The internal nodes are the LCP intervals of the text, enumerated
+/// bottom-up by \ref LCPIntervals in a single scan over the arrays, and
+/// numbered in postorder, so the root is the last internal node. Leaves are
+/// identified by the text position of their suffix. For each internal node, its string
+/// depth, its node depth and its suffix array interval are stored, and for
+/// each leaf its parent.
+///
+/// The internal nodes are additionally sorted by their node depth. As an
+/// ancestor of a node is the first node of its depth that follows the node in
+/// postorder, level ancestor and parent queries are binary searches among the
+/// nodes of one depth. Likewise, the internal children of a node are a
+/// contiguous run among the nodes of the next depth.
+///
+/// The text itself is not needed.
+class CompactSuffixTree {
+public:
+    /// \brief Internal nodes are numbered `[0, internal_nodes())` in
+    ///        postorder, the leaf of text position `i` is
+    ///        `internal_nodes() + i`.
+    using node_type = size_t;
+
+private:
+    size_t m_n;        // number of leaves
+    size_t m_internal; // number of internal nodes
+
+    DynamicIntVector m_leaf_parent; // by text position
+    DynamicIntVector m_str_depth;   // by internal node
+    DynamicIntVector m_depth;       // by internal node
+    DynamicIntVector m_lb;          // by internal node
+    DynamicIntVector m_rb;          // by internal node
+
+    // internal nodes sorted by depth, and the start of each depth
+    DynamicIntVector m_by_depth;
+    DynamicIntVector m_depth_start;
+
+    // the index of the first internal node of depth d at or after v in
+    // postorder within m_by_depth
+    inline size_t lower_bound(size_t d, node_type v) const {
+        size_t lo = m_depth_start[d];
+        size_t hi = m_depth_start[d + 1];
+        while(lo < hi) {
+            const size_t mid = lo + (hi - lo) / 2;
+            if(m_by_depth[mid] < v) lo = mid + 1; else hi = mid;
+        }
+        return lo;
+    }
+
+    // the first internal node of depth d at or after v in postorder
+    inline node_type internal_level_anc(node_type v, size_t d) const {
+        const size_t i = lower_bound(d, v);
+        DCHECK_LT(i, size_t(m_depth_start[d + 1]));
+        return m_by_depth[i];
+    }
+
+public:
+    /// \brief Constructs an empty suffix tree.
+    inline CompactSuffixTree() : m_n(0), m_internal(0) {
+    }
+
+    /// \brief Constructs the suffix tree.
+    ///
+    /// \param sa the suffix array of a text that ends with a unique sentinel.
+    /// \param lcp the LCP array of the text.
+    template<typename sa_t, typename lcp_t>
+    inline CompactSuffixTree(const sa_t& sa, const lcp_t& lcp) : m_n(sa.size()) {
+        DCHECK_GT(m_n, 0U);
+        const uint8_t w = bits_for(m_n);
+
+        // while enumerating, a node's parent may not be closed yet, so nodes
+        // are referenced by the order in which they are opened, which is
+        // mapped to postorder afterwards
+        DynamicIntVector parent;
+        DynamicIntVector opened_to_post(m_n, 0, w);
+        parent.width(w);
+        m_str_depth.width(w);
+        m_lb.width(w);
+        m_rb.width(w);
+        m_leaf_parent = DynamicIntVector(m_n, 0, w);
+
+        LCPIntervals intervals;
+        intervals.enumerate(lcp, 0, m_n - 1,
+            [&](const LCPInterval& node) {
+                opened_to_post[node.id] = m_str_depth.size();
+                m_str_depth.push_back(node.lcp);
+                m_lb.push_back(node.lb);
+                m_rb.push_back(node.rb);
+                parent.push_back(node.parent);
+            },
+            [&](size_t rank, size_t parent_id) {
+                m_leaf_parent[sa[rank]] = parent_id;
+            });
+        m_internal = m_str_depth.size();
+        m_str_depth.shrink_to_fit();
+        m_lb.shrink_to_fit();
+        m_rb.shrink_to_fit();
+
+        // map opening order to postorder
+        for(size_t i = 0; i < m_n; i++) {
+            m_leaf_parent[i] = opened_to_post[m_leaf_parent[i]];
+        }
+        for(size_t v = 0; v + 1 < m_internal; v++) {
+            parent[v] = opened_to_post[parent[v]];
+        }
+        opened_to_post = DynamicIntVector();
+
+        // node depths, parents come after their children in postorder
+        m_depth = DynamicIntVector(m_internal, 0, w);
+        size_t max_depth = 0;
+        for(size_t v = m_internal - 1; v > 0; v--) {
+            const size_t d = m_depth[parent[v - 1]] + 1;
+            m_depth[v - 1] = d;
+            max_depth = std::max(max_depth, d);
+        }
+        parent = DynamicIntVector();
+        m_depth.width(bits_for(max_depth));
+
+        // sort internal nodes by depth, keeping postorder within a depth
+        m_depth_start = DynamicIntVector(max_depth + 2, 0, w);
+        for(size_t v = 0; v < m_internal; v++) {
+            m_depth_start[m_depth[v] + 1] = m_depth_start[m_depth[v] + 1] + 1;
+        }
+        for(size_t d = 1; d < max_depth + 2; d++) {
+            m_depth_start[d] = m_depth_start[d] + m_depth_start[d - 1];
+        }
+        {
+            DynamicIntVector fill(m_depth_start);
+            m_by_depth = DynamicIntVector(m_internal, 0, w);
+            for(size_t v = 0; v < m_internal; v++) {
+                const size_t d = m_depth[v];
+                m_by_depth[fill[d]] = v;
+                fill[d] = fill[d] + 1;
+            }
+        }
+    }
+
+    /// \brief The number of leaves, i.e., the length of the text.
+    inline size_t size() const {
+        return m_n;
+    }
+
+    /// \brief The number of internal nodes.
+    inline size_t internal_nodes() const {
+        return m_internal;
+    }
+
+    /// \brief The root node.
+    inline node_type root() const {
+        return m_internal - 1;
+    }
+
+    /// \brief Tests whether the given node is a leaf.
+    inline bool is_leaf(node_type v) const {
+        return v >= m_internal;
+    }
+
+    /// \brief The leaf of the suffix starting at the given text position.
+    inline node_type leaf(size_t pos) const {
+        DCHECK_LT(pos, m_n);
+        return m_internal + pos;
+    }
+
+    /// \brief The text position of the suffix of a leaf.
+    inline size_t leaf_pos(node_type v) const {
+        DCHECK(is_leaf(v));
+        return v - m_internal;
+    }
+
+    /// \brief The number of edges from the root to the given node.
+    inline size_t depth(node_type v) const {
+        return is_leaf(v) ? m_depth[m_leaf_parent[leaf_pos(v)]] + 1 : m_depth[v];
+    }
+
+    /// \brief The length of the string spelled by the path from the root to
+    ///        the given node.
+    inline size_t str_depth(node_type v) const {
+        return is_leaf(v) ? m_n - leaf_pos(v) : m_str_depth[v];
+    }
+
+    /// \brief The parent of a node other than the root.
+    inline node_type parent(node_type v) const {
+        DCHECK_NE(v, root());
+        return is_leaf(v)
+            ? node_type(m_leaf_parent[leaf_pos(v)])
+            : internal_level_anc(v, m_depth[v] - 1);
+    }
+
+    /// \brief The ancestor of a node with the given depth, where the root has
+    ///        depth zero and a node is its own ancestor.
+    inline node_type level_anc(node_type v, size_t d) const {
+        DCHECK_LE(d, depth(v));
+        if(is_leaf(v)) {
+            const node_type p = m_leaf_parent[leaf_pos(v)];
+            return (d > m_depth[p]) ? v : internal_level_anc(p, d);
+        } else {
+            return internal_level_anc(v, d);
+        }
+    }
+
+    /// \brief The first rank of the suffix array interval of the leaves
+    ///        below an internal node.
+    inline size_t lb(node_type v) const {
+        DCHECK(!is_leaf(v));
+        return m_lb[v];
+    }
+
+    /// \brief The last rank of the suffix array interval of the leaves
+    ///        below an internal node.
+    inline size_t rb(node_type v) const {
+        DCHECK(!is_leaf(v));
+        return m_rb[v];
+    }
+
+    /// \brief Calls the given function for each internal child of an
+    ///        internal node, in lexicographic order.
+    ///
+    /// The leaves below the node that are not below one of these children
+    /// are its leaf children.
+    template<typename child_func_t>
+    inline void for_each_internal_child(node_type v, child_func_t f) const {
+        DCHECK(!is_leaf(v));
+        const size_t d = m_depth[v];
+        if(d + 2 >= m_depth_start.size()) return; // no deeper nodes
+
+        // the subtree of v starts after the previous node of the same depth
+        const size_t i = lower_bound(d, v);
+        const node_type first =
+            (i > m_depth_start[d]) ? node_type(m_by_depth[i - 1]) + 1 : 0;
+
+        const size_t end = m_depth_start[d + 2];
+        for(size_t k = lower_bound(d + 1, first);
+            k < end && m_by_depth[k] < v; k++) {
+
+            f(node_type(m_by_depth[k]));
+        }
+    }
+
+    /// \brief The size of the data structure in bytes.
+    inline size_t size_in_bytes() const {
+        return (m_leaf_parent.bit_size() + m_str_depth.bit_size() +
+            m_depth.bit_size() + m_lb.bit_size() + m_rb.bit_size() +
+            m_by_depth.bit_size() + m_depth_start.bit_size()) / 8;
+    }
+};
+
+} //ns
+
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <algorithm>
+
+#include <tudocomp/def.hpp>
+
 namespace tdc {
 
     /// Defines when data structures are bit-compressed.
@@ -16,6 +20,11 @@ namespace tdc {
         /// (slower construction, but smaller memory usage).
         compressed = 2,
 
+        /// Data structures are constructed directly with their bit width
+        /// rounded up to whole bytes, e.g., 40 bits for texts between 4 GiB
+        /// and 1 TiB (less memory than plain, faster access than compressed).
+        aligned = 3,
+
         /// Special mode that will cause no bit-compression at all during
         /// construction, internal use in TextDS only
         coherent_delayed = 254,
@@ -28,4 +37,14 @@ namespace tdc {
         return in == CompressMode::select ? sel : in;
     }
 
+    /// Yields the bit width to construct an array with in the given mode,
+    /// if its values require `bits` bits.
+    inline uint8_t cm_width(CompressMode cm, size_t bits) {
+        switch(cm) {
+            case CompressMode::compressed: return bits;
+            case CompressMode::aligned:    return 8 * ((std::max<size_t>(bits, 1) + 7) / 8);
+            default:                       return INDEX_FAST_BITS;
+        }
+    }
+
 }
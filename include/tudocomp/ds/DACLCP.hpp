@@ -0,0 +1,165 @@
+#pragma once
+
+#include <vector>
+
+#include <tudocomp/ds/TextDSFlags.hpp>
+#include <tudocomp/ds/CompressMode.hpp>
+#include <tudocomp/ds/IntVector.hpp>
+#include <tudocomp/ds/RankSelect.hpp>
+
+#include <tudocomp_stat/StatPhase.hpp>
+
+namespace tdc {
+
+/// \brief Constructs the LCP array from the Suffix and PLCP arrays,
+///        storing it with directly addressable codes (Brisaboa et al., 2013).
+///
+/// Each entry is split into chunks of 8 bits. The lowest chunk of every
+/// entry is stored in a byte array, the second lowest chunk of every entry
+/// that has one in a second byte array, and so on. For each level, a bit
+/// vector with rank support marks the entries that continue in the next
+/// level, where their rank is their index.
+///
+/// As most LCP values are small, the array takes little more than one byte
+/// per entry, and an access to an entry below 256 costs one read from the
+/// byte array and one from the bit vector. Unlike \ref CompressedLCP, the
+/// suffix array is not needed for access.
+class DACLCP : public Algorithm {
+public:
+    using iv_t = DynamicIntVector;
+    using data_type = iv_t;
+
+    /// The number of bits in a chunk.
+    static constexpr size_t chunk_bits = 8;
+
+private:
+    len_t m_size;
+    len_t m_max;
+
+    // the chunks of each level
+    std::vector<IntVector<uint8_t>> m_chunks;
+
+    // for each level but the last, marks the entries that have a chunk
+    // on the next level
+    std::vector<RankSelect> m_more;
+
+public:
+    inline static Meta meta() {
+        Meta m("lcp", "dac", "LCP array in directly addressable codes");
+        return m;
+    }
+
+    inline static ds::InputRestrictions restrictions() {
+        return ds::InputRestrictions {};
+    }
+
+    template<typename textds_t>
+    inline DACLCP(Env&& env, textds_t& tds, CompressMode cm)
+            : Algorithm(std::move(env)) {
+
+        // Require Suffix and PLCP Array
+        auto& sa = tds.require_sa(cm);
+        auto& plcp = tds.require_plcp(cm);
+
+        m_size = plcp.size();
+        m_max  = plcp.max_lcp();
+
+        // Construct
+        StatPhase::wrap("Construct DAC LCP Array", [&]{
+            const size_t levels = std::max<size_t>(1,
+                idiv_ceil(bits_for(m_max), chunk_bits));
+
+            auto lcp = [&](size_t i) -> len_t {
+                return (i > 0) ? len_t(plcp[sa[i]]) : 0;
+            };
+
+            // level l contains the entries with a value of at least
+            // 2^(l * chunk_bits), except for level 0 that contains all
+            m_chunks.resize(levels);
+            m_more.reserve(levels - 1);
+            for(size_t l = 0; l < levels; l++) {
+                const size_t shift = l * chunk_bits;
+                BitVector more;
+
+                for(size_t i = 0; i < m_size; i++) {
+                    const uint64_t v = uint64_t(lcp(i)) >> shift;
+                    if(l > 0 && v == 0) continue;
+
+                    m_chunks[l].push_back(uint8_t(v));
+                    if(l + 1 < levels) more.push_back(v >> chunk_bits != 0);
+                }
+
+                m_chunks[l].shrink_to_fit();
+                if(l + 1 < levels) m_more.emplace_back(more);
+            }
+
+            StatPhase::log("levels", levels);
+            StatPhase::log("size", size_in_bytes());
+        });
+    }
+
+    inline len_t max_lcp() const {
+        return m_max;
+    }
+
+    inline len_t operator[](len_t i) const {
+        DCHECK_LT(i, m_size);
+
+        size_t j = i;
+        len_t v = m_chunks[0][j];
+        for(size_t l = 0; l < m_more.size() && m_more[l][j]; l++) {
+            j = m_more[l].rank1(j) - 1;
+            v |= len_t(m_chunks[l + 1][j]) << ((l + 1) * chunk_bits);
+        }
+        return v;
+    }
+
+    inline void compress() {
+        // nothing to do, already compressed :-)
+    }
+
+    inline size_t size() const {
+        return m_size;
+    }
+
+    /// \brief The size of the array in bytes.
+    inline size_t size_in_bytes() const {
+        size_t bytes = 0;
+        for(auto& c : m_chunks) bytes += c.size();
+        for(auto& m : m_more) bytes += m.size_in_bytes();
+        return bytes;
+    }
+
+    /// \brief Decodes the array into a bit-compressed integer array and
+    ///        discards the codes.
+    ///
+    /// After this operation, the data structure is empty.
+    inline iv_t relinquish() {
+        iv_t lcp = copy();
+        m_chunks = std::vector<IntVector<uint8_t>>();
+        m_more = std::vector<RankSelect>();
+        m_size = 0;
+        return lcp;
+    }
+
+    /// \brief Decodes the array into a bit-compressed integer array.
+    inline iv_t copy() const {
+        iv_t lcp(m_size, 0, bits_for(m_max));
+
+        // the entries of a level are in the order of their index, so the
+        // position on each level is a running count instead of a rank
+        std::vector<size_t> next(m_chunks.size(), 0);
+        for(size_t i = 0; i < m_size; i++) {
+            size_t j = i;
+            len_t v = m_chunks[0][j];
+            for(size_t l = 0; l < m_more.size() && m_more[l][j]; l++) {
+                j = next[l + 1]++;
+                v |= len_t(m_chunks[l + 1][j]) << ((l + 1) * chunk_bits);
+            }
+            lcp[i] = v;
+        }
+        return lcp;
+    }
+};
+
+}
@@ -31,11 +31,11 @@ public:
             // Allocate
             const size_t n = t.size();
             const size_t w = bits_for(n);
-            set_array(iv_t(n, 0, (cm == CompressMode::compressed) ? w : INDEX_FAST_BITS));
+            set_array(iv_t(n, 0, cm_width(cm, w)));
 
             // Construct
             for(len_t i = 0; i < n; i++) {
-                (*this)[sa[i]] = i;
+                set(sa[i], i);
             }
 
             StatPhase::log("bit_width", size_t(width()));
@@ -6,6 +6,7 @@
 
 #include <tudocomp/ds/uint_t.hpp>
 #include <tudocomp/ds/dynamic_t.hpp>
+#include <tudocomp/ds/BitPackingKernels.hpp>
 
 namespace tdc {namespace int_vector {
     enum class ElementStorageMode {
@@ -111,6 +112,11 @@ namespace tdc {namespace int_vector {
 
         inline uint8_t raw_width() const { return N; }
         inline void set_width_raw(uint8_t) { }
+
+        template<typename F>
+        inline void with_static_width(F&& f) const {
+            f(std::integral_constant<size_t, N>());
+        }
     };
     struct DynamicBitPackingVectorRepr {
         using internal_data_type = DynamicIntValueType;
@@ -128,6 +134,11 @@ namespace tdc {namespace int_vector {
 
         inline uint8_t raw_width() const { return m_width; }
         inline void set_width_raw(uint8_t width) { m_width = width; }
+
+        template<typename F>
+        inline void with_static_width(F&& f) const {
+            kernels::dispatch_width(m_width, f);
+        }
     };
 
     template<typename T, typename X = void>
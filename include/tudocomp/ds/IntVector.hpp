@@ -80,6 +80,24 @@ namespace int_vector {
         inline static void bit_reserve(backing_data& self, uint64_t n) {
             // TODO: Should this round up to the size of element, and then reserve normally?
         }
+
+        template<class U>
+        inline static void get_range(const backing_data& self, size_type i, size_type n, U* out) {
+            for (size_type j = 0; j < n; j++) {
+                out[j] = U(self[i + j]);
+            }
+        }
+
+        template<class U>
+        inline static void set_range(backing_data& self, size_type i, size_type n, const U* in) {
+            for (size_type j = 0; j < n; j++) {
+                self[i + j] = in[j];
+            }
+        }
+
+        inline static void fill(backing_data& self, size_type i, size_type n, const value_type& val) {
+            std::fill(self.begin() + i, self.begin() + i + n, val);
+        }
     };
 
     template<typename T>
@@ -135,6 +153,20 @@ namespace int_vector {
         inline static void bit_reserve(backing_data& self, uint64_t n) {
             self.bit_reserve(n);
         }
+
+        template<class U>
+        inline static void get_range(const backing_data& self, size_type i, size_type n, U* out) {
+            self.get_range(i, n, out);
+        }
+
+        template<class U>
+        inline static void set_range(backing_data& self, size_type i, size_type n, const U* in) {
+            self.set_range(i, n, in);
+        }
+
+        inline static void fill(backing_data& self, size_type i, size_type n, const value_type& val) {
+            self.fill(i, n, val);
+        }
     };
 
     template<class T, class X = void>
@@ -410,6 +442,34 @@ namespace int_vector {
             return m_data.data();
         }
 
+        /// Copies the elements `[i, i + n)` to `out`.
+        ///
+        /// For bit packed vectors, this unpacks whole words at once instead
+        /// of accessing each element through a reference proxy.
+        template<class U>
+        inline void get_range(size_type i, size_type n, U* out) const {
+            IntVectorTrait<T>::get_range(m_data, i, n, out);
+        }
+
+        /// Overwrites the elements `[i, i + n)` with the values of `in`.
+        ///
+        /// For bit packed vectors, the values are truncated to the bit width
+        /// and packed into whole words at once.
+        template<class U>
+        inline void set_range(size_type i, size_type n, const U* in) {
+            IntVectorTrait<T>::set_range(m_data, i, n, in);
+        }
+
+        /// Overwrites the elements `[i, i + n)` with `val`.
+        inline void fill(size_type i, size_type n, const value_type& val) {
+            IntVectorTrait<T>::fill(m_data, i, n, val);
+        }
+
+        /// Overwrites all elements with `val`.
+        inline void fill(const value_type& val) {
+            fill(0, size(), val);
+        }
+
         template <class InputIterator>
         inline void assign(InputIterator first, InputIterator last) {
             m_data.assign(first, last);
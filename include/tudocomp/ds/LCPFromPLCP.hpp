@@ -38,12 +38,12 @@ public:
             m_max = plcp.max_lcp();
             const size_t w = bits_for(m_max);
 
-            set_array(iv_t(n, 0, (cm == CompressMode::compressed) ? w : INDEX_FAST_BITS));
+            set_array(iv_t(n, 0, cm_width(cm, w)));
 
-            (*this)[0] = 0;
+            set(0, 0);
             for(len_t i = 1; i < n; i++) {
                 const len_t x = plcp[sa[i]];
-                (*this)[i] = x;
+                set(i, x);
             }
 
             StatPhase::log("bit_width", size_t(width()));
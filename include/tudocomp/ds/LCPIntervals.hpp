@@ -0,0 +1,162 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+
+#include <tudocomp/def.hpp>
+
+#include <glog/logging.h>
+
+namespace tdc {
+
+/// \brief An lcp-interval `[lb, rb]` of the suffix array.
+///
+/// The suffixes of ranks `lb` to `rb` share a common prefix of length `lcp`,
+/// which is maximal, and no suffix outside the interval shares it. These
+/// are the internal nodes of the suffix tree.
+struct LCPInterval {
+    size_t lcp; ///< the length of the common prefix
+    size_t lb;  ///< the first rank
+    size_t rb;  ///< the last rank
+    size_t id;  ///< the number of intervals opened before this one
+
+    /// The id of the smallest enclosing interval, or the interval's own id
+    /// if it is the outermost one.
+    size_t parent;
+};
+
+/// \brief Enumerates the lcp-intervals of an LCP array bottom-up.
+///
+/// The enumeration is a single scan over the LCP array that keeps the
+/// intervals enclosing the current rank on a stack (Abouelhoda et al.,
+/// 2004). Every interval is reported once it is closed, i.e., in postorder
+/// of the suffix tree, so the children of an interval are reported before
+/// it. The stack is kept across enumerations, so reusing an instance does
+/// not allocate.
+///
+/// The intervals below one child of the root do not depend on any other,
+/// so the child ranges returned by \ref for_each_child_range can be
+/// enumerated independently of each other, e.g., by different threads
+/// using an instance each.
+class LCPIntervals {
+private:
+    struct Open {
+        size_t lcp;
+        size_t lb;
+        size_t id;
+    };
+    std::vector<Open> m_stack;
+
+public:
+    /// \brief Enumerates the lcp-intervals nested in a range of ranks.
+    ///
+    /// \param lcp the LCP array.
+    /// \param lb the first rank of the range.
+    /// \param rb the last rank of the range.
+    /// \param on_interval called with an \ref LCPInterval for each interval
+    ///                    in the range, in postorder. The range itself is
+    ///                    the last one, even if it is a single rank.
+    /// \param on_leaf called with a rank and the id of the smallest interval
+    ///                containing it, for each rank in the range.
+    template<typename lcp_t, typename interval_func_t, typename leaf_func_t>
+    inline void enumerate(const lcp_t& lcp, const size_t lb, const size_t rb,
+                          interval_func_t on_interval, leaf_func_t on_leaf) {
+
+        DCHECK_LE(lb, rb);
+
+        // the range itself is the outermost interval
+        size_t min = (lb < rb) ? size_t(lcp[lb + 1]) : 0;
+        for(size_t j = lb + 2; j <= rb; j++) min = std::min(min, size_t(lcp[j]));
+
+        m_stack.clear();
+        m_stack.push_back(Open { min, lb, 0 });
+        size_t next_id = 1;
+
+        for(size_t j = lb + 1; j <= rb + 1; j++) {
+            // the boundary between the ranks j-1 and j, where the end of the
+            // range closes all intervals
+            const bool end = (j > rb);
+            const size_t x = end ? 0 : size_t(lcp[j]);
+
+            // the parent of rank j-1 is the deepest interval containing it,
+            // which is the first one closed here or the top of the stack
+            // afterwards
+            bool leaf_done = false;
+            while(!m_stack.empty() && (end || x < m_stack.back().lcp)) {
+                const Open node = m_stack.back();
+                m_stack.pop_back();
+
+                if(!leaf_done) {
+                    on_leaf(j - 1, node.id);
+                    leaf_done = true;
+                }
+
+                // the parent is either the next interval on the stack, or
+                // the one that is opened next
+                size_t parent;
+                if(m_stack.empty()) {
+                    parent = node.id;
+                } else if(x > m_stack.back().lcp) {
+                    parent = next_id;
+                } else {
+                    parent = m_stack.back().id;
+                }
+                on_interval(LCPInterval { node.lcp, node.lb, j - 1, node.id, parent });
+
+                if(!end && x > m_stack.back().lcp) {
+                    m_stack.push_back(Open { x, node.lb, next_id++ });
+                }
+            }
+
+            if(!end) {
+                if(x > m_stack.back().lcp) {
+                    m_stack.push_back(Open { x, j - 1, next_id++ });
+                }
+                if(!leaf_done) on_leaf(j - 1, m_stack.back().id);
+            }
+        }
+        DCHECK(m_stack.empty());
+    }
+
+    /// \brief Enumerates the lcp-intervals nested in a range of ranks.
+    ///
+    /// \param lcp the LCP array.
+    /// \param lb the first rank of the range.
+    /// \param rb the last rank of the range.
+    /// \param on_interval called with an \ref LCPInterval for each interval
+    ///                    in the range, in postorder.
+    template<typename lcp_t, typename interval_func_t>
+    inline void enumerate(const lcp_t& lcp, const size_t lb, const size_t rb,
+                          interval_func_t on_interval) {
+        enumerate(lcp, lb, rb, on_interval, [](size_t, size_t){});
+    }
+
+    /// \brief Splits a range of ranks into the ranges of the children of
+    ///        its interval.
+    ///
+    /// \param lcp the LCP array.
+    /// \param lb the first rank of the range.
+    /// \param rb the last rank of the range.
+    /// \param f called with the first and last rank of each child, in
+    ///          lexicographic order. Leaf children are single ranks.
+    template<typename lcp_t, typename range_func_t>
+    inline static void for_each_child_range(
+        const lcp_t& lcp, const size_t lb, const size_t rb, range_func_t f) {
+
+        DCHECK_LE(lb, rb);
+        size_t min = (lb < rb) ? size_t(lcp[lb + 1]) : 0;
+        for(size_t j = lb + 2; j <= rb; j++) min = std::min(min, size_t(lcp[j]));
+
+        size_t first = lb;
+        for(size_t j = lb + 1; j <= rb; j++) {
+            if(lcp[j] == min) {
+                f(first, j - 1);
+                first = j;
+            }
+        }
+        f(first, rb);
+    }
+};
+
+} //ns
+
@@ -36,10 +36,10 @@ public:
             // Use Phi algorithm to compute PLCP array
             m_max = 0;
             for(len_t i = 0, l = 0; i < n - 1; ++i) {
-                const len_t phii = (*this)[i];
+                const len_t phii = get(i);
                 while(t[i+l] == t[phii+l]) ++l;
                 m_max = std::max(m_max, l);
-                (*this)[i] = l;
+                set(i, l);
                 if(l) --l;
             }
 
@@ -49,6 +49,9 @@ public:
 
         if(cm == CompressMode::compressed || cm == CompressMode::delayed) {
             compress();
+        } else if(cm == CompressMode::aligned && cm_width(cm, bits_for(m_max)) < width()) {
+            width(cm_width(cm, bits_for(m_max)));
+            shrink_to_fit();
         }
     }
 
@@ -32,13 +32,13 @@ public:
 
         StatPhase::wrap("Construct Phi Array", [&]{
             // Construct Phi Array
-            set_array(iv_t(n, 0, (cm == CompressMode::compressed) ? w : INDEX_FAST_BITS));
+            set_array(iv_t(n, 0, cm_width(cm, w)));
 
             for(len_t i = 1, prev = sa[0]; i < n; i++) {
-                (*this)[sa[i]] = prev;
+                set(sa[i], prev);
                 prev = sa[i];
             }
-            (*this)[sa[0]] = sa[n-1];
+            set(sa[0], sa[n-1]);
 
             StatPhase::log("bit_width", size_t(width()));
             StatPhase::log("size", bit_size() / 8);
@@ -0,0 +1,296 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#ifdef __BMI2__
+#include <immintrin.h>
+#endif
+
+#include <tudocomp/util.hpp>
+#include <tudocomp/ds/IntVector.hpp>
+
+namespace tdc {
+
+/// \brief A static bit vector with rank and select support, whose bits and
+///        rank information are interleaved in cache lines.
+///
+/// The bits are copied into lines of 64 bytes. Each line consists of a
+/// header word followed by seven words of 448 bits of the bit vector.
+/// The header contains
+/// - the number of 1-bits before the line (superblock, 37 bits),
+/// - the number of 1-bits in the first two, four and six data words of the
+///   line (blocks, 8 + 9 + 9 bits).
+///
+/// Hence, a rank query needs the header and at most two words of the same
+/// line, which costs a single cache miss, and access to the bits themselves
+/// comes for free.
+///
+/// For select queries, the line of every 1024-th 1-bit and 0-bit is sampled.
+/// A query searches the line headers between two samples, then the blocks
+/// in the line and finally selects in a single word, using `pdep` if BMI2
+/// is available.
+///
+/// Unlike \ref Rank and \ref Select, the data structure does not keep a
+/// reference to the bit vector it was constructed for.
+class RankSelect {
+public:
+    /// The number of words in a line, including the header.
+    static constexpr size_t line_words = 8;
+
+    /// The number of bits of the bit vector stored in a line.
+    static constexpr size_t line_bits = 64 * (line_words - 1);
+
+    /// Every `select_sample`-th 1-bit (and 0-bit) has its line sampled.
+    static constexpr size_t select_sample = 1024;
+
+private:
+    static constexpr size_t abs_bits = 37;
+
+    // shifts and masks of the block counts in the header, by data word pair;
+    // the first pair has no count of its own
+    static constexpr uint8_t rel_shift(size_t pair) {
+        return pair == 0 ? 0 : uint8_t(abs_bits + (pair == 1 ? 0 : (pair == 2 ? 8 : 17)));
+    }
+
+    static constexpr uint64_t rel_mask(size_t pair) {
+        return pair == 0 ? 0 : (pair == 1 ? 0xFFULL : 0x1FFULL);
+    }
+
+    std::vector<uint64_t> m_storage;
+    uint64_t* m_lines; // m_storage aligned to a cache line
+
+    size_t m_size;
+    size_t m_num_lines;
+    size_t m_ones;
+
+    std::vector<uint64_t> m_hints1;
+    std::vector<uint64_t> m_hints0;
+
+    inline void align() {
+        const uintptr_t p = uintptr_t(m_storage.data());
+        m_lines = m_storage.data() + ((64 - p % 64) % 64) / sizeof(uint64_t);
+    }
+
+    inline const uint64_t* line(size_t l) const {
+        return m_lines + l * line_words;
+    }
+
+    inline uint64_t abs_rank1(size_t l) const {
+        return line(l)[0] & ((1ULL << abs_bits) - 1);
+    }
+
+    inline size_t rel_rank1(uint64_t header, size_t pair) const {
+        return (header >> rel_shift(pair)) & rel_mask(pair);
+    }
+
+    // the number of m_bit bits before line l
+    template<bool m_bit>
+    inline size_t abs_rank(size_t l) const {
+        const size_t r = abs_rank1(l);
+        return m_bit ? r : l * line_bits - r;
+    }
+
+    // the number of m_bit bits in the data words [0, 2 * pair) of a line
+    template<bool m_bit>
+    inline size_t rel_rank(uint64_t header, size_t pair) const {
+        const size_t r = rel_rank1(header, pair);
+        return m_bit ? r : 2 * pair * 64 - r;
+    }
+
+    /// \brief Finds the position of the k-th 1-bit in the given word.
+    inline static uint8_t word_select1(uint64_t v, size_t k) {
+        DCHECK_GT(k, 0U);
+        DCHECK_LE(k, size_t(__builtin_popcountll(v)));
+#ifdef __BMI2__
+        return uint8_t(__builtin_ctzll(_pdep_u64(1ULL << (k - 1), v)));
+#else
+        uint8_t pos = 0;
+        size_t c;
+        while((c = __builtin_popcountll(v & 0xFF)) < k) {
+            k -= c;
+            v >>= 8;
+            pos += 8;
+        }
+        for(;; v >>= 1, ++pos) {
+            if((v & 1) && --k == 0) return pos;
+        }
+#endif
+    }
+
+    template<bool m_bit>
+    inline size_t select(size_t k) const {
+        DCHECK_GT(k, 0U) << "order must be at least one";
+        if(k > (m_bit ? m_ones : m_size - m_ones)) return m_size;
+
+        const std::vector<uint64_t>& hints = m_bit ? m_hints1 : m_hints0;
+
+        // find the last line with less than k bits before it
+        const size_t s = (k - 1) / select_sample;
+        size_t lo = hints[s];
+        size_t hi = (s + 1 < hints.size()) ? hints[s + 1] : m_num_lines - 1;
+        while(hi - lo > 8) {
+            const size_t mid = lo + (hi - lo + 1) / 2;
+            if(abs_rank<m_bit>(mid) < k) lo = mid; else hi = mid - 1;
+        }
+        while(lo < hi && abs_rank<m_bit>(lo + 1) < k) ++lo;
+
+        const uint64_t* data = line(lo);
+        k -= abs_rank<m_bit>(lo);
+
+        // find the pair of data words, then the word
+        const uint64_t header = data[0];
+        size_t pair = 3;
+        while(pair > 0 && rel_rank<m_bit>(header, pair) >= k) --pair;
+        k -= rel_rank<m_bit>(header, pair);
+
+        size_t w = 2 * pair;
+        uint64_t v = m_bit ? data[1 + w] : ~data[1 + w];
+        const size_t c = __builtin_popcountll(v);
+        if(c < k) {
+            k -= c;
+            ++w;
+            v = m_bit ? data[1 + w] : ~data[1 + w];
+        }
+        return lo * line_bits + w * 64 + word_select1(v, k);
+    }
+
+public:
+    /// \brief Constructs an empty data structure.
+    inline RankSelect() : m_lines(nullptr), m_size(0), m_num_lines(0), m_ones(0) {
+    }
+
+    /// \brief Copy constructor.
+    inline RankSelect(const RankSelect& other)
+        : m_storage(other.m_storage.size()),
+          m_size(other.m_size),
+          m_num_lines(other.m_num_lines),
+          m_ones(other.m_ones),
+          m_hints1(other.m_hints1),
+          m_hints0(other.m_hints0) {
+        // the copy may be aligned at a different offset
+        align();
+        std::copy(other.m_lines, other.m_lines + m_num_lines * line_words, m_lines);
+    }
+
+    /// \brief Move constructor.
+    inline RankSelect(RankSelect&& other) = default;
+
+    /// \brief Copy assignment.
+    inline RankSelect& operator=(const RankSelect& other) {
+        *this = RankSelect(other);
+        return *this;
+    }
+
+    /// \brief Move assignment.
+    inline RankSelect& operator=(RankSelect&& other) = default;
+
+    /// \brief Constructs the data structure for the given bit vector.
+    ///
+    /// The bits are copied, so the bit vector may be discarded afterwards.
+    ///
+    /// \param bv the bit vector
+    inline RankSelect(const BitVector& bv)
+        : m_size(bv.size()),
+          m_num_lines(std::max<size_t>(1, idiv_ceil(bv.size(), line_bits))),
+          m_ones(0) {
+
+        m_storage.resize(m_num_lines * line_words + line_words - 1, 0);
+        align();
+
+        const uint64_t* bits = bv.data();
+        const size_t num_words = idiv_ceil(m_size, 64);
+
+        size_t next1 = 1, next0 = 1; // the next bits to sample
+        for(size_t l = 0; l < m_num_lines; ++l) {
+            uint64_t* data = m_lines + l * line_words;
+            DCHECK_LT(m_ones, 1ULL << abs_bits) << "too many 1-bits";
+
+            uint64_t header = m_ones;
+            size_t rel = 0;
+            for(size_t w = 0; w < line_words - 1; ++w) {
+                if(w > 0 && w % 2 == 0) header |= uint64_t(rel) << rel_shift(w / 2);
+
+                const size_t i = l * (line_words - 1) + w;
+                uint64_t v = (i < num_words) ? bits[i] : 0;
+                if(i + 1 == num_words && m_size % 64 != 0) {
+                    v &= (1ULL << (m_size % 64)) - 1; // clear padding
+                }
+                data[1 + w] = v;
+                rel += __builtin_popcountll(v);
+            }
+            data[0] = header;
+
+            const size_t ones = m_ones + rel;
+            const size_t zeros = std::min(m_size, (l + 1) * line_bits) - ones;
+            for(; next1 <= ones; next1 += select_sample) m_hints1.push_back(l);
+            for(; next0 <= zeros; next0 += select_sample) m_hints0.push_back(l);
+            m_ones = ones;
+        }
+    }
+
+    /// \brief The number of bits.
+    inline size_t size() const {
+        return m_size;
+    }
+
+    /// \brief Reads the bit at the given position.
+    inline bool operator[](size_t x) const {
+        DCHECK_LT(x, m_size);
+        return (line(x / line_bits)[1 + (x % line_bits) / 64] >> (x % 64)) & 1;
+    }
+
+    /// \brief Counts the amount of 1-bits from the beginning of the bit vector
+    ///        up to (including) the given position.
+    /// \param x the position up to which to count (inclusively)
+    /// \return the amount of counted 1-bits
+    inline size_t rank1(size_t x) const {
+        DCHECK_LT(x, m_size);
+        const uint64_t* data = line(x / line_bits);
+        const size_t o = x % line_bits;
+        const size_t w = o / 64;
+
+        const uint64_t header = data[0];
+        size_t r = (header & ((1ULL << abs_bits) - 1)) + rel_rank1(header, w / 2);
+        if(w % 2) r += __builtin_popcountll(data[w]);
+        return r + __builtin_popcountll(data[1 + w] << (63 - o % 64));
+    }
+
+    /// \see rank1
+    inline size_t operator()(size_t x) const {
+        return rank1(x);
+    }
+
+    /// \brief Counts the amount of 0-bits from the beginning of the bit vector
+    ///        up to (including) the given position.
+    /// \param x the position up to which to count (inclusively)
+    /// \return the amount of counted 0-bits
+    inline size_t rank0(size_t x) const {
+        return x + 1 - rank1(x);
+    }
+
+    /// \brief Finds the position of the k-th 1-bit.
+    /// \param k the order of the 1-bit to find, at least one
+    /// \return the position of the k-th 1-bit, or the size of the bit vector
+    ///         if there are less than k 1-bits.
+    inline size_t select1(size_t k) const {
+        return select<1>(k);
+    }
+
+    /// \brief Finds the position of the k-th 0-bit.
+    /// \param k the order of the 0-bit to find, at least one
+    /// \return the position of the k-th 0-bit, or the size of the bit vector
+    ///         if there are less than k 0-bits.
+    inline size_t select0(size_t k) const {
+        return select<0>(k);
+    }
+
+    /// \brief The size of the data structure in bytes.
+    inline size_t size_in_bytes() const {
+        return sizeof(uint64_t) *
+            (m_storage.size() + m_hints1.size() + m_hints0.size());
+    }
+};
+
+}
@@ -34,7 +34,7 @@ public:
             const size_t w = bits_for(n);
 
             // divsufsort needs one additional bit for signs
-            set_array(iv_t(n, 0, (cm == CompressMode::compressed) ? w + 1 : INDEX_FAST_BITS));
+            set_array(iv_t(n, 0, cm_width(cm, w + 1)));
             //std::cout << w << "\n";
             //std::cout << INDEX_FAST_BITS << "\n";
 
@@ -47,6 +47,10 @@ public:
 
         if(cm == CompressMode::compressed || cm == CompressMode::delayed) {
             compress();
+        } else if(cm == CompressMode::aligned && cm_width(cm, bits_for(size())) < width()) {
+            // drop the byte needed only for the sign bit
+            width(cm_width(cm, bits_for(size())));
+            shrink_to_fit();
         }
     }
 
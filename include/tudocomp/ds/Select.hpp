@@ -2,6 +2,7 @@
 
 #include <tudocomp/ds/select_64bit.hpp>
 #include <tudocomp/ds/IntVector.hpp>
+#include <tudocomp/ds/StaticWidthView.hpp>
 #include <tudocomp/ds/Rank.hpp>
 
 namespace tdc {
@@ -120,57 +121,61 @@ public:
 
         size_t cur_b = 0; // current block
 
-        auto data = bv.data();
-        for(size_t i = 0; i < idiv_ceil(n, data_w); i++) {
-            const auto v = data[i];
-            const uint8_t r = basic_rank(v);
-            m_max += r;
+        // the blocks and superblocks have the same width,
+        // so the construction is instantiated for it
+        with_static_width(m_supblocks, m_blocks, [&](auto supblocks, auto&& blocks) {
+            auto data = bv.data();
+            for(size_t i = 0; i < idiv_ceil(n, data_w); i++) {
+                const auto v = data[i];
+                const uint8_t r = basic_rank(v);
+                m_max += r;
 
-            if(r_b + r >= m_block_size) {
-                // entered new block
+                if(r_b + r >= m_block_size) {
+                    // entered new block
 
-                // amount of bits needed to fill current block
-                size_t distance_b = m_block_size - r_b;
+                    // amount of bits needed to fill current block
+                    size_t distance_b = m_block_size - r_b;
 
-                // stores the offset of the last bit in the current block
-                uint8_t offs = 0;
+                    // stores the offset of the last bit in the current block
+                    uint8_t offs = 0;
 
-                r_b += r;
+                    r_b += r;
 
-                size_t distance_sum = 0;
-                while(r_b >= m_block_size) {
-                    // find exact position of the bit in question
-                    offs = basic_select(v, offs, distance_b);
-                    DCHECK_NE(SELECT_FAIL, offs);
+                    size_t distance_sum = 0;
+                    while(r_b >= m_block_size) {
+                        // find exact position of the bit in question
+                        offs = basic_select(v, offs, distance_b);
+                        DCHECK_NE(SELECT_FAIL, offs);
 
-                    const size_t pos = i * data_w + offs;
+                        const size_t pos = i * data_w + offs;
 
-                    distance_sum += distance_b;
-                    r_sb += distance_b;
-                    if(r_sb >= m_supblock_size) {
-                        // entered new superblock
-                        longest_sb = std::max(longest_sb, pos - cur_sb_offset);
-                        cur_sb_offset = pos;
+                        distance_sum += distance_b;
+                        r_sb += distance_b;
+                        if(r_sb >= m_supblock_size) {
+                            // entered new superblock
+                            longest_sb = std::max(longest_sb, pos - cur_sb_offset);
+                            cur_sb_offset = pos;
 
-                        m_supblocks[cur_sb++] = pos;
+                            supblocks[cur_sb++] = pos;
 
-                        r_sb -= m_supblock_size;
-                    }
+                            r_sb -= m_supblock_size;
+                        }
 
-                    m_blocks[cur_b++] = pos - cur_sb_offset;
-                    r_b -= m_block_size;
-                    distance_b = m_block_size;
+                        blocks[cur_b++] = pos - cur_sb_offset;
+                        r_b -= m_block_size;
+                        distance_b = m_block_size;
 
-                    ++offs;
-                }
+                        ++offs;
+                    }
 
-                DCHECK_GE(size_t(r), distance_sum);
-                r_sb += r - distance_sum;
-            } else {
-                r_b  += r;
-                r_sb += r;
+                    DCHECK_GE(size_t(r), distance_sum);
+                    r_sb += r - distance_sum;
+                } else {
+                    r_b  += r;
+                    r_sb += r;
+                }
             }
-        }
+        });
 
         longest_sb = std::max(longest_sb, n - cur_sb_offset);
         const size_t w_block = bits_for(longest_sb);
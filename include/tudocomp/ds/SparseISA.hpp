@@ -1,11 +1,13 @@
 #pragma once
 
 #include <assert.h>
+#include <algorithm>
 #include <type_traits>
 
 #include <tudocomp/ds/TextDSFlags.hpp>
 #include <tudocomp/ds/CompressMode.hpp>
-#include <tudocomp/ds/Rank.hpp>
+#include <tudocomp/ds/RankSelect.hpp>
+#include <tudocomp/ds/StaticWidthView.hpp>
 
 #include <tudocomp_stat/StatPhase.hpp>
 
@@ -21,11 +23,110 @@ public:
 private:
     const sa_t* m_sa;
 
-    BitVector m_has_shortcut;
-    Rank      m_rank;
+    // marks the positions that have a shortcut, the rank of a mark is the
+    // index of the shortcut in m_shortcuts
+    RankSelect m_has_shortcut;
 
     iv_t m_shortcuts;
 
+    size_t m_t;
+
+    /// The number of walks advanced together by \ref lookup.
+    static constexpr size_t LOOKUP_LANES = 16;
+
+    // answers the queries for the positions pos(0), ..., pos(m-1) with walks
+    // along the cycles, advancing several of them in turns such that their
+    // memory accesses overlap
+    template<typename pos_f, typename out_t>
+    inline void lookup_walk(pos_f pos, size_t m, out_t* out) const {
+        struct Walk {
+            size_t q; // the query
+            size_t i; // the position
+            size_t j; // the current position in the cycle
+            bool   s; // whether a shortcut may be taken
+        };
+
+        Walk walks[LOOKUP_LANES];
+        size_t next = 0;
+        auto start = [&](Walk& w) {
+            w.q = next;
+            w.i = w.j = pos(next++);
+            w.s = true;
+        };
+
+        size_t active = 0;
+        while(active < LOOKUP_LANES && next < m) start(walks[active++]);
+
+        while(active > 0) {
+            for(size_t a = 0; a < active;) {
+                Walk& w = walks[a];
+                const size_t v = (*m_sa)[w.j];
+                if(v == w.i) {
+                    out[w.q] = w.j;
+                    if(next < m) {
+                        start(w);
+                    } else {
+                        w = walks[--active];
+                        continue;
+                    }
+                } else if(w.s && m_has_shortcut[w.j]) {
+                    w.j = m_shortcuts[m_has_shortcut.rank1(w.j)-1];
+                    w.s = false;
+                } else {
+                    w.j = v;
+                }
+                ++a;
+            }
+        }
+    }
+
+    // answers the queries for the sorted positions pos(0), ..., pos(m-1)
+    // with a single scan over the suffix array, range tells whether the
+    // positions are consecutive
+    template<typename pos_f, typename out_t>
+    inline void lookup_scan(pos_f pos, size_t m, out_t* out, bool range) const {
+        const size_t n = size();
+        const size_t lo = pos(0);
+        const size_t span = pos(m-1) - lo + 1;
+
+        // scans the suffix array in chunks, calling f(j - lo, p)
+        // for every entry sa[p] = j within the span of the queries
+        auto scan = [&](auto f) {
+            constexpr size_t chunk = 4096;
+            uint64_t buffer[chunk];
+            for(size_t p = 0; p < n; p += chunk) {
+                const size_t len = std::min(chunk, n - p);
+                m_sa->get_range(p, len, buffer);
+                for(size_t k = 0; k < len; k++) {
+                    const uint64_t d = buffer[k] - lo;
+                    if(d < span) f(d, p + k);
+                }
+            }
+        };
+
+        if(range) {
+            scan([&](size_t d, size_t p) { out[d] = p; });
+        } else {
+            // the rank of a position among the distinct positions is the
+            // index of its first query
+            BitVector marks(span);
+            for(size_t k = 0; k < m; k++) marks[pos(k) - lo] = 1;
+            const RankSelect rank(marks);
+
+            scan([&](size_t d, size_t p) {
+                if(rank[d]) out[rank.rank1(d) - 1] = p;
+            });
+
+            // spread the answers from the distinct positions to the queries,
+            // back to front such that no answer is overwritten before it is read
+            size_t i = rank.rank1(span - 1);
+            for(size_t k = m; k > 0; k--) {
+                out[k-1] = out[i-1];
+                if(k > 1 && pos(k-1) != pos(k-2)) --i;
+            }
+        }
+    }
+
 public:
     inline static Meta meta() {
         Meta m("isa", "sparse_isa");
@@ -50,57 +151,62 @@ public:
         m_sa = &tds.require_sa(cm);
 
         const size_t n = m_sa->size();
-        m_has_shortcut = BitVector(n);
+        BitVector has_shortcut(n);
 
         const size_t t = this->env().option("t").as_integer();
+        m_t = t;
 
         // Construct
         StatPhase::wrap("Construct sparse ISA", [&]{
             auto v = BitVector(n);
-            for(size_t i = 0; i < n; i++) {
-                if(!v[i]) {
-                    // new cycle
-                    v[i] = 1;
-                    size_t j = (*m_sa)[i];
-                    size_t k = 1;
-
-                    while(j != i) {
-                        if((k % t) == 0) {
-                            m_has_shortcut[j] = 1;
+            with_static_width(*m_sa, [&](auto sa) {
+                for(size_t i = 0; i < n; i++) {
+                    if(!v[i]) {
+                        // new cycle
+                        v[i] = 1;
+                        size_t j = sa[i];
+                        size_t k = 1;
+
+                        while(j != i) {
+                            if((k % t) == 0) {
+                                has_shortcut[j] = 1;
+                            }
+
+                            v[j] = 1;
+                            j = sa[j];
+                            ++k;
                         }
 
-                        v[j] = 1;
-                        j = (*m_sa)[j];
-                        ++k;
+                        if(k > t) has_shortcut[i] = 1;
                     }
-
-                    if(k > t) m_has_shortcut[i] = 1;
                 }
-            }
+            });
 
-            m_rank = Rank(m_has_shortcut);
-            m_shortcuts = DynamicIntVector(m_rank(n-1), 0, bits_for(n));
+            m_has_shortcut = RankSelect(has_shortcut);
+            m_shortcuts = DynamicIntVector(m_has_shortcut.rank1(n-1), 0, bits_for(n));
+
+            with_static_width(*m_sa, m_shortcuts, [&](auto sa, auto&& shortcuts) {
+                for(size_t i = 0; i < n; i++) {
+                    if(v[i]) {
+                        v[i] = 0;
+                        size_t j = sa[i];
+                        while(v[j]) {
+                            if(m_has_shortcut[j]) {
+                                shortcuts[m_has_shortcut.rank1(j)-1] = i;
+                                i = j;
+                            }
+                            v[j] = 0;
+                            j = sa[j];
+                        }
 
-            for(size_t i = 0; i < n; i++) {
-                if(v[i]) {
-                    v[i] = 0;
-                    size_t j = (*m_sa)[i];
-                    while(v[j]) {
                         if(m_has_shortcut[j]) {
-                            m_shortcuts[m_rank(j)-1] = i;
-                            i = j;
+                            shortcuts[m_has_shortcut.rank1(j)-1] = i;
                         }
-                        v[j] = 0;
-                        j = (*m_sa)[j];
-                    }
 
-                    if(m_has_shortcut[j]) {
-                        m_shortcuts[m_rank(j)-1] = i;
+                        i = j;
                     }
-
-                    i = j;
                 }
-            }
+            });
         });
     }
 
@@ -111,7 +217,7 @@ public:
 
         while((*m_sa)[j] != i) {
             if(s && m_has_shortcut[j]) {
-                j = m_shortcuts[m_rank(j)-1];
+                j = m_shortcuts[m_has_shortcut.rank1(j)-1];
                 s = false;
             } else {
                 j = (*m_sa)[j];
@@ -120,6 +226,43 @@ public:
         return j;
     }
 
+    /// \brief Looks up the entries at the given positions.
+    ///
+    /// Single lookups need up to `2t` steps along a cycle of the suffix
+    /// array, each a random access. The lookups of a batch are walked
+    /// together, such that the accesses of different walks can be served
+    /// in parallel by the memory. If the positions are sorted and there are
+    /// more than `n / 64t` of them, they are answered by a sequential scan
+    /// over the suffix array instead.
+    ///
+    /// \param positions the positions to look up.
+    /// \param m the number of positions.
+    /// \param out receives the entry of the k-th position at index k.
+    template<typename pos_t, typename out_t>
+    inline void lookup(const pos_t* positions, size_t m, out_t* out) const {
+        if(m == 0) return;
+        auto pos = [&](size_t k) -> size_t { return positions[k]; };
+        if(m * 64 * m_t > size() && std::is_sorted(positions, positions + m)) {
+            lookup_scan(pos, m, out, false);
+        } else {
+            lookup_walk(pos, m, out);
+        }
+    }
+
+    /// \brief Looks up the entries at the positions `[from, from + m)`.
+    ///
+    /// \see lookup
+    template<typename out_t>
+    inline void lookup_range(size_t from, size_t m, out_t* out) const {
+        if(m == 0) return;
+        auto pos = [&](size_t k) -> size_t { return from + k; };
+        if(m * 64 * m_t > size()) {
+            lookup_scan(pos, m, out, true);
+        } else {
+            lookup_walk(pos, m, out);
+        }
+    }
+
     inline void compress() {
         // nothing to do, already sparse :-)
     }
@@ -143,4 +286,41 @@ public:
     }
 };
 
+/// \brief Looks up the entries of an inverse suffix array at the given
+///        positions.
+///
+/// Generic version that reads the entries one by one.
+///
+/// \param isa the inverse suffix array.
+/// \param positions the positions to look up.
+/// \param m the number of positions.
+/// \param out receives the entry of the k-th position at index k.
+template<typename isa_t, typename pos_t, typename out_t>
+inline void isa_lookup(const isa_t& isa, const pos_t* positions, size_t m, out_t* out) {
+    for(size_t k = 0; k < m; k++) out[k] = isa[positions[k]];
+}
+
+/// \brief Looks up the entries of a \ref SparseISA at the given positions
+///        in a batch, see \ref SparseISA::lookup.
+template<typename sa_t, typename pos_t, typename out_t>
+inline void isa_lookup(const SparseISA<sa_t>& isa, const pos_t* positions, size_t m, out_t* out) {
+    isa.lookup(positions, m, out);
+}
+
+/// \brief Looks up the entries of an inverse suffix array at the positions
+///        `[from, from + m)`.
+///
+/// Generic version that reads the entries one by one.
+template<typename isa_t, typename out_t>
+inline void isa_lookup_range(const isa_t& isa, size_t from, size_t m, out_t* out) {
+    for(size_t k = 0; k < m; k++) out[k] = isa[from + k];
+}
+
+/// \brief Looks up the entries of a \ref SparseISA at the positions
+///        `[from, from + m)` in a batch, see \ref SparseISA::lookup.
+template<typename sa_t, typename out_t>
+inline void isa_lookup_range(const SparseISA<sa_t>& isa, size_t from, size_t m, out_t* out) {
+    isa.lookup_range(from, m, out);
+}
+
 } //ns
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include <tudocomp/ds/IntVector.hpp>
+#include <tudocomp/ds/BitPackingKernels.hpp>
+
+#include <glog/logging.h>
+
+namespace tdc {
+
+/// \brief A view of the elements of a \ref DynamicIntVector whose bit width
+///        `W` is known at compile time.
+///
+/// Element access works like on the vector itself, but all shifts and masks
+/// are constants that the compiler can fold. Views are obtained via
+/// \ref with_static_width, which instantiates a function once for each
+/// possible width and calls the one matching the vector's width.
+///
+/// The view does not own the elements and is invalidated when the vector is
+/// resized or its width changes.
+///
+/// \tparam W the bit width of the elements.
+/// \tparam word_t the type of the backing words, `const uint64_t` for a
+///                read-only view.
+template<size_t W, typename word_t = uint64_t>
+class StaticWidthView {
+    static_assert(W >= 1 && W <= 64, "invalid bit width");
+
+    word_t* m_words;
+    size_t m_size;
+
+public:
+    /// \brief A reference to an element of a mutable view.
+    class Ref {
+        uint64_t* m_words;
+        uint64_t m_bit;
+
+    public:
+        inline Ref(uint64_t* words, uint64_t bit) : m_words(words), m_bit(bit) {}
+
+        inline operator uint64_t() const {
+            return int_vector::kernels::read<W>(m_words, m_bit);
+        }
+
+        inline Ref& operator=(uint64_t v) {
+            int_vector::kernels::write<W>(m_words, m_bit, v);
+            return *this;
+        }
+
+        inline Ref& operator=(const Ref& other) {
+            return (*this = uint64_t(other));
+        }
+    };
+
+    inline StaticWidthView(word_t* words, size_t size)
+        : m_words(words), m_size(size) {
+    }
+
+    /// \brief The bit width of the elements.
+    inline static constexpr uint8_t width() { return W; }
+
+    /// \brief The number of elements.
+    inline size_t size() const { return m_size; }
+
+    /// \brief Reads the i-th element.
+    template<typename X = word_t>
+    inline std::enable_if_t<std::is_const<X>::value, uint64_t>
+    operator[](size_t i) const {
+        DCHECK_LT(i, m_size);
+        return int_vector::kernels::read<W>(m_words, uint64_t(i) * W);
+    }
+
+    /// \brief Accesses the i-th element.
+    template<typename X = word_t>
+    inline std::enable_if_t<!std::is_const<X>::value, Ref>
+    operator[](size_t i) const {
+        DCHECK_LT(i, m_size);
+        return Ref(m_words, uint64_t(i) * W);
+    }
+};
+
+/// \brief A read-only \ref StaticWidthView.
+template<size_t W>
+using ConstStaticWidthView = StaticWidthView<W, const uint64_t>;
+
+/// \brief Creates a \ref StaticWidthView of the given vector, whose width
+///        must be `W`.
+template<size_t W>
+inline StaticWidthView<W> static_width_view(DynamicIntVector& vec) {
+    DCHECK_EQ(size_t(vec.width()), W);
+    return StaticWidthView<W>(vec.data(), vec.size());
+}
+
+/// \copydoc static_width_view
+template<size_t W>
+inline ConstStaticWidthView<W> static_width_view(const DynamicIntVector& vec) {
+    DCHECK_EQ(size_t(vec.width()), W);
+    return ConstStaticWidthView<W>(vec.data(), vec.size());
+}
+
+/// \brief Calls `f(std::integral_constant<size_t, W>())` with `W` equal to
+///        the given bit width.
+///
+/// The function is instantiated for every width from 1 to 64.
+template<typename F>
+inline void with_static_width(uint8_t width, F&& f) {
+    int_vector::kernels::dispatch_width(width, f);
+}
+
+/// \brief Calls `f` with a \ref StaticWidthView of the given vector.
+///
+/// The function is instantiated for every width from 1 to 64, so loops
+/// over the elements in `f` are compiled for the specific width of the
+/// vector.
+///
+/// Example:
+/// \code
+/// with_static_width(vec, [&](auto v) {
+///     for(size_t i = 1; i < v.size(); i++) v[i] = v[i - 1] + 1;
+/// });
+/// \endcode
+template<typename F>
+inline void with_static_width(DynamicIntVector& vec, F&& f) {
+    with_static_width(vec.width(), [&](auto w) {
+        f(static_width_view<decltype(w)::value>(vec));
+    });
+}
+
+/// \copydoc with_static_width(DynamicIntVector&, F&&)
+template<typename F>
+inline void with_static_width(const DynamicIntVector& vec, F&& f) {
+    with_static_width(vec.width(), [&](auto w) {
+        f(static_width_view<decltype(w)::value>(vec));
+    });
+}
+
+/// \brief Calls `f` with views of two vectors.
+///
+/// If both vectors have the same width, `f` is called with a
+/// \ref StaticWidthView of each. Otherwise, only the first vector is viewed
+/// with a static width and the second one is passed as it is, which avoids
+/// instantiating `f` for every combination of widths. `f` should hence take
+/// its second parameter as `auto&&`, or writes to it may go to a copy.
+template<typename vec1_t, typename vec2_t, typename F>
+inline void with_static_width(vec1_t& vec1, vec2_t& vec2, F&& f) {
+    if(vec1.width() == vec2.width()) {
+        with_static_width(vec1.width(), [&](auto w) {
+            f(static_width_view<decltype(w)::value>(vec1),
+              static_width_view<decltype(w)::value>(vec2));
+        });
+    } else {
+        with_static_width(vec1, [&](auto view1) {
+            f(view1, vec2);
+        });
+    }
+}
+
+} //ns
+
@@ -142,6 +142,8 @@ public:
             m_cm = CompressMode::delayed;
         } else if(cm_str == "compressed") {
             m_cm = CompressMode::compressed;
+        } else if(cm_str == "aligned") {
+            m_cm = CompressMode::aligned;
         } else {
             m_cm = CompressMode::plain;
         }
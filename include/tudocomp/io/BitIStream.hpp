@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <climits>
 #include <cstdint>
 #include <iostream>
@@ -115,19 +116,50 @@ public:
     ///               equals the bit width of type \c T.
     /// \return The integer value of the next \c amount bits in MSB first
     ///         order.
+    ///
+    /// The bits are read in chunks of the remaining bits of the current
+    /// byte, only the bits of the final byte are read one by one.
     template<class T>
     inline T read_int(size_t amount = sizeof(T) * CHAR_BIT) {
-        T value = 0;
-        for(size_t i = 0; i < amount; i++) {
-            value <<= 1;
-            value |= read_bit();
+        uint64_t value = 0;
+        while(amount > 0 && !m_is_final) {
+            const size_t k = std::min<size_t>(amount, m_cursor + 1);
+            amount -= k;
+            value = (value << k) |
+                ((m_current >> (m_cursor + 1 - k)) & ((1U << k) - 1U));
+            if(k > m_cursor) {
+                read_next();
+            } else {
+                m_cursor -= k;
+            }
+        }
+        for(; amount > 0; --amount) {
+            value = (value << 1) | read_bit();
         }
-        return value;
+        return T(value);
     }
 
     template<typename value_t>
     inline value_t read_unary() {
         value_t v = 0;
+        // skip the zero bits of each byte at once and find the terminating
+        // one bit by counting leading zeros
+        while(!m_is_final) {
+            const uint8_t rest = m_current & uint8_t((2U << m_cursor) - 1U);
+            if(rest == 0) {
+                v += m_cursor + 1;
+                read_next();
+            } else {
+                const uint8_t one = bits_hi(rest) - 1;
+                v += m_cursor - one;
+                if(one == 0) {
+                    read_next();
+                } else {
+                    m_cursor = one - 1;
+                }
+                return v;
+            }
+        }
         while(!read_bit()) ++v;
         return v;
     }
@@ -1,8 +1,11 @@
 #pragma once
 
+#include <algorithm>
 #include <climits>
 #include <cstdint>
+#include <deque>
 #include <iostream>
+#include <vector>
 #include <tudocomp/util.hpp>
 #include <tudocomp/io/Output.hpp>
 
@@ -14,6 +17,10 @@ namespace io {
 ///
 /// Bits are written into a buffer byte, which is written to the output when
 /// it is either filled or when a flush is explicitly requested.
+///
+/// A part of the output can be reserved to be written later (see
+/// \ref reserve). Everything written after it is withheld in memory until
+/// the reserved part has been written.
 class BitOStream {
     OutputStream m_stream;
 
@@ -21,6 +28,23 @@ class BitOStream {
     uint8_t m_next;
     int m_cursor;
 
+    // a withheld part of the output
+    struct Deferred {
+        std::vector<uint8_t> bytes;
+        uint8_t next = 0;
+        int cursor = 7;
+        bool dirty = false;
+        bool reserved = false; // not written yet
+    };
+
+    // the withheld parts in output order, starting with a reserved one
+    std::deque<Deferred> m_deferred;
+    size_t m_num_written = 0; // the number of reserved parts written so far
+
+    // the part that the buffer byte belongs to, or null for the output
+    Deferred* m_target = nullptr;
+    Deferred m_head; // the buffer byte of the output while withholding
+
     inline void reset() {
         const int MSB = 7;
 
@@ -31,11 +55,45 @@ class BitOStream {
 
     inline void write_next() {
         if (m_dirty) {
-            m_stream.put(char(m_next));
+            if(m_target) {
+                m_target->bytes.push_back(m_next);
+            } else {
+                m_stream.put(char(m_next));
+            }
             reset();
         }
     }
 
+    inline void save(Deferred& d) const {
+        d.next = m_next;
+        d.cursor = m_cursor;
+        d.dirty = m_dirty;
+    }
+
+    inline void load(const Deferred& d) {
+        m_next = d.next;
+        m_cursor = d.cursor;
+        m_dirty = d.dirty;
+    }
+
+    // writes the withheld parts up to the first reserved one to the output,
+    // the buffer byte must be the output's
+    inline void write_deferred() {
+        while(!m_deferred.empty() && !m_deferred.front().reserved) {
+            const Deferred& d = m_deferred.front();
+            for(uint8_t b : d.bytes) write_int(b, 8);
+            if(d.cursor < 7) write_int(d.next >> (d.cursor + 1), 7 - d.cursor);
+            m_deferred.pop_front();
+            ++m_num_written;
+        }
+
+        if(!m_deferred.empty()) {
+            save(m_head);
+            m_target = &m_deferred.back();
+            load(*m_target);
+        }
+    }
+
 public:
     /// \brief Constructs a bitwise output stream.
     ///
@@ -51,6 +109,8 @@ public:
     }
 
     ~BitOStream() {
+        DCHECK(m_deferred.empty()) << "a reserved part was never written";
+
         char set = 7 - m_cursor;
         if(m_cursor >= 2) {
             m_next |= set;
@@ -67,13 +127,72 @@ public:
     ///        which should equal the amount of bytes written to it.
     ///
     /// Note that this value does not include bits that have not yet been
-    /// flushed.
+    /// flushed or that are withheld behind a reserved part.
     ///
     /// \return the output position indicator of the underlying stream
     inline auto tellp() -> decltype(m_stream.tellp()) {
         return m_stream.tellp();
     }
 
+    /// \brief Reserves a part of the output at the current position.
+    ///
+    /// The part is written later using \ref write_reserved. Until then, all
+    /// following output is withheld in memory. This allows a coder that
+    /// buffers values (e.g., to code them in reverse or to terminate a code)
+    /// to put its code in front of the values that other coders write to
+    /// the same stream in the meantime, where the decoder expects it.
+    ///
+    /// \return the identifier of the reserved part.
+    inline size_t reserve() {
+        save(m_target ? *m_target : m_head);
+
+        m_deferred.emplace_back();
+        m_deferred.back().reserved = true;
+        const size_t part = m_num_written + m_deferred.size() - 1;
+
+        m_deferred.emplace_back();
+        m_target = &m_deferred.back();
+        reset();
+        return part;
+    }
+
+    /// \brief Writes a reserved part of the output.
+    ///
+    /// If all parts reserved before have been written, the part is written
+    /// directly to the output, followed by the output withheld behind it.
+    ///
+    /// \param part The identifier returned by \ref reserve.
+    /// \param write A function that writes the part to the \c BitOStream
+    ///              passed to it. It must not reserve other parts.
+    template<typename writer_t>
+    inline void write_reserved(size_t part, writer_t write) {
+        DCHECK_GE(part, m_num_written);
+        DCHECK_LT(part - m_num_written, m_deferred.size());
+        Deferred& d = m_deferred[part - m_num_written];
+        DCHECK(d.reserved) << "the part was already written";
+
+        save(*m_target);
+        if(part == m_num_written) {
+            // the first reserved part, write to the output
+            m_deferred.pop_front();
+            ++m_num_written;
+
+            m_target = nullptr;
+            load(m_head);
+            write(*this);
+            write_deferred();
+        } else {
+            m_target = &d;
+            reset();
+            write(*this);
+            save(d);
+            d.reserved = false;
+
+            m_target = &m_deferred.back();
+            load(*m_target);
+        }
+    }
+
     /// \brief Writes a single bit to the output.
     /// \param set The bit value (0 or 1).
     inline void write_bit(bool set) {
@@ -94,17 +213,36 @@ public:
     /// \param value The integer to write.
     /// \param bits The amount of low bits of the value to write. By default,
     ///             this equals the bit width of type \c T.
+    ///
+    /// The bits are written in chunks that fill up the current byte.
     template<class T>
     inline void write_int(T value, size_t bits = sizeof(T) * CHAR_BIT) {
-        for (int i = bits - 1; i >= 0; i--) {
-            write_bit((value & T(T(1) << i)) != T(0));
+        const uint64_t v = uint64_t(value);
+        while(bits > 0) {
+            const int k = std::min<int>(bits, m_cursor + 1);
+            bits -= k;
+            const uint8_t chunk = (v >> bits) & ((1U << k) - 1U);
+            m_next |= chunk << (m_cursor + 1 - k);
+            m_cursor -= k;
+            m_dirty = true;
+            if (m_cursor < 0) {
+                write_next();
+            }
         }
     }
 
     template<typename value_t>
     inline void write_unary(value_t v) {
-        while(v--) {
-            write_bit(0);
+        // skip the zero bits of each byte at once
+        uint64_t zeros = v;
+        while(zeros > 0) {
+            const int k = std::min<uint64_t>(zeros, m_cursor + 1);
+            zeros -= k;
+            m_cursor -= k;
+            m_dirty = true;
+            if (m_cursor < 0) {
+                write_next();
+            }
         }
 
         write_bit(1);
@@ -124,8 +262,14 @@ public:
 
     template<typename value_t>
     inline void write_elias_gamma(value_t v) {
-        write_unary(bits_for(v));
-        write_int(v, bits_for(v));
+        const size_t b = bits_for(v);
+        if(b < 32) {
+            // the unary length and the value in one go
+            write_int((uint64_t(1) << b) | uint64_t(v), 2 * b + 1);
+        } else {
+            write_unary(b);
+            write_int(v, b);
+        }
     }
 
     template<typename value_t>
@@ -0,0 +1,236 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+
+#include <tudocomp/ds/IntVector.hpp>
+#include <tudocomp/util/compact_sparse_hash.hpp>
+
+namespace tdc {
+
+/// Compact hash table with bit-packed quotients and values.
+///
+/// Like in \ref compact_hash, a key is split by a bijective hash function
+/// into an initial address and a quotient, and only the quotient is stored.
+/// Collisions are resolved by linear probing, but instead of marking groups
+/// with virgin and change bits (which requires shifting elements on insert),
+/// every location stores its displacement, that is, the distance to the
+/// initial address of the key stored there.
+/// Displacements are stored in 4 bits, the rare larger ones are kept in a
+/// separate map.
+///
+/// Values are stored bit-packed as well. Their width is given on each access
+/// and only ever grows, which fits values like LZ78 factor ids.
+/// Altogether, a location takes up `quotient width + value width + 4` bits.
+class compact_displacement_hash {
+    using key_t = uint64_t;
+
+    static constexpr size_t DEFAULT_KEY_WIDTH = 16;
+    static constexpr size_t DEFAULT_VALUE_WIDTH = 1;
+
+    // stored displacement value for displacements kept in m_displace_overflow
+    static constexpr uint64_t DISPLACEMENT_ESCAPE = 15;
+
+    SizeManager m_sizing;
+    uint8_t m_width;
+    float m_max_load_factor = 0.75f;
+
+    IntVector<dynamic_t> m_quots;
+    IntVector<dynamic_t> m_vals;
+
+    // 0 marks an empty location, otherwise the displacement plus one
+    IntVector<uint_t<4>> m_displace;
+    std::unordered_map<size_t, size_t> m_displace_overflow;
+
+    inline static constexpr size_t min_size(size_t size) {
+        return (size < 2) ? 2 : size;
+    }
+
+public:
+    using reference = IntVector<dynamic_t>::reference;
+
+    inline compact_displacement_hash(size_t size,
+                                     size_t key_width = DEFAULT_KEY_WIDTH,
+                                     size_t value_width = DEFAULT_VALUE_WIDTH):
+        m_sizing(min_size(size)),
+        m_width(key_width)
+    {
+        m_quots = IntVector<dynamic_t>(table_size(), 0, quotient_width());
+        m_vals = IntVector<dynamic_t>(table_size(), 0, std::max<size_t>(value_width, 1));
+        m_displace = IntVector<uint_t<4>>(table_size(), 0);
+    }
+
+    inline compact_displacement_hash(compact_displacement_hash&& other) = default;
+    inline compact_displacement_hash& operator=(compact_displacement_hash&& other) = default;
+
+    /// Sets the fraction of occupied locations at which the table grows.
+    inline void max_load_factor(float z) {
+        DCHECK(z > 0.0f && z < 1.0f);
+        m_max_load_factor = z;
+    }
+
+    inline float max_load_factor() const {
+        return m_max_load_factor;
+    }
+
+    inline size_t size() const {
+        return m_sizing.size();
+    }
+
+    inline size_t table_size() const {
+        return m_sizing.capacity();
+    }
+
+    inline uint8_t value_width() const {
+        return m_vals.width();
+    }
+
+    /// Returns a reference to the value of `key`.
+    ///
+    /// If the key does not exist yet, it gets inserted with value 0.
+    /// The reference is invalidated by the next call.
+    inline reference index(uint64_t key, size_t key_width, size_t value_width) {
+        grow_if_needed(key_width);
+        if (value_width > m_vals.width()) {
+            m_vals.width(value_width);
+        }
+
+        auto const dkey = decompose_key(key);
+        size_t pos = dkey.initial_address;
+        for(size_t d = 0;; d++, pos = mod_add(pos)) {
+            if (is_empty(pos)) {
+                set_displacement(pos, d);
+                m_quots[pos] = dkey.stored_quotient;
+                m_vals[pos] = 0;
+                m_sizing.size()++;
+                return m_vals[pos];
+            }
+            if (get_displacement(pos) == d && m_quots[pos] == dkey.stored_quotient) {
+                return m_vals[pos];
+            }
+        }
+    }
+
+    inline reference operator[](uint64_t key) {
+        return index(key, m_width, m_vals.width());
+    }
+
+    /// Looks up `key` without inserting it.
+    ///
+    /// \return `true` and the value in `value` if the key exists.
+    inline bool search(uint64_t key, uint64_t& value) {
+        auto const dkey = decompose_key(key);
+        size_t pos = dkey.initial_address;
+        for(size_t d = 0; !is_empty(pos); d++, pos = mod_add(pos)) {
+            if (get_displacement(pos) == d && m_quots[pos] == dkey.stored_quotient) {
+                value = m_vals[pos];
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    inline uint8_t table_size_log2() const {
+        return m_sizing.capacity_log2();
+    }
+
+    // the actual amount of bits usable for storing a key
+    // is always >= the set key width stored in m_width
+    inline uint8_t real_width() const {
+        return std::max(uint8_t(table_size_log2() + 1), m_width);
+    }
+
+    inline size_t quotient_width() const {
+        return real_width() - table_size_log2();
+    }
+
+    inline size_t mod_add(size_t v) const {
+        return (v + 1) & (table_size() - 1);
+    }
+
+    inline size_t mod_sub(size_t v, size_t sub) const {
+        return (v - sub) & (table_size() - 1);
+    }
+
+    inline bool is_empty(size_t pos) const {
+        return m_displace[pos] == 0u;
+    }
+
+    inline size_t get_displacement(size_t pos) const {
+        uint_t<4> const d = m_displace[pos];
+        DCHECK_NE(d, 0u);
+        if (d == DISPLACEMENT_ESCAPE) {
+            return m_displace_overflow.at(pos);
+        }
+        return d - 1;
+    }
+
+    inline void set_displacement(size_t pos, size_t d) {
+        if (d + 1 < DISPLACEMENT_ESCAPE) {
+            m_displace[pos] = d + 1;
+        } else {
+            m_displace[pos] = DISPLACEMENT_ESCAPE;
+            m_displace_overflow[pos] = d;
+        }
+    }
+
+    inline void dcheck_key_width(uint64_t key) const {
+        IF_DEBUG({
+            uint64_t key_mask = (1ull << (m_width - 1ull) << 1ull) - 1ull;
+            bool key_is_too_large = key & ~key_mask;
+            DCHECK(!key_is_too_large) << "Attempt to insert key " << key << ", which requires more bits than the current set maximum of " << size_t(m_width) << " Bits";
+        });
+    }
+
+    struct DecomposedKey {
+        size_t initial_address;   // initial address of key in table
+        size_t stored_quotient;   // quotient value stored in table
+    };
+
+    inline DecomposedKey decompose_key(uint64_t key) const {
+        dcheck_key_width(key);
+        uint64_t hres = compact_hashfn(key, real_width());
+        uint64_t shift = table_size_log2();
+
+        return DecomposedKey {
+            hres & ((1ull << shift) - 1ull),
+            hres >> shift,
+        };
+    }
+
+    inline uint64_t compose_key(uint64_t initial_address, uint64_t quotient) const {
+        uint64_t harg = (quotient << table_size_log2()) | initial_address;
+        uint64_t key = compact_reverse_hashfn(harg, real_width());
+        dcheck_key_width(key);
+        return key;
+    }
+
+    inline bool needs_capacity_change() const {
+        return (m_sizing.size() + 1) > m_sizing.capacity() * m_max_load_factor;
+    }
+
+    inline void grow_if_needed(size_t new_width) {
+        if (needs_capacity_change() || new_width != m_width) {
+            size_t new_capacity = m_sizing.capacity();
+            while ((m_sizing.size() + 1) > new_capacity * m_max_load_factor) {
+                new_capacity *= 2;
+            }
+
+            auto new_table = compact_displacement_hash(new_capacity, new_width, m_vals.width());
+            new_table.m_max_load_factor = m_max_load_factor;
+
+            for(size_t pos = 0; pos < table_size(); pos++) {
+                if (is_empty(pos)) continue;
+
+                uint64_t initial_address = mod_sub(pos, get_displacement(pos));
+                key_t key = compose_key(initial_address, m_quots[pos]);
+                new_table.index(key, new_width, m_vals.width()) = uint64_t(m_vals[pos]);
+            }
+
+            *this = std::move(new_table);
+        }
+    }
+};
+
+}
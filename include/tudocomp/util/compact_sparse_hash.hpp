@@ -336,6 +336,10 @@ class compact_hash {
     static constexpr size_t DEFAULT_KEY_WIDTH = 16;
     static constexpr bool HIGH_BITS_RANDOM = false;
 
+    // minimum number of elements moved out of the old table per insert
+    // while growing incrementally
+    static constexpr size_t MIGRATION_STEP = 4;
+
     SizeManager m_sizing;
     uint8_t m_width;
 
@@ -345,6 +349,11 @@ class compact_hash {
     // Sparse table data
     std::vector<Bucket<val_t>> m_buckets;
 
+    // Incremental growth
+    struct Migration;
+    bool m_incremental = false;
+    std::unique_ptr<Migration> m_migration;
+
     inline static constexpr size_t min_size(size_t size) {
         return (size < 2) ? 2 : size;
     }
@@ -357,8 +366,10 @@ public:
     {
         m_cv.reserve(table_size());
         m_cv.resize(table_size());
-        m_buckets.reserve((m_sizing.size() + BVS_WIDTH_MASK) << BVS_WIDTH_SHIFT);
-        m_buckets.resize((m_sizing.size() + BVS_WIDTH_MASK) << BVS_WIDTH_SHIFT);
+        // one more bucket than needed, since sparse_shift() accesses
+        // the location past the end of the table
+        m_buckets.reserve(bucket_count() + 1);
+        m_buckets.resize(bucket_count() + 1);
     }
 
     inline ~compact_hash() {
@@ -369,7 +380,9 @@ public:
         m_sizing(std::move(other.m_sizing)),
         m_width(std::move(other.m_width)),
         m_cv(std::move(other.m_cv)),
-        m_buckets(std::move(other.m_buckets))
+        m_buckets(std::move(other.m_buckets)),
+        m_incremental(other.m_incremental),
+        m_migration(std::move(other.m_migration))
     {
     }
 
@@ -380,10 +393,31 @@ public:
         m_width = std::move(other.m_width);
         m_cv = std::move(other.m_cv);
         m_buckets = std::move(other.m_buckets);
+        m_incremental = other.m_incremental;
+        m_migration = std::move(other.m_migration);
 
         return *this;
     }
 
+    /// Enables or disables incremental growth.
+    ///
+    /// If enabled, growing the table does not rebuild it at once.
+    /// Instead, the old table is kept alongside the new one,
+    /// and each following insert moves a few of its elements over.
+    /// The buckets of the old table are freed as soon as they are emptied,
+    /// so the insert latency stays flat and the memory peak stays close to
+    /// the size of the new table.
+    ///
+    /// Changing the key width still rebuilds the table at once, so
+    /// the key width should be fixed in advance to benefit from this.
+    inline void incremental_growth(bool enable) {
+        m_incremental = enable;
+    }
+
+    inline bool incremental_growth() const {
+        return m_incremental;
+    }
+
 private:
     inline uint8_t table_size_log2() {
         return m_sizing.capacity_log2();
@@ -393,6 +427,10 @@ private:
         return m_sizing.capacity();
     }
 
+    inline size_t bucket_count() {
+        return (table_size() + BVS_WIDTH_MASK) >> BVS_WIDTH_SHIFT;
+    }
+
     inline bool get_v(size_t pos) {
         return (m_cv.at(pos) & 0b01) != 0;
     }
@@ -555,10 +593,14 @@ private:
 
     inline val_t* search(uint64_t key) {
         auto dkey = decompose_key(key);
+        val_t* p = nullptr;
         if (get_v(dkey.initial_address)) {
-            return search(search_existing_group(dkey), dkey.stored_quotient);
+            p = search(search_existing_group(dkey), dkey.stored_quotient);
         }
-        return nullptr;
+        if (p == nullptr && m_migration) {
+            p = m_migration->search(key);
+        }
+        return p;
     }
 
 public:
@@ -588,6 +630,9 @@ public:
     }
 
     inline size_t size() const {
+        if (m_migration) {
+            return m_sizing.size() + m_migration->table->size();
+        }
         return m_sizing.size();
     }
 
@@ -674,7 +719,31 @@ private:
 
     template<typename handler_t>
     inline void insert_handler(uint64_t key, size_t key_width, handler_t&& handler) {
+        if (m_migration && (key_width != m_width || needs_capacity_change())) {
+            finish_migration();
+        }
+
         grow_if_needed(key_width);
+
+        if (m_migration) {
+            migrate_step();
+
+            // the key might not have been moved to this table yet
+            if (m_migration) {
+                val_t* p = m_migration->search(key);
+                if (p != nullptr) {
+                    handler.on_existing(*p);
+                    return;
+                }
+            }
+        }
+
+        insert_into_table(key, std::move(handler));
+    }
+
+    // inserts into this table only, without checking the capacity
+    template<typename handler_t>
+    inline void insert_into_table(uint64_t key, handler_t&& handler) {
         auto const dkey = decompose_key(key);
 
         // cases:
@@ -816,15 +885,98 @@ private:
         }
     };
 
+    // The old table of an incremental growth, together with the
+    // position up to which its elements have been moved.
+    //
+    // Elements are moved a whole group of adjacent locations at a time,
+    // starting at an empty location. Thus the moved elements always form
+    // a cyclic range of locations, and a key whose initial address lies
+    // outside of it can still be searched in the old table as usual.
+    struct Migration {
+        std::unique_ptr<compact_hash> table;
+        iter_all_t iter;
+        size_t drop_next; // next bucket to be freed
+
+        inline Migration(std::unique_ptr<compact_hash>&& old_table):
+            table(std::move(old_table)),
+            iter(*table),
+            drop_next(((iter.original_start >> BVS_WIDTH_SHIFT) + 1)
+                      % table->bucket_count()) {}
+
+        inline bool is_moved(size_t pos) {
+            size_t start = iter.original_start;
+            return table->mod_sub(pos, start) < table->mod_sub(iter.i, start);
+        }
+
+        inline val_t* search(uint64_t key) {
+            auto dkey = table->decompose_key(key);
+            if (!table->get_v(dkey.initial_address)
+                || is_moved(dkey.initial_address)) {
+                return nullptr;
+            }
+            return table->search(table->search_existing_group(dkey),
+                                 dkey.stored_quotient);
+        }
+
+        // frees all buckets that only contain moved elements
+        inline void drop_moved_buckets() {
+            size_t start_bucket = iter.original_start >> BVS_WIDTH_SHIFT;
+            while (drop_next != start_bucket
+                   && is_moved((drop_next << BVS_WIDTH_SHIFT) + BVS_WIDTH_MASK)) {
+                table->sparse_drop_bucket(drop_next);
+                drop_next = (drop_next + 1) % table->bucket_count();
+            }
+        }
+    };
+
+    // moves at least MIGRATION_STEP elements from the old table
+    // into this one
+    inline void migrate_step() {
+        auto& old_table = *m_migration->table;
+
+        size_t moved = 0;
+        uint64_t initial_address;
+        size_t i;
+        while (m_migration->iter.next(&initial_address, &i)) {
+            auto kv = old_table.sparse_get_at(i);
+            key_t key = old_table.compose_key(initial_address, kv.get_quotient());
+
+            insert_into_table(key, InsertHandler { std::move(kv.val()) });
+            old_table.m_sizing.size()--;
+            moved++;
+
+            // only stop after a whole group of adjacent locations
+            if (old_table.sparse_is_empty(old_table.mod_add(i))) {
+                if (m_migration->iter.i == m_migration->iter.original_start) {
+                    // wrapped around, everything has been moved
+                    break;
+                }
+                m_migration->drop_moved_buckets();
+                if (moved >= MIGRATION_STEP) {
+                    return;
+                }
+            }
+        }
+
+        DCHECK_EQ(old_table.size(), 0);
+        m_migration.reset();
+    }
+
+    inline void finish_migration() {
+        while (m_migration) {
+            migrate_step();
+        }
+    }
+
     inline size_t quotient_width() {
         return real_width() - table_size_log2();
     }
 
-    inline void grow_if_needed(size_t new_width) {
-        auto needs_capacity_change = [&]() {
-            return(m_sizing.capacity() / 2) <= (m_sizing.size() + 1);
-        };
+    inline bool needs_capacity_change() {
+        return (m_sizing.capacity() / 2) <= (m_sizing.size() + 1);
+    }
 
+    inline void grow_if_needed(size_t new_width) {
         auto needs_realloc = [&]() {
             return needs_capacity_change() || (new_width != m_width);
         };
@@ -837,6 +989,17 @@ private:
                 new_capacity = m_sizing.capacity();
             }
             auto new_table = compact_hash(new_capacity, new_width);
+            new_table.m_incremental = m_incremental;
+
+            if (m_incremental && new_width == m_width) {
+                // keep the current table around and move its elements
+                // over during the next inserts
+                DCHECK(!m_migration);
+                auto old_table = std::make_unique<compact_hash>(std::move(*this));
+                *this = std::move(new_table);
+                m_migration = std::make_unique<Migration>(std::move(old_table));
+                return;
+            }
 
             /*
             std::cout
@@ -0,0 +1,210 @@
+#pragma once
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+#include <tudocomp/def.hpp>
+
+namespace tdc {
+namespace huff {
+
+/// The longest codeword that can be stored in a `size_t`.
+constexpr size_t MAX_CODELENGTH = 64;
+
+/// The default limit on the length of codewords.
+constexpr size_t DEFAULT_MAX_CODELENGTH = 32;
+
+/// \brief Computes the codeword lengths of an optimal prefix code whose
+///        codewords are at most `max_length` bits long.
+///
+/// The symbols are sorted by their weights, then the lengths of the
+/// Huffman code are computed in linear time with two queues, one for the
+/// leaves and one for the inner nodes in the order of their creation.
+/// Only if the longest codeword exceeds `max_length`, the lengths are
+/// recomputed with the package-merge algorithm in `O(σ max_length)` time.
+///
+/// \param weights the (positive) weight of each symbol.
+/// \param max_length the maximum codeword length, at least
+///        `bits_for(weights.size() - 1)` and at most \ref MAX_CODELENGTH.
+/// \return the codeword length of each symbol.
+inline std::vector<uint8_t> gen_limited_codelengths(
+        const std::vector<size_t>& weights, const size_t max_length) {
+
+    const size_t n = weights.size();
+    DCHECK_GT(n, 0U);
+    DCHECK_LE(max_length, MAX_CODELENGTH);
+    DCHECK(max_length >= 64 || (n - 1) >> max_length == 0)
+        << "too many symbols for codewords of length " << max_length;
+
+    std::vector<uint8_t> lengths(n, 1);
+    if(n == 1) return lengths;
+
+    // symbols sorted by weight, such that among symbols of the same
+    // weight the smaller ones get the shorter codewords
+    std::vector<size_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return weights[a] < weights[b] || (weights[a] == weights[b] && a > b);
+    });
+
+    // Huffman tree: nodes [0, n) are the sorted leaves,
+    // nodes [n, 2n-1) the inner nodes in the order of their creation,
+    // which is also increasing by weight
+    {
+        std::vector<size_t> weight(2 * n - 1);
+        std::vector<size_t> parent(2 * n - 1);
+        for(size_t i = 0; i < n; ++i) weight[i] = weights[order[i]];
+
+        size_t leaf = 0, inner = n;
+        auto pop_min = [&](size_t end) {
+            if(leaf < n && (inner >= end || weight[leaf] <= weight[inner])) {
+                return leaf++;
+            } else {
+                return inner++;
+            }
+        };
+        for(size_t v = n; v < 2 * n - 1; ++v) {
+            const size_t a = pop_min(v);
+            const size_t b = pop_min(v);
+            weight[v] = weight[a] + weight[b];
+            parent[a] = parent[b] = v;
+        }
+
+        // depths top-down, reusing `weight`
+        std::vector<size_t>& depth = weight;
+        depth[2 * n - 2] = 0;
+        for(size_t v = 2 * n - 2; v > 0; --v) {
+            depth[v - 1] = depth[parent[v - 1]] + 1;
+        }
+
+        bool limited = true;
+        for(size_t i = 0; i < n; ++i) {
+            lengths[order[i]] = uint8_t(std::min<size_t>(depth[i], 255));
+            limited = limited && depth[i] <= max_length;
+        }
+        if(limited) return lengths;
+    }
+
+    // Package-merge: list l contains the leaves merged with the packages
+    // of adjacent pairs of list l-1, of which we store whether an entry is
+    // a package. The codeword length of a leaf is the number of lists in
+    // which it belongs to the items selected for the code.
+    std::vector<std::vector<bool>> is_package(max_length);
+    {
+        std::vector<size_t> prev(n);
+        for(size_t i = 0; i < n; ++i) prev[i] = weights[order[i]];
+        is_package[0].assign(n, false);
+
+        std::vector<size_t> cur;
+        for(size_t l = 1; l < max_length; ++l) {
+            cur.clear();
+            is_package[l].clear();
+
+            size_t i = 0, j = 0; // next leaf, next package
+            const size_t packages = prev.size() / 2;
+            while(i < n || j < packages) {
+                const bool take_leaf = i < n && (j >= packages ||
+                    weights[order[i]] <= prev[2 * j] + prev[2 * j + 1]);
+                if(take_leaf) {
+                    cur.push_back(weights[order[i++]]);
+                } else {
+                    cur.push_back(prev[2 * j] + prev[2 * j + 1]);
+                    ++j;
+                }
+                is_package[l].push_back(!take_leaf);
+            }
+            std::swap(prev, cur);
+        }
+    }
+
+    // select the 2n-2 first items of the last list and propagate
+    // the selection down to the packaged items
+    std::vector<size_t> selected_leaves(n + 1, 0);
+    size_t selected = 2 * n - 2;
+    for(size_t l = max_length; l > 0; --l) {
+        size_t leaves = 0, packages = 0;
+        for(size_t k = 0; k < selected; ++k) {
+            if(is_package[l - 1][k]) ++packages; else ++leaves;
+        }
+        ++selected_leaves[leaves]; // leaves [0, leaves) gain one bit
+        selected = 2 * packages;
+    }
+    size_t length = 0;
+    for(size_t i = n; i > 0; --i) {
+        length += selected_leaves[i];
+        lengths[order[i - 1]] = uint8_t(length);
+    }
+    return lengths;
+}
+
+/// \brief A canonical prefix code.
+///
+/// Codewords are assigned in the order of increasing length, where
+/// longer codewords have smaller values: the first codeword of length `l`
+/// is `(first(l+1) + numl(l+1)) / 2`, and codewords of the same length are
+/// consecutive numbers.
+struct CanonicalCode {
+    /// The symbols ordered by the lengths of their codewords, ties are
+    /// broken by the symbols.
+    std::vector<size_t> order;
+    /// The codeword length of each symbol in `order`.
+    std::vector<uint8_t> ordered_codelengths;
+    /// The codeword of each symbol in `order`.
+    std::vector<size_t> codewords;
+    /// `numl[l]` is the number of codewords of length `l+1`.
+    std::vector<size_t> numl;
+    /// The length of the longest codeword.
+    uint8_t longest;
+};
+
+/// \brief Computes the first codeword of each length of a canonical code.
+inline std::vector<size_t> gen_first_codes(const std::vector<size_t>& numl) {
+    const size_t longest = numl.size();
+    std::vector<size_t> firstcode(longest);
+    firstcode[longest - 1] = 0;
+    for(size_t i = longest - 1; i > 0; --i) {
+        firstcode[i - 1] = (firstcode[i] + numl[i]) / 2;
+    }
+    return firstcode;
+}
+
+/// \brief Computes a length-limited canonical Huffman code.
+///
+/// \param weights the (positive) weight of each symbol.
+/// \param max_length the maximum codeword length,
+///        see \ref gen_limited_codelengths.
+inline CanonicalCode gen_canonical_code(
+        const std::vector<size_t>& weights,
+        const size_t max_length = DEFAULT_MAX_CODELENGTH) {
+
+    const size_t n = weights.size();
+    const std::vector<uint8_t> lengths = gen_limited_codelengths(weights, max_length);
+
+    CanonicalCode code;
+    code.longest = *std::max_element(lengths.begin(), lengths.end());
+
+    // counting sort by codeword length
+    code.numl.assign(code.longest, 0);
+    for(uint8_t l : lengths) ++code.numl[l - 1];
+
+    std::vector<size_t> offset(code.longest + 1, 0);
+    for(size_t l = 0; l < code.longest; ++l) offset[l + 1] = offset[l] + code.numl[l];
+
+    code.order.resize(n);
+    code.ordered_codelengths.resize(n);
+    for(size_t i = 0; i < n; ++i) {
+        const size_t k = offset[lengths[i] - 1]++;
+        code.order[k] = i;
+        code.ordered_codelengths[k] = lengths[i];
+    }
+
+    std::vector<size_t> firstcode = gen_first_codes(code.numl);
+    code.codewords.resize(n);
+    for(size_t k = 0; k < n; ++k) {
+        code.codewords[k] = firstcode[code.ordered_codelengths[k] - 1]++;
+    }
+    return code;
+}
+
+}} //ns
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <algorithm>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace tdc {
+
+/// Runs `f(i)` for each `i` in `[0, count)` on up to `threads` threads.
+///
+/// If any call throws, the first exception is rethrown after all threads
+/// have finished.
+template<class F>
+inline void parallel_for(size_t count, size_t threads, F f) {
+    threads = std::max<size_t>(std::min(threads, count), 1);
+
+    std::vector<std::exception_ptr> errors(threads);
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    for(size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            try {
+                for(size_t i = t; i < count; i += threads) f(i);
+            } catch(...) {
+                errors[t] = std::current_exception();
+            }
+        });
+    }
+    for(auto& worker : workers) worker.join();
+    for(auto& error : errors) {
+        if(error) std::rethrow_exception(error);
+    }
+}
+
+}
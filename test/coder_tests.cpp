@@ -10,11 +10,14 @@
 #include <tudocomp/generators/ThueMorseGenerator.hpp>
 
 #include <tudocomp/coders/ASCIICoder.hpp>
+#include <tudocomp/coders/BitCoder.hpp>
 #include <tudocomp/coders/EliasDeltaCoder.hpp>
 #include <tudocomp/coders/EliasGammaCoder.hpp>
 #include <tudocomp/coders/HuffmanCoder.hpp>
 #include <tudocomp/coders/SLECoder.hpp>
 #include <tudocomp/coders/ArithmeticCoder.hpp>
+#include <tudocomp/coders/RangeCoder.hpp>
+#include <tudocomp/coders/RANSCoder.hpp>
 #include <tudocomp/coders/TernaryCoder.hpp>
 
 using namespace tdc;
@@ -115,7 +118,7 @@ void test_int(size_t n = 93) {
 }
 
 template<typename coder_t>
-void test_str() {
+void test_str(const std::string& options = "") {
     // Generate a fibonacci word and use it as test subject
     const std::string word = FibonacciGenerator::generate(24);
 
@@ -123,7 +126,7 @@ void test_str() {
     std::stringstream ss;
     {
         Output out(ss);
-        typename coder_t::Encoder coder(create_env(coder_t::meta()), out, ViewLiterals(word));
+        typename coder_t::Encoder coder(create_env(coder_t::meta(), options), out, ViewLiterals(word));
 
         for(char c : word) coder.encode(c, literal_r);
     }
@@ -132,7 +135,7 @@ void test_str() {
     std::string result = ss.str();
     {
         Input in(result);
-        typename coder_t::Decoder decoder(create_env(coder_t::meta()), in);
+        typename coder_t::Decoder decoder(create_env(coder_t::meta(), options), in);
 
         size_t i = 0;
         while(!decoder.eof()) {
@@ -144,7 +147,7 @@ void test_str() {
 }
 
 template<typename coder_t>
-void test_mixed() {
+void test_mixed(const std::string& options = "") {
     // Generate a fibonacci word and use it as test subject
     const std::string word = FibonacciGenerator::generate(24);
     Range atoz_r('a', 'z');
@@ -154,7 +157,7 @@ void test_mixed() {
     std::stringstream ss;
     {
         Output out(ss);
-        typename coder_t::Encoder coder(create_env(coder_t::meta()), out, ViewLiterals(word));
+        typename coder_t::Encoder coder(create_env(coder_t::meta(), options), out, ViewLiterals(word));
 
         for(size_t i = 0; i < word.length(); i++) {
             coder.encode(word[i] == 'a', bit_r);
@@ -169,7 +172,7 @@ void test_mixed() {
     std::string result = ss.str();
     {
         Input in(result);
-        typename coder_t::Decoder decoder(create_env(coder_t::meta()), in);
+        typename coder_t::Decoder decoder(create_env(coder_t::meta(), options), in);
 
         size_t i = 0;
         while(!decoder.eof()) {
@@ -185,6 +188,49 @@ void test_mixed() {
     }
 }
 
+/// Interleaves the values of two coders and raw bits on the same stream.
+template<typename coder_t, typename other_t>
+void test_interleaved(const std::string& options = "") {
+    // Generate a fibonacci word and use it as test subject
+    const std::string word = FibonacciGenerator::generate(20);
+
+    // Encode string
+    std::stringstream ss;
+    {
+        Output output(ss);
+        auto out = std::make_shared<BitOStream>(output);
+        typename coder_t::Encoder coder(create_env(coder_t::meta(), options), out, ViewLiterals(word));
+        typename other_t::Encoder other(create_env(other_t::meta()), out, ViewLiterals(word));
+
+        for(size_t i = 0; i < word.length(); i++) {
+            coder.encode(word[i], literal_r);
+            other.encode(i, size_r);
+            out->write_bit(word[i] == 'a');
+            coder.encode(i % 7, Range(6));
+            other.encode(word[i], literal_r);
+        }
+    }
+
+    // Decode
+    std::string result = ss.str();
+    {
+        Input input(result);
+        auto in = std::make_shared<BitIStream>(input);
+        typename coder_t::Decoder decoder(create_env(coder_t::meta(), options), in);
+        typename other_t::Decoder other(create_env(other_t::meta()), in);
+
+        for(size_t i = 0; i < word.length(); i++) {
+            ASSERT_EQ(uliteral_t(word[i]), decoder.template decode<uliteral_t>(literal_r)) << "i=" << i;
+            ASSERT_EQ(i, other.template decode<size_t>(size_r)) << "i=" << i;
+            ASSERT_EQ(word[i] == 'a', bool(in->read_bit())) << "i=" << i;
+            ASSERT_EQ(i % 7, decoder.template decode<size_t>(Range(6))) << "i=" << i;
+            ASSERT_EQ(uliteral_t(word[i]), other.template decode<uliteral_t>(literal_r)) << "i=" << i;
+        }
+        ASSERT_TRUE(decoder.eof());
+        ASSERT_TRUE(in->eof());
+    }
+}
+
 TEST(coder, ascii_mt) { test_mt<ASCIICoder>(); }
 TEST(coder, ascii_bits) { test_bits<ASCIICoder>(); }
 TEST(coder, ascii_int) { test_int<ASCIICoder>(); }
@@ -226,3 +272,35 @@ TEST(coder, ternary_bits) { test_bits<TernaryCoder>(); }
 TEST(coder, ternary_int) { test_int<TernaryCoder>(); }
 TEST(coder, ternary_str) { test_str<TernaryCoder>(); }
 TEST(coder, ternary_mixed) { test_mixed<TernaryCoder>(); }
+
+TEST(coder, range_mt) { test_mt<RangeCoder>(); }
+TEST(coder, range_bits) { test_bits<RangeCoder>(); }
+TEST(coder, range_int) { test_int<RangeCoder>(); }
+TEST(coder, range_str) { test_str<RangeCoder>(); }
+TEST(coder, range_mixed) { test_mixed<RangeCoder>(); }
+TEST(coder, range_str_order0) { test_str<RangeCoder>("order=0, chunk=100"); }
+TEST(coder, range_str_order2) { test_str<RangeCoder>("order=2, chunk=1000"); }
+TEST(coder, range_mixed_chunks) { test_mixed<RangeCoder>("chunk=1"); }
+TEST(coder, range_interleaved) {
+    test_interleaved<RangeCoder, BitCoder>();
+    test_interleaved<RangeCoder, BitCoder>("chunk=100");
+    test_interleaved<RangeCoder, RangeCoder>("chunk=1000");
+    test_interleaved<RangeCoder, HuffmanCoder>("chunk=1");
+}
+
+TEST(coder, rans_mt) { test_mt<RANSCoder>(); }
+TEST(coder, rans_bits) { test_bits<RANSCoder>(); }
+TEST(coder, rans_int) { test_int<RANSCoder>(); }
+TEST(coder, rans_str) { test_str<RANSCoder>(); }
+TEST(coder, rans_mixed) { test_mixed<RANSCoder>(); }
+TEST(coder, rans_str_states) {
+    test_str<RANSCoder>("states=1");
+    test_str<RANSCoder>("states=3, chunk=1000");
+    test_str<RANSCoder>("states=32, chunk=1");
+}
+TEST(coder, rans_interleaved) {
+    test_interleaved<RANSCoder, BitCoder>();
+    test_interleaved<RANSCoder, BitCoder>("chunk=100");
+    test_interleaved<RANSCoder, RANSCoder>("states=3, chunk=1000");
+    test_interleaved<RANSCoder, RangeCoder>("chunk=1");
+}
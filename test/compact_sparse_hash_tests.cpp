@@ -4,6 +4,7 @@
 #include <cstdint>
 #include <algorithm>
 #include <tudocomp/util/compact_sparse_hash.hpp>
+#include <tudocomp/util/compact_displacement_hash.hpp>
 #include <tudocomp/util.hpp>
 
 using namespace tdc;
@@ -510,3 +511,124 @@ TEST(hash, lookup_bug2) {
     find_or_insert(113, 24, 24);
     find_or_insert(6243, 34, 34);
 }
+
+TEST(hash, grow_incremental) {
+    Init::reset();
+
+    std::vector<std::pair<uint64_t, Init>> inserted;
+
+    auto ch = compact_hash<Init>(0, 10);
+    ch.incremental_growth(true);
+
+    auto add = [&](auto key, auto&& v0, auto&& v1) {
+        ch.insert(key, std::move(v0));
+        inserted.push_back({ key, std::move(v1) });
+        for (auto& kv : inserted) {
+            ch.debug_check_single(kv.first, kv.second);
+        }
+    };
+
+    for(size_t i = 0; i < 1000; i++) {
+        add(i, Init(), Init(i));
+    }
+    ASSERT_EQ(ch.size(), 1000);
+}
+
+TEST(hash, grow_incremental_bits) {
+    Init::reset();
+
+    std::vector<std::pair<uint64_t, Init>> inserted;
+
+    auto ch = compact_hash<Init>(0, 10);
+    ch.incremental_growth(true);
+
+    uint8_t bits = 1;
+
+    auto add = [&](auto key, auto&& v0, auto&& v1) {
+        bits = std::max(bits, bits_for(key));
+
+        ch.insert(key, std::move(v0), bits);
+        inserted.push_back({ key, std::move(v1) });
+        for (auto& kv : inserted) {
+            ch.debug_check_single(kv.first, kv.second);
+        }
+    };
+
+    for(size_t i = 0; i < 1000; i++) {
+        add(i, Init(), Init(i));
+    }
+}
+
+TEST(hash, grow_incremental_address) {
+    auto ch = compact_hash<uint64_t>(0, 40);
+    ch.incremental_growth(true);
+
+    std::vector<uint64_t> keys;
+    for(uint64_t i = 0; i < 200000; i++) {
+        uint64_t key = (i * 7919ull) ^ (i << 17);
+        keys.push_back(key);
+        auto& val = ch.index(key, 40);
+        ASSERT_EQ(val, 0);
+        val = i + 1;
+        ASSERT_EQ(ch.size(), i + 1);
+
+        // look up older keys in both the new and the old table
+        uint64_t j = (i * 31ull) % keys.size();
+        ASSERT_EQ(ch.index(keys[j], 40), j + 1);
+    }
+    for(uint64_t i = 0; i < keys.size(); i++) {
+        ch.debug_check_single(keys[i], i + 1);
+    }
+}
+
+TEST(displacement_hash, grow_bits) {
+    auto ch = compact_displacement_hash(0, 0);
+
+    uint8_t key_bits = 1;
+    std::vector<uint64_t> keys;
+    for(uint64_t i = 0; i < 10000; i++) {
+        uint64_t key = i * 13ull;
+        key_bits = std::max(key_bits, bits_for(key));
+        keys.push_back(key);
+
+        auto val = ch.index(key, key_bits, bits_for(i + 1));
+        ASSERT_EQ(val, 0u);
+        val = i + 1;
+        ASSERT_EQ(ch.size(), i + 1);
+        ASSERT_EQ(ch.value_width(), bits_for(i + 1));
+    }
+    for(uint64_t i = 0; i < keys.size(); i++) {
+        uint64_t value = 0;
+        ASSERT_TRUE(ch.search(keys[i], value));
+        ASSERT_EQ(value, i + 1);
+        ASSERT_EQ(ch.index(keys[i], key_bits, 1), i + 1);
+    }
+    uint64_t value = 0;
+    ASSERT_FALSE(ch.search(1, value));
+    ASSERT_EQ(ch.size(), keys.size());
+}
+
+TEST(displacement_hash, long_displacements) {
+    // a high load factor provokes displacements that do not fit into
+    // the 4 bits stored per location
+    auto ch = compact_displacement_hash(0, 40);
+    ch.max_load_factor(0.98f);
+
+    std::vector<uint64_t> keys;
+    for(uint64_t i = 0; i < 200000; i++) {
+        uint64_t key = (i * 7919ull) ^ (i << 17);
+        keys.push_back(key);
+        auto val = ch.index(key, 40, 18);
+        ASSERT_EQ(val, 0u);
+        val = i + 1;
+
+        uint64_t j = (i * 31ull) % keys.size();
+        ASSERT_EQ(ch.index(keys[j], 40, 18), j + 1);
+    }
+    ASSERT_EQ(ch.size(), keys.size());
+    for(uint64_t i = 0; i < keys.size(); i++) {
+        uint64_t value = 0;
+        ASSERT_TRUE(ch.search(keys[i], value));
+        ASSERT_EQ(value, i + 1);
+    }
+}
@@ -1,3 +1,4 @@
+#include <random>
 #include <string>
 #include <vector>
 
@@ -11,6 +12,7 @@
 #include <tudocomp/ds/bwt.hpp>
 #include <tudocomp/ds/SparseISA.hpp>
 #include <tudocomp/ds/CompressedLCP.hpp>
+#include <tudocomp/ds/DACLCP.hpp>
 #include <tudocomp/CreateAlgorithm.hpp>
 #include "test/util.hpp"
 
@@ -98,6 +100,42 @@ void test_isa(const std::string&, textds_t& t) {
 	}
 }
 
+template<class textds_t>
+void test_isa_lookup(const std::string&, textds_t& t) {
+    auto& isa = t.require_isa();
+    auto& sa  = t.require_sa(); //request afterwards!
+    const size_t n = sa.size();
+
+    std::vector<size_t> positions;
+    std::vector<size_t> out;
+    auto check = [&]() {
+        out.assign(positions.size(), n);
+        isa_lookup(isa, positions.data(), positions.size(), out.data());
+        for(size_t k = 0; k < positions.size(); ++k) {
+            ASSERT_EQ(sa[out[k]], positions[k]);
+        }
+    };
+
+    // unsorted
+    for(size_t i = 0; i < n; ++i) positions.push_back((i * 7919) % n);
+    check();
+
+    // sorted with duplicates
+    positions.clear();
+    for(size_t i = 0; i < n; i += 3) { positions.push_back(i); positions.push_back(i); }
+    check();
+
+    // ranges
+    for(size_t from = 0; from < n; from += std::max<size_t>(n / 5, 1)) {
+        for(size_t m : { size_t(1), size_t(5), n - from }) {
+            m = std::min(m, n - from);
+            out.assign(m, n);
+            isa_lookup_range(isa, from, m, out.data());
+            for(size_t k = 0; k < m; ++k) ASSERT_EQ(sa[out[k]], from + k);
+        }
+    }
+}
+
 template<class textds_t>
 void test_lcp(const std::string& str, textds_t& t) {
     auto& lcp = t.require_lcp();
@@ -111,6 +149,24 @@ void test_lcp(const std::string& str, textds_t& t) {
 	}
 }
 
+template<class textds_t>
+void test_lcp_relinquish(const std::string& str, textds_t& t) {
+    auto& sa  = t.require_sa();
+    auto& lcp = t.require_lcp();
+
+    auto copy = lcp.copy();
+    ASSERT_EQ(copy.size(), sa.size()); //length
+
+    auto data = t.release_lcp().relinquish();
+    ASSERT_EQ(data.size(), sa.size()); //length
+
+    //correctness
+	for(size_t i = 1; i < data.size(); ++i) {
+		ASSERT_EQ(copy[i], longest_common_extension(str, sa[i], sa[i-1]));
+		ASSERT_EQ(data[i], longest_common_extension(str, sa[i], sa[i-1]));
+	}
+}
+
 template<class textds_t>
 void test_all_ds(const std::string& str, textds_t& t) {
     test_sa(str, t);
@@ -119,44 +175,106 @@ void test_all_ds(const std::string& str, textds_t& t) {
     test_isa(str, t);
 }
 
+template<class textds_t>
+void test_aligned_width(const std::string& str, textds_t& t) {
+    t.require(textds_t::SA | textds_t::ISA | textds_t::LCP);
+
+    // widths are the required bits rounded up to whole bytes
+    auto aligned = [](size_t bits) { return 8 * idiv_ceil(std::max<size_t>(bits, 1), 8); };
+    ASSERT_EQ(aligned(bits_for(t.size())), t.require_sa().width());
+    ASSERT_EQ(aligned(bits_for(t.size())), t.require_isa().width());
+    ASSERT_EQ(aligned(bits_for(t.require_lcp().max_lcp())), t.require_lcp().width());
+
+    test_all_ds(str, t);
+}
+
 template<class textds_t>
 class RunTestDS {
 	void (*m_testfunc)(const std::string&, textds_t&);
+	std::string m_options;
 	public:
-	RunTestDS(void (*testfunc)(const std::string&, textds_t&))
-		: m_testfunc(testfunc) {}
+	RunTestDS(void (*testfunc)(const std::string&, textds_t&),
+	          const std::string& options = "")
+		: m_testfunc(testfunc), m_options(options) {}
 
 	void operator()(const std::string& str) {
 		VLOG(2) << "str = \"" << str << "\"" << " size: " << str.length();
 		test::TestInput input = test::compress_input(str);
 		InputView in = input.as_view();
 		DCHECK_EQ(str.length()+1, in.size());
-		textds_t t = create_algo<textds_t>("", in);
+		textds_t t = create_algo<textds_t>(m_options, in);
 		DCHECK_EQ(str.length()+1, t.size());
 		m_testfunc(str, t);
 	}
 };
 
-#define TEST_DS_STRINGCOLLECTION(textds_t, func) \
-	RunTestDS<textds_t> runner(func); \
+#define TEST_DS_STRINGCOLLECTION_WITH(textds_t, func, options) \
+	RunTestDS<textds_t> runner(func, options); \
 	test::roundtrip_batch(runner); \
 	test::on_string_generators(runner,11);
 
+#define TEST_DS_STRINGCOLLECTION(textds_t, func) \
+	TEST_DS_STRINGCOLLECTION_WITH(textds_t, func, "")
+
 using textds_default_t = TextDS<>;
 TEST(ds, default_SA)  { TEST_DS_STRINGCOLLECTION(textds_default_t, test_sa); }
 TEST(ds, default_BWT)         { TEST_DS_STRINGCOLLECTION(textds_default_t, test_bwt); }
 TEST(ds, default_LCP)         { TEST_DS_STRINGCOLLECTION(textds_default_t, test_lcp); }
 TEST(ds, default_ISA)         { TEST_DS_STRINGCOLLECTION(textds_default_t, test_isa); }
 TEST(ds, default_Integration) { TEST_DS_STRINGCOLLECTION(textds_default_t, test_all_ds); }
+TEST(ds, default_ISA_lookup)  { TEST_DS_STRINGCOLLECTION(textds_default_t, test_isa_lookup); }
+
+TEST(ds, aligned_Integration) { TEST_DS_STRINGCOLLECTION_WITH(textds_default_t, test_aligned_width, "compress='aligned'"); }
+TEST(ds, aligned_ISA_lookup)  { TEST_DS_STRINGCOLLECTION_WITH(textds_default_t, test_isa_lookup, "compress='aligned'"); }
+
+// exposes the storage setter of ArrayDS
+class TestArrayDS: public ArrayDS {
+public:
+	TestArrayDS(iv_t&& iv) { set_array(std::move(iv)); }
+};
+
+TEST(ds, aligned_bytewise_access) {
+	std::mt19937_64 gen(47);
+	for(uint8_t w : {8, 16, 24, 33, 40, 48, 64}) {
+		for(size_t n : {1, 2, 7, 8, 9, 100, 1001}) {
+			const uint64_t mask = uint64_t(-1) >> (64 - w);
+			std::vector<uint64_t> expected(n);
+			TestArrayDS a(ArrayDS::iv_t(n, 0, w));
+			for(size_t i = 0; i < n; i++) {
+				expected[i] = gen() & mask;
+				a.set(i, expected[i]);
+			}
+			// overwrite every other element to check that neighbours are kept
+			for(size_t i = 0; i < n; i += 2) {
+				expected[i] = ~expected[i] & mask;
+				a.set(i, expected[i]);
+			}
+			const TestArrayDS& ca = a;
+			const DynamicIntVector& iv = a;
+			for(size_t i = 0; i < n; i++) {
+				ASSERT_EQ(expected[i], ca[i]) << "w=" << size_t(w) << ", i=" << i;
+				ASSERT_EQ(expected[i], uint64_t(iv[i])) << "w=" << size_t(w) << ", i=" << i;
+			}
+		}
+	}
+}
 
 using textds_sparse_isa_t = TextDS<
     SADivSufSort, PhiFromSA, PLCPFromPhi, LCPFromPLCP, SparseISA<SADivSufSort>>;
 
 TEST(ds, sparse_isa_ISA)         { TEST_DS_STRINGCOLLECTION(textds_sparse_isa_t, test_isa); }
 TEST(ds, sparse_isa_Integration) { TEST_DS_STRINGCOLLECTION(textds_sparse_isa_t, test_all_ds); }
+TEST(ds, sparse_isa_lookup)      { TEST_DS_STRINGCOLLECTION(textds_sparse_isa_t, test_isa_lookup); }
 
 using textds_comp_lcp_t = TextDS<
     SADivSufSort, PhiFromSA, PLCPFromPhi, CompressedLCP<SADivSufSort>, ISAFromSA>;
 
 TEST(ds, comp_lcp_LCP)         { TEST_DS_STRINGCOLLECTION(textds_comp_lcp_t, test_lcp); }
 TEST(ds, comp_lcp_Integration) { TEST_DS_STRINGCOLLECTION(textds_comp_lcp_t, test_all_ds); }
+
+using textds_dac_lcp_t = TextDS<
+    SADivSufSort, PhiFromSA, PLCPFromPhi, DACLCP, ISAFromSA>;
+
+TEST(ds, dac_lcp_LCP)         { TEST_DS_STRINGCOLLECTION(textds_dac_lcp_t, test_lcp); }
+TEST(ds, dac_lcp_Integration) { TEST_DS_STRINGCOLLECTION(textds_dac_lcp_t, test_all_ds); }
+TEST(ds, dac_lcp_relinquish)  { TEST_DS_STRINGCOLLECTION(textds_dac_lcp_t, test_lcp_relinquish); }
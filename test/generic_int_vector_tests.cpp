@@ -1,9 +1,11 @@
+#include <random>
 #include <string>
 #include <vector>
 
 #include <gtest/gtest.h>
 
 #include <tudocomp/ds/IntVector.hpp>
+#include <tudocomp/ds/StaticWidthView.hpp>
 #include <tudocomp/util/IntegerBase.hpp>
 #include <tudocomp/ds/uint_t.hpp>
 
@@ -1240,6 +1242,124 @@ TEST(generic_int_vector, dynamic_t_extra) {
     e.reserve(5, 10);
 }
 
+template<class T>
+void generic_int_vector_bulk_template(uint8_t width) {
+    std::mt19937_64 rnd(width);
+    const uint64_t mask = (~uint64_t(0)) >> (64 - width);
+    const size_t n = 1000;
+
+    IntVector<T> v;
+    v.resize(n, 0, width);
+    std::vector<uint64_t> expected(n);
+    auto check = [&]() {
+        for (size_t j = 0; j < n; j++) {
+            const typename IntVector<T>::value_type x = v[j];
+            ASSERT_EQ(expected[j], uint64_t(x));
+        }
+    };
+
+    // set_range and get_range on unaligned ranges of all lengths
+    for (size_t round = 0; round < 50; round++) {
+        const size_t i = rnd() % n;
+        const size_t len = rnd() % (n - i + 1);
+
+        std::vector<uint64_t> values(len);
+        for (auto& x : values) x = rnd();
+        v.set_range(i, len, values.data());
+        for (size_t j = 0; j < len; j++) expected[i + j] = values[j] & mask;
+
+        check();
+
+        const size_t k = rnd() % n;
+        const size_t klen = rnd() % (n - k + 1);
+        std::vector<uint64_t> out(klen);
+        v.get_range(k, klen, out.data());
+        for (size_t j = 0; j < klen; j++) ASSERT_EQ(expected[k + j], out[j]);
+    }
+
+    // fill
+    for (size_t round = 0; round < 20; round++) {
+        const size_t i = rnd() % n;
+        const size_t len = rnd() % (n - i + 1);
+        const uint64_t x = rnd() & mask;
+        v.fill(i, len, x);
+        for (size_t j = 0; j < len; j++) expected[i + j] = x;
+        check();
+    }
+}
+
+TEST(generic_int_vector, bulk_dynamic_t) {
+    for (uint8_t w = 1; w <= 64; w++) {
+        generic_int_vector_bulk_template<dynamic_t>(w);
+    }
+}
+
+TEST(generic_int_vector, bulk_uint_t) {
+    generic_int_vector_bulk_template<uint_t<7>>(7);
+    generic_int_vector_bulk_template<uint_t<9>>(9);
+    generic_int_vector_bulk_template<uint_t<33>>(33);
+    generic_int_vector_bulk_template<uint32_t>(32);
+}
+
+TEST(generic_int_vector, bulk_width_conversion) {
+    std::mt19937_64 rnd(42);
+    const size_t n = 2500; // more than one chunk of the conversion
+
+    for (uint8_t a = 1; a <= 64; a++) {
+        for (uint8_t b = 1; b <= 64; b++) {
+            const uint64_t mask = (~uint64_t(0)) >> (64 - std::min(a, b));
+
+            std::vector<uint64_t> values(n);
+            for (auto& x : values) x = rnd() & mask;
+
+            IntVector<dynamic_t> v(n, 0, a);
+            v.set_range(0, n, values.data());
+            v.width(b);
+            ASSERT_EQ(b, v.width());
+            ASSERT_EQ(n, v.size());
+            std::vector<uint64_t> actual(v.begin(), v.end());
+            ASSERT_EQ(values, actual);
+        }
+    }
+}
+
+TEST(generic_int_vector, with_static_width) {
+    for (uint8_t w = 1; w <= 64; w++) {
+        const uint64_t mask = (~uint64_t(0)) >> (64 - w);
+        IntVector<dynamic_t> a(100, 0, w);
+        IntVector<dynamic_t> b(100, 0, w);
+
+        with_static_width(a, [&](auto view) {
+            ASSERT_EQ(w, view.width());
+            ASSERT_EQ(100U, view.size());
+            for (size_t i = 0; i < view.size(); i++) view[i] = i * 0x9E3779B97F4A7C15ULL;
+        });
+        for (size_t i = 0; i < a.size(); i++) {
+            ASSERT_EQ((i * 0x9E3779B97F4A7C15ULL) & mask, uint64_t(a[i]));
+        }
+
+        // views of two vectors of the same width
+        const IntVector<dynamic_t>& ca = a;
+        with_static_width(ca, b, [&](auto va, auto vb) {
+            ASSERT_EQ(w, va.width());
+            ASSERT_EQ(w, vb.width());
+            for (size_t i = 0; i < va.size(); i++) vb[va.size() - 1 - i] = va[i];
+        });
+        for (size_t i = 0; i < a.size(); i++) {
+            ASSERT_EQ(uint64_t(a[i]), uint64_t(b[b.size() - 1 - i]));
+        }
+
+        // views of two vectors of different widths
+        IntVector<dynamic_t> c(100, 0, 64);
+        with_static_width(ca, c, [&](auto va, auto&& vc) {
+            for (size_t i = 0; i < va.size(); i++) vc[i] = va[i];
+        });
+        for (size_t i = 0; i < a.size(); i++) {
+            ASSERT_EQ(uint64_t(a[i]), uint64_t(c[i]));
+        }
+    }
+}
+
 template<size_t N>
 void generic_int_vector_trait_template() {
     using namespace int_vector;
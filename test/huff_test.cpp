@@ -4,7 +4,10 @@
 #include <cstring>
 #include <bitset>
 #include <algorithm>
+#include <queue>
+#include <random>
 #include <tudocomp/coders/HuffmanCoder.hpp>
+#include <tudocomp/compressors/LiteralEncoder.hpp>
 
 using namespace tdc;
 
@@ -138,6 +141,86 @@ TEST(huffman, stringgenerators) {
 //
 // }
 
+// checks that the lengths form a complete prefix code of at most
+// max_length bits and returns its cost
+size_t check_codelengths(const std::vector<size_t>& weights,
+                         const std::vector<uint8_t>& lengths,
+                         size_t max_length) {
+    EXPECT_EQ(weights.size(), lengths.size());
+    size_t kraft = 0, cost = 0;
+    for(size_t i = 0; i < weights.size(); ++i) {
+        EXPECT_GT(lengths[i], 0);
+        EXPECT_LE(lengths[i], max_length);
+        kraft += size_t(1) << (max_length - lengths[i]);
+        cost += weights[i] * lengths[i];
+    }
+    EXPECT_EQ(size_t(1) << max_length, kraft);
+    return cost;
+}
+
+// the cost of an optimal prefix code without length limit
+size_t huffman_cost(const std::vector<size_t>& weights) {
+    std::priority_queue<size_t, std::vector<size_t>, std::greater<size_t>> q(
+        weights.begin(), weights.end());
+    size_t cost = 0;
+    while(q.size() > 1) {
+        const size_t a = q.top(); q.pop();
+        const size_t b = q.top(); q.pop();
+        cost += a + b;
+        q.push(a + b);
+    }
+    return cost;
+}
+
+TEST(huff, limited_codelengths) {
+    std::mt19937 rng(42);
+    for(size_t n : { 2, 3, 17, 256, 5000 }) {
+        std::vector<size_t> weights(n);
+        for(auto& w : weights) w = 1 + rng() % 1000;
+
+        const auto lengths = huff::gen_limited_codelengths(weights, 32);
+        ASSERT_EQ(huffman_cost(weights),
+                  check_codelengths(weights, lengths, 32)) << "n=" << n;
+    }
+
+    // Fibonacci weights yield a Huffman code of length n-1
+    std::vector<size_t> fib { 1, 1 };
+    while(fib.size() < 40) fib.push_back(fib[fib.size() - 1] + fib[fib.size() - 2]);
+    std::shuffle(fib.begin(), fib.end(), rng);
+    {
+        const auto lengths = huff::gen_limited_codelengths(fib, 64);
+        ASSERT_EQ(39, *std::max_element(lengths.begin(), lengths.end()));
+        ASSERT_EQ(huffman_cost(fib), check_codelengths(fib, lengths, 39));
+    }
+    size_t last_cost = huffman_cost(fib);
+    for(size_t max_length = 38; max_length >= 6; --max_length) {
+        const auto lengths = huff::gen_limited_codelengths(fib, max_length);
+        const size_t cost = check_codelengths(fib, lengths, max_length);
+        ASSERT_GE(cost, last_cost) << "max_length=" << max_length;
+        last_cost = cost;
+    }
+}
+
+TEST(huff, limited_roundtrip) {
+    // skewed distribution that needs 20 bits without limit
+    std::string text;
+    size_t a = 1, b = 1;
+    for(char c = 'a'; c <= 'u'; ++c) {
+        text.append(a, c);
+        const size_t t = a + b; a = b; b = t;
+    }
+    std::shuffle(text.begin(), text.end(), std::mt19937(7));
+
+    for(const std::string options : { "", "coder=huff(8)", "coder=huff(5)" }) {
+        test::roundtrip_ex<LiteralEncoder<HuffmanCoder>>(text, "", options);
+    }
+
+    // 256 codewords of the same length
+    std::string all;
+    for(size_t i = 0; i < 4 * 256; ++i) all.push_back(char(i));
+    test::roundtrip_ex<LiteralEncoder<HuffmanCoder>>(all, "");
+}
+
 TEST(huff, nullbyte) {
     test_huff("hel\0lo"_v);
     test_huff("hello\0"_v);
@@ -25,8 +25,9 @@ using namespace lfs;
 
 
 
+template<class comp_t>
 void run_comp(std::string compression_string) {
-    auto c = create_algo<tdc::lfs::LFS2BSTCompressor<> >();
+    auto c = create_algo<comp_t>();
 
     std::string compressed;
     // compress
@@ -57,21 +58,43 @@ void run_comp(std::string compression_string) {
 
 TEST(lfs2, no_strat){
 
+    typedef tdc::lfs::LFS2BSTCompressor<> comp;
 
-    run_comp("");
-    run_comp("a");
-    run_comp("foobar");
+    run_comp<comp>("");
+    run_comp<comp>("a");
+    run_comp<comp>("foobar");
 
-    run_comp("ab");
-    run_comp("abcd$");
+    run_comp<comp>("ab");
+    run_comp<comp>("abcd$");
 
-    run_comp("abab");
+    run_comp<comp>("abab");
 
-    run_comp("abaaabbababb$");
+    run_comp<comp>("abaaabbababb$");
 
-    run_comp("ccaabbaabbcca$");
+    run_comp<comp>("ccaabbaabbcca$");
 
 
 }
 
+TEST(lfs2, st){
+
+    typedef tdc::lfs::LFS2Compressor<> comp;
+
+    run_comp<comp>("");
+    run_comp<comp>("a");
+    run_comp<comp>("foobar");
+
+    run_comp<comp>("ab");
+    run_comp<comp>("abcd$");
+
+    run_comp<comp>("abab");
+
+    run_comp<comp>("abaaabbababb$");
+
+    run_comp<comp>("ccaabbaabbcca$");
+
+    test::roundtrip_batch(run_comp<comp>);
+    test::on_string_generators(run_comp<comp>, 11);
+}
+
 
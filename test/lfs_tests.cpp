@@ -86,7 +86,7 @@ TEST(lfs, bst_strat){
 
 TEST(lfs, sim_st_strat){
 
-    typedef tdc::lfs::SimSTStrategy esa_strat;
+    typedef tdc::lfs::SimSTStrategy<> esa_strat;
 
     run_comp<esa_strat >("");
     run_comp<esa_strat >("a");
@@ -104,6 +104,32 @@ TEST(lfs, sim_st_strat){
    // run_comp_file<tdc::lfs::SimSTStrategy<> >("english.1MB");
 }
 
+TEST(lfs, st_strat){
+
+    typedef tdc::lfs::STStrategy<> esa_strat;
+
+    run_comp<esa_strat >("");
+    run_comp<esa_strat >("a");
+    run_comp<esa_strat >("foobar");
+
+    run_comp<esa_strat >("ab");
+    run_comp<esa_strat >("abcd$");
+
+    run_comp<esa_strat >("abab");
+
+    run_comp<esa_strat >("abaaabbababb$");
+
+    run_comp<esa_strat >("ccaabbaabbcca$");
+}
+
+TEST(lfs, st_strat_batch){
+    test::roundtrip_batch(run_comp<tdc::lfs::STStrategy<> >);
+    test::on_string_generators(run_comp<tdc::lfs::STStrategy<> >, 11);
+
+    test::roundtrip_batch(run_comp<tdc::lfs::SimSTStrategy<> >);
+    test::on_string_generators(run_comp<tdc::lfs::SimSTStrategy<> >, 11);
+}
+
 TEST(lfs, esa_strat){
 
     typedef tdc::lfs::ESAStrategy<> esa_strat;
@@ -121,7 +147,8 @@ TEST(lfs, esa_strat){
 
     run_comp<esa_strat >("ccaabbaabbcca$");
 
-
+    test::roundtrip_batch(run_comp<esa_strat >);
+    test::on_string_generators(run_comp<esa_strat >, 11);
 }
 
 //TEST(lfs, esa_strat2){
@@ -0,0 +1,32 @@
+#include "test/util.hpp"
+#include <gtest/gtest.h>
+
+#include <tudocomp/compressors/LZ78Compressor.hpp>
+#include <tudocomp/compressors/LZWCompressor.hpp>
+#include <tudocomp/compressors/lz78/TernaryTrie.hpp>
+#include <tudocomp/coders/BitCoder.hpp>
+
+using namespace tdc;
+
+template<class C>
+void parallel_roundtrip(const std::string& options) {
+    test::roundtrip_batch([&](string_ref text) {
+        test::roundtrip_ex<C>(text, "", options);
+    });
+    test::on_string_generators([&](string_ref text) {
+        test::roundtrip_ex<C>(text, "", options);
+    }, 15);
+}
+
+TEST(ParallelLz78, roundtrip) {
+    parallel_roundtrip<LZ78Compressor<BitCoder, lz78::TernaryTrie>>("threads=4");
+}
+TEST(ParallelLz78, roundtrip_seed) {
+    parallel_roundtrip<LZ78Compressor<BitCoder, lz78::TernaryTrie>>("threads=3, seed=64");
+}
+TEST(ParallelLzw, roundtrip) {
+    parallel_roundtrip<LZWCompressor<BitCoder, lz78::TernaryTrie>>("threads=4");
+}
+TEST(ParallelLzw, roundtrip_seed) {
+    parallel_roundtrip<LZWCompressor<BitCoder, lz78::TernaryTrie>>("threads=3, seed=64");
+}
@@ -58,7 +58,7 @@ struct TestTrie {
 };
 
 template<typename T>
-void trie_test_single(TestTrie test, bool test_values) {
+void trie_test_single(TestTrie test, bool test_values, const std::string& options) {
     auto& should_trie = test.root;
 
     // Only add single \0 root for now.
@@ -67,7 +67,7 @@ void trie_test_single(TestTrie test, bool test_values) {
     size_t is_trie_size = 1;
 
     size_t remaining = test.input.size();
-    auto trie = builder<T>().instance(remaining, remaining);
+    auto trie = builder<T>().options(options).instance(remaining, remaining);
     trie.add_rootnode(0);
 
     auto is_trie_node = &is_trie;
@@ -100,7 +100,7 @@ void trie_test_single(TestTrie test, bool test_values) {
 }
 
 template<typename T>
-void trie_test(bool test_values = true) {
+void trie_test(bool test_values = true, const std::string& options = "") {
     trie_test_single<T>({
         "abcdebcdeabc",
         {'\0',0,{
@@ -116,13 +116,13 @@ void trie_test(bool test_values = true) {
             }},
             {'e',5,{}},
         }},
-    }, test_values);
+    }, test_values, options);
     trie_test_single<T>({
         "a",
         {'\0',0, {
             {'a',1,{}}
         }},
-    }, test_values);
+    }, test_values, options);
     trie_test_single<T>({
         "abcdefgh#defgh_abcde",
         {'\0',0, {
@@ -146,7 +146,7 @@ void trie_test(bool test_values = true) {
                 {'_',12,{}},
             }},
         }},
-    }, test_values);
+    }, test_values, options);
     trie_test_single<T>({
         "ประเทศไทย中华Việt Nam",
         {'\0',0, {
@@ -184,7 +184,7 @@ void trie_test(bool test_values = true) {
             {228,14,{}},
             {229,16,{}},
         }},
-    }, test_values);
+    }, test_values, options);
 }
 
 #include <tudocomp/compressors/lz78/BinaryTrie.hpp>
@@ -266,6 +266,25 @@ TEST(TrieStructure, CompactSparseHashTrie) {
 TEST(Trie, CompactSparseHashTrie) {
     trie_test<CompactSparseHashTrie>();
 }
+TEST(Trie, CompactSparseHashTrieIncremental) {
+    trie_test<CompactSparseHashTrie>(true, "incremental_growth=true");
+}
+
+#include <tudocomp/compressors/lz78/CompactDisplacementHashTrie.hpp>
+TEST(TrieStructure, CompactDisplacementHashTrie) {
+    trie_test<CompactDisplacementHashTrie>(false);
+}
+TEST(Trie, CompactDisplacementHashTrie) {
+    trie_test<CompactDisplacementHashTrie>();
+}
+
+#include <tudocomp/compressors/lz78/GroupHashTrie.hpp>
+TEST(TrieStructure, GroupHashTrie) {
+    trie_test<GroupHashTrie<>>(false);
+}
+TEST(Trie, GroupHashTrie) {
+    trie_test<GroupHashTrie<>>();
+}
 
 // #include <tudocomp/compressors/lz78/MBonsaiTrie.hpp>
 // TEST(TrieStructure, MBonsaiGammaTrie) {
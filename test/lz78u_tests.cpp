@@ -6,6 +6,9 @@
 #include <tudocomp/compressors/lz78u/StreamingStrategy.hpp>
 #include <tudocomp/coders/ASCIICoder.hpp>
 #include <tudocomp/coders/HuffmanCoder.hpp>
+#include <tudocomp/coders/BitCoder.hpp>
+#include <tudocomp/coders/RangeCoder.hpp>
+#include <tudocomp/coders/RANSCoder.hpp>
 
 using namespace tdc;
 using namespace lz78u;
@@ -180,3 +183,32 @@ TEST(Lz78U, roundtrip3) {
         }
     );
 }
+
+TEST(Lz78U, roundtrip_batch) {
+    auto f = [](const std::string& text) {
+        test::roundtrip<LZ78UCompressor<StreamingStrategy<ASCIICoder>, ASCIICoder>>(text);
+        test::roundtrip<LZ78UCompressor<BufferingStrategy<HuffmanCoder>, ASCIICoder>>(text);
+    };
+    test::roundtrip_batch(f);
+    test::on_string_generators(f, 11);
+}
+
+TEST(Lz78U, roundtrip_range) {
+    auto f = [](const std::string& text) {
+        test::roundtrip<LZ78UCompressor<StreamingStrategy<BitCoder>, RangeCoder>>(text);
+        test::roundtrip<LZ78UCompressor<StreamingStrategy<RangeCoder>, BitCoder>>(text);
+        test::roundtrip<LZ78UCompressor<StreamingStrategy<RangeCoder>, RangeCoder>>(text);
+        test::roundtrip<LZ78UCompressor<BufferingStrategy<RangeCoder>, RangeCoder>>(text);
+    };
+    test::roundtrip_batch(f);
+    test::on_string_generators(f, 11);
+}
+
+TEST(Lz78U, roundtrip_rans) {
+    auto f = [](const std::string& text) {
+        test::roundtrip<LZ78UCompressor<BufferingStrategy<RANSCoder>, BitCoder>>(text);
+        test::roundtrip<LZ78UCompressor<BufferingStrategy<RANSCoder>, RangeCoder>>(text);
+    };
+    test::roundtrip_batch(f);
+    test::on_string_generators(f, 11);
+}
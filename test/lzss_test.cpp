@@ -1,15 +1,24 @@
+#include "test/util.hpp"
 #include <gtest/gtest.h>
 
+#include <random>
+
 #include <tudocomp/Compressor.hpp>
 #include <tudocomp/Generator.hpp>
 #include <tudocomp/CreateAlgorithm.hpp>
 
+#include <tudocomp/coders/BitCoder.hpp>
+#include <tudocomp/coders/RangeCoder.hpp>
+#include <tudocomp/compressors/LZSSLCPCompressor.hpp>
+#include <tudocomp/compressors/LZSSStreamingCompressor.hpp>
 #include <tudocomp/compressors/lzss/LZSSCoding.hpp>
 #include <tudocomp/compressors/lzss/LZSSFactors.hpp>
 #include <tudocomp/compressors/lzss/LZSSLiterals.hpp>
 
+#include <tudocomp/compressors/lcpcomp/decompress/BlockScanDec.hpp>
 #include <tudocomp/compressors/lcpcomp/decompress/CompactDec.hpp>
 #include <tudocomp/compressors/lcpcomp/decompress/DecodeQueueListBuffer.hpp>
+#include <tudocomp/compressors/lcpcomp/decompress/ForwardListDec.hpp>
 #include <tudocomp/compressors/lcpcomp/decompress/MultiMapBuffer.hpp>
 
 using namespace tdc;
@@ -58,6 +67,32 @@ TEST(lzss, factor_buffer_sort) {
     }
 }
 
+TEST(lzss, factor_buffer_radix_sort) {
+    // enough factors with large positions for several radix passes
+    const size_t n = 100000;
+    std::vector<size_t> positions(n);
+    for(size_t i = 0; i < n; i++) positions[i] = i * 977;
+    std::mt19937 rng(42);
+    std::shuffle(positions.begin(), positions.end(), rng);
+
+    lzss::FactorBuffer buf;
+    for(size_t p : positions) {
+        buf.emplace_back(p, p / 2, p % 100 + 1);
+    }
+    ASSERT_FALSE(buf.is_sorted());
+
+    buf.sort();
+    ASSERT_TRUE(buf.is_sorted());
+    ASSERT_EQ(n, buf.size());
+
+    size_t i = 0;
+    for(auto it = buf.begin(); it != buf.end(); ++it, ++i) {
+        ASSERT_EQ(i * 977, it->pos);
+        ASSERT_EQ(it->pos / 2, it->src);
+        ASSERT_EQ(it->pos % 100 + 1, it->len);
+    }
+}
+
 TEST(lzss, text_literals_empty) {
     lzss::FactorBuffer empty;
     std::string tmp = "";
@@ -185,6 +220,26 @@ void test_forward_decode_buffer_multiref() {
     ASSERT_EQ("bananabanana", ss.str());
 }
 
+template<typename T>
+void test_forward_decode_buffer_long_chain() {
+    // every position refers to its right neighbor,
+    // such that the last literal decodes a chain of length n
+    const size_t n = 1000000;
+    T buffer = create_algo<T>("", n + 2);
+    buffer.decode_factor(1, n);
+    buffer.decode_literal('a');
+    buffer.decode_literal(0);
+    buffer.decode_lazy();
+    buffer.decode_eagerly();
+
+    std::stringstream ss;
+    buffer.write_to(ss);
+
+    std::string expected(n + 1, 'a');
+    expected.push_back(0);
+    ASSERT_EQ(expected, ss.str());
+}
+
 TEST(lzss, decode_forward_lm_buffer_chain) {
     test_forward_decode_buffer_chain<lcpcomp::CompactDec>();
 }
@@ -208,3 +263,130 @@ TEST(lzss, decode_forward_ql_buffer_chain) {
 TEST(lzss, decode_forward_ql_buffer_multiref) {
     test_forward_decode_buffer_multiref<lcpcomp::DecodeForwardQueueListBuffer>();
 }
+
+TEST(lzss, decode_forward_lm_buffer_long_chain) {
+    test_forward_decode_buffer_long_chain<lcpcomp::CompactDec>();
+}
+
+TEST(lzss, decode_forward_ql_buffer_long_chain) {
+    test_forward_decode_buffer_long_chain<lcpcomp::DecodeForwardQueueListBuffer>();
+}
+
+TEST(lzss, decode_forward_list_chain) {
+    test_forward_decode_buffer_chain<lcpcomp::ForwardListDec>();
+}
+
+TEST(lzss, decode_forward_list_multiref) {
+    test_forward_decode_buffer_multiref<lcpcomp::ForwardListDec>();
+}
+
+TEST(lzss, decode_forward_list_long_chain) {
+    test_forward_decode_buffer_long_chain<lcpcomp::ForwardListDec>();
+}
+
+TEST(lzss, decode_forward_block_scan_chain) {
+    test_forward_decode_buffer_chain<lcpcomp::BlockScanDec>();
+}
+
+TEST(lzss, decode_forward_block_scan_multiref) {
+    test_forward_decode_buffer_multiref<lcpcomp::BlockScanDec>();
+}
+
+TEST(lzss, decode_forward_block_scan_long_chain) {
+    test_forward_decode_buffer_long_chain<lcpcomp::BlockScanDec>();
+}
+
+TEST(lzss, decode_forward_block_scan_random) {
+    // periodic text, split into segments that are either literals or
+    // copies of segments that were generated before (in random order)
+    const size_t n = 5000;
+    const size_t period = 7;
+    std::string text;
+    for(size_t i = 0; i + 1 < n; ++i) text.push_back('a' + (i * 3) % period);
+    text.push_back(0);
+
+    std::mt19937 rng(42);
+    std::vector<std::pair<size_t, size_t>> segments;
+    for(size_t i = 0; i < n - 1;) {
+        size_t len = std::min<size_t>(1 + rng() % 40, n - 1 - i);
+        segments.emplace_back(i, len);
+        i += len;
+    }
+    std::vector<size_t> order(segments.size());
+    for(size_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::shuffle(order.begin(), order.end(), rng);
+
+    std::vector<bool> available(n, false);
+    std::vector<size_t> sources(segments.size(), n); // n marks a literal segment
+    for(size_t k : order) {
+        const size_t target = segments[k].first;
+        const size_t len = segments[k].second;
+        for(size_t attempt = 0; attempt < 20; ++attempt) {
+            const size_t src = target % period + period * (rng() % ((n - 1 - len) / period));
+            if(src == target || src + len > n - 1) continue;
+            bool ok = true;
+            for(size_t i = 0; i < len && ok; ++i) ok = available[src + i];
+            if(ok) { sources[k] = src; break; }
+        }
+        for(size_t i = 0; i < len; ++i) available[target + i] = true;
+    }
+
+    for(const std::string options : { "0, 1, 1", "1, 3, 1", "6, 100, 1", "2, 262144, 1", "3, 50, 4", "100, 1000, 2" }) {
+        auto buffer = create_algo<lcpcomp::BlockScanDec>(options, n);
+        for(size_t k = 0; k < segments.size(); ++k) {
+            if(sources[k] == n) {
+                for(size_t i = 0; i < segments[k].second; ++i) {
+                    buffer.decode_literal(text[segments[k].first + i]);
+                }
+            } else {
+                buffer.decode_factor(sources[k], segments[k].second);
+            }
+        }
+        buffer.decode_literal(0);
+        buffer.decode_lazy();
+        buffer.decode_eagerly();
+
+        std::stringstream ss;
+        buffer.write_to(ss);
+        ASSERT_EQ(text, ss.str()) << options;
+    }
+}
+
+TEST(lzss, lcp_compressor_roundtrip) {
+    using C = LZSSLCPCompressor<BitCoder>;
+    test::roundtrip_batch([&](string_ref text) {
+        test::roundtrip_ex<C>(text, "");
+    });
+    test::on_string_generators([&](string_ref text) {
+        test::roundtrip_ex<C>(text, "");
+    }, 15);
+
+    // long runs of increasing characters
+    std::string text;
+    for(size_t i = 0; i < 10000; ++i) text.push_back('a' + i / 500);
+    test::roundtrip_ex<C>(text, "");
+}
+
+TEST(lzss, lcp_compressor_range_coder_roundtrip) {
+    using C = LZSSLCPCompressor<RangeCoder>;
+    for(const std::string options : { "", "coder=range(2, 100)" }) {
+        test::roundtrip_batch([&](string_ref text) {
+            test::roundtrip_ex<C>(text, "", options);
+        });
+        test::on_string_generators([&](string_ref text) {
+            test::roundtrip_ex<C>(text, "", options);
+        }, 15);
+    }
+}
+
+TEST(lzss, streaming_compressor_roundtrip) {
+    using C = LZSSStreamingCompressor<BitCoder>;
+    for(const std::string options : { "memory=1", "memory=4", "" }) {
+        test::roundtrip_batch([&](string_ref text) {
+            test::roundtrip_ex<C>(text, "", options);
+        });
+        test::on_string_generators([&](string_ref text) {
+            test::roundtrip_ex<C>(text, "", options);
+        }, 15);
+    }
+}
@@ -4,6 +4,7 @@
 #include <random>
 
 #include <tudocomp/ds/ArrayMaxHeap.hpp>
+#include <tudocomp/ds/BucketQueue.hpp>
 #include <tudocomp/compressors/lcpcomp/MaxLCPSuffixList.hpp>
 #include "test/util.hpp"
 
@@ -145,6 +146,105 @@ void test_list_dec_key(const size_t n, const size_t seed) {
     test_dec_key(n, seed, ds, lcp);
 }
 
+void test_list_static_width_dec_key(const size_t n, const size_t seed) {
+    // generate
+    VLOG(2) << "  Generating ...";
+    vec lcp; size_t max_lcp;
+    generate_lcp(n, seed, lcp, max_lcp);
+
+    VLOG(2) << "  Inserting ...";
+    with_static_width(bits_for(n), [&](auto w) {
+        lcpcomp::MaxLCPSuffixList<vec, decltype(w)::value> ds(lcp, MIN_POSSIBLE_LCP, max_lcp);
+
+        // test size
+        ASSERT_EQ(n-1, ds.size());
+
+        // test
+        test_dec_key(n, seed, ds, lcp);
+    });
+}
+
+void test_bucket_remove_only(const size_t n, const size_t seed) {
+    // generate
+    VLOG(2) << "  Generating ...";
+    vec lcp; size_t max_lcp;
+    generate_lcp(n, seed, lcp, max_lcp);
+
+    VLOG(2) << "  Inserting ...";
+    BucketQueue<vec> ds(lcp, n, MIN_POSSIBLE_LCP, max_lcp);
+    for(size_t i = 1; i < n; i++) ds.insert(i);
+
+    // test size
+    ASSERT_EQ(n-1, ds.size());
+
+    // test
+    test_remove_only(n, seed, ds, lcp);
+}
+
+void test_bucket_dec_key(const size_t n, const size_t seed) {
+    // generate
+    VLOG(2) << "  Generating ...";
+    vec lcp; size_t max_lcp;
+    generate_lcp(n, seed, lcp, max_lcp);
+
+    VLOG(2) << "  Inserting ...";
+    BucketQueue<vec> ds(lcp, n, MIN_POSSIBLE_LCP, max_lcp);
+    for(size_t i = 1; i < n; i++) ds.insert(i);
+
+    // test size
+    ASSERT_EQ(n-1, ds.size());
+
+    // test
+    test_dec_key(n, seed, ds, lcp);
+}
+
+void test_bucket_batch_dec_key(const size_t n, const size_t seed) {
+    // generate
+    VLOG(2) << "  Generating ...";
+    vec lcp; size_t max_lcp;
+    generate_lcp(n, seed, lcp, max_lcp);
+
+    VLOG(2) << "  Inserting ...";
+    BucketQueue<vec> ds(lcp, n, MIN_POSSIBLE_LCP, max_lcp);
+    for(size_t i = 1; i < n; i++) ds.insert(i);
+
+    // test item order, decreasing the keys of or removing random items
+    // that are not the maximum, then compare against a naive scan
+    VLOG(2) << "  Testing ...";
+    std::default_random_engine rnd(seed);
+    std::uniform_int_distribution<size_t> gen_item(1, n-1);
+    while(ds.size()) {
+        for(size_t k = gen_dice(rnd); k > 0; k--) {
+            size_t i = gen_item(rnd);
+            if(!ds.contains(i)) continue;
+
+            if(gen_dice(rnd) <= 4) {
+                // decrease key, possibly below the minimum
+                size_t amt = std::min(gen_dice(rnd) * 8, lcp[i]);
+                ds.decrease_key(i, lcp[i] - amt);
+            } else {
+                ds.remove(i);
+            }
+        }
+
+        size_t expected_size = 0, expected_max = 0;
+        for(size_t i = 1; i < n; i++) {
+            if(ds.contains(i)) {
+                ASSERT_GE(lcp[i], MIN_POSSIBLE_LCP);
+                ++expected_size;
+                expected_max = std::max(expected_max, lcp[i]);
+            }
+        }
+        ASSERT_EQ(expected_size, ds.size()) << "n = " << n << ", seed = " << seed;
+        if(!ds.size()) break;
+
+        size_t m = ds.get_max();
+        ASSERT_TRUE(ds.contains(m));
+        ASSERT_EQ(expected_max, lcp[m]) << "n = " << n << ", seed = " << seed;
+        ds.remove(m);
+    }
+}
+
 template<typename testfunc_t>
 void test_run(testfunc_t f) {
     for(size_t i = 0; i < NUM_TESTS; i++) {
@@ -172,3 +272,18 @@ TEST(MaxLCP, list_dec_key) {
     test_run(test_list_dec_key);
 }
 
+TEST(MaxLCP, list_static_width_dec_key) {
+    test_run(test_list_static_width_dec_key);
+}
+
+TEST(MaxLCP, bucket_remove_only) {
+    test_run(test_bucket_remove_only);
+}
+
+TEST(MaxLCP, bucket_dec_key) {
+    test_run(test_bucket_dec_key);
+}
+
+TEST(MaxLCP, bucket_batch_dec_key) {
+    test_run(test_bucket_batch_dec_key);
+}
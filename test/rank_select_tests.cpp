@@ -6,6 +6,9 @@
 #include <tudocomp/ds/select_64bit.hpp>
 #include <tudocomp/ds/Rank.hpp>
 #include <tudocomp/ds/Select.hpp>
+#include <tudocomp/ds/RankSelect.hpp>
+
+#include <random>
 
 using namespace tdc;
 
@@ -270,3 +273,74 @@ TEST(rank_select, inverse_property_bv) {
         }
     });
 }
+
+TEST(rank_select, interleaved_bv) {
+    NK_test([](size_t N, size_t K){
+        //1
+        {
+            BitVector bv(N);
+
+            // set every K-th bit
+            for(size_t i = 0; i < N; i += K) bv[i] = 1;
+
+            RankSelect rs(bv);
+
+            ASSERT_EQ(N/K, rs.rank1(N-1));
+            for(size_t i = 1; i <= N/K; i++) ASSERT_EQ(i, rs.rank1(K*i-1));
+
+            ASSERT_EQ(N, rs.select1(1+N/K));
+            for(size_t i = 1; i <= N/K; i++) ASSERT_EQ(K*(i-1), rs.select1(i));
+        }
+        //0
+        {
+            BitVector bv(N, 1);
+
+            // unset every K-th bit
+            for(size_t i = 0; i < N; i += K) bv[i] = 0;
+
+            RankSelect rs(bv);
+
+            ASSERT_EQ(N/K, rs.rank0(N-1));
+            for(size_t i = 1; i <= N/K; i++) ASSERT_EQ(i, rs.rank0(K*i-1));
+
+            ASSERT_EQ(N, rs.select0(1+N/K));
+            for(size_t i = 1; i <= N/K; i++) ASSERT_EQ(K*(i-1), rs.select0(i));
+        }
+    });
+}
+
+TEST(rank_select, interleaved_random) {
+    std::mt19937_64 rnd(43);
+    for(size_t n : {1, 63, 64, 447, 448, 449, 1000, 100003}) {
+        for(size_t density : {1, 10, 50, 90, 99}) {
+            BitVector bv(n);
+            for(size_t i = 0; i < n; i++) bv[i] = (rnd() % 100) < density;
+
+            RankSelect rs(bv);
+            ASSERT_EQ(n, rs.size());
+
+            size_t ones = 0;
+            for(size_t i = 0; i < n; i++) {
+                ASSERT_EQ(bool(bv[i]), rs[i]);
+                if(bv[i]) {
+                    ++ones;
+                    ASSERT_EQ(i, rs.select1(ones));
+                } else {
+                    ASSERT_EQ(i, rs.select0(i + 1 - ones));
+                }
+                ASSERT_EQ(ones, rs.rank1(i));
+                ASSERT_EQ(i + 1 - ones, rs.rank0(i));
+            }
+            ASSERT_EQ(n, rs.select1(ones + 1));
+            ASSERT_EQ(n, rs.select0(n - ones + 1));
+
+            // copies are independent of the original
+            RankSelect copy(rs);
+            rs = RankSelect();
+            for(size_t i = 0; i < n; i++) ASSERT_EQ(bool(bv[i]), copy[i]);
+            if(n > 0) {
+                ASSERT_EQ(ones, copy.rank1(n - 1));
+            }
+        }
+    }
+}
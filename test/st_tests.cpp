@@ -1,26 +1,184 @@
 #include <gtest/gtest.h>
 
-#include <sdsl/cst_sada.hpp>
-#include <tudocomp/compressors/lz78u/SuffixTree.hpp>
+#include <set>
+#include <tuple>
+
+#include <tudocomp/ds/TextDS.hpp>
+#include <tudocomp/ds/CompactSuffixTree.hpp>
+#include <tudocomp/ds/LCPIntervals.hpp>
+#include <tudocomp/CreateAlgorithm.hpp>
 #include "test/util.hpp"
 
 using namespace tdc;
-using namespace tdc::lz78u;
-
-void test_strdepth(const std::string& str) {
-	if(str.length() == 0) return;
-	sdsl::cst_sada<> cst;
-	sdsl::construct_im(cst, str, 1);
-    SuffixTree st(cst);
-	root_childrank_support rrank(cst.bp_support);
-	for(auto node : cst) {
-		ASSERT_EQ(st.str_depth(node), rrank.str_depth(st,node));
+
+size_t longest_common_extension(const std::string& text, size_t a, size_t b) {
+	size_t i = 0;
+	while(a+i < text.size() && b+i < text.size() && text[a+i] == text[b+i]) { ++i; }
+	return i;
+}
+
+void test_compact_st(const std::string& str) {
+	test::TestInput input = test::compress_input(str);
+	io::InputView in = input.as_view();
+	auto t = create_algo<TextDS<>>("", in);
+	t.require(TextDS<>::SA | TextDS<>::ISA | TextDS<>::LCP);
+	CompactSuffixTree st(t.require_sa(), t.require_lcp());
+
+	const std::string text = in.slice(0, in.size());
+	const size_t n = text.size();
+	ASSERT_EQ(n, st.size());
+	ASSERT_LE(st.internal_nodes(), n);
+	ASSERT_EQ(0U, st.str_depth(st.root()));
+	ASSERT_EQ(0U, st.depth(st.root()));
+
+	auto& sa = t.require_sa();
+	auto& isa = t.require_isa();
+
+	std::set<size_t> nodes;
+	for(size_t pos = 0; pos < n; ++pos) {
+		const auto leaf = st.leaf(pos);
+		ASSERT_TRUE(st.is_leaf(leaf));
+		ASSERT_EQ(pos, st.leaf_pos(leaf));
+		ASSERT_EQ(n - pos, st.str_depth(leaf));
+
+		// the string depths of the inner nodes on the path to the leaf are
+		// the longest common extensions with all other suffixes
+		std::set<size_t> lce { 0 };
+		for(size_t q = 0; q < n; ++q) {
+			if(q != pos) lce.insert(longest_common_extension(text, pos, q));
+		}
+
+		std::set<size_t> path;
+		const size_t depth = st.depth(leaf);
+		ASSERT_EQ(leaf, st.level_anc(leaf, depth));
+		for(size_t d = 0; d < depth; ++d) {
+			const auto v = st.level_anc(leaf, d);
+			ASSERT_FALSE(st.is_leaf(v));
+			ASSERT_LT(v, st.internal_nodes());
+			ASSERT_EQ(d, st.depth(v));
+			ASSERT_EQ(v, st.level_anc(v, d));
+			ASSERT_EQ(v, st.parent(st.level_anc(leaf, d + 1)));
+			if(d > 0) {
+				ASSERT_LT(st.str_depth(st.parent(v)), st.str_depth(v));
+			}
+			ASSERT_LE(st.lb(v), size_t(isa[pos]));
+			ASSERT_GE(st.rb(v), size_t(isa[pos]));
+			path.insert(st.str_depth(v));
+			nodes.insert(v);
+		}
+		ASSERT_EQ(lce, path);
+	}
+	ASSERT_EQ(st.internal_nodes(), nodes.size());
+
+	// the suffixes of an interval share exactly the string depth of its node,
+	// and the children partition it
+	for(size_t v = 0; v < st.internal_nodes(); ++v) {
+		const size_t lb = st.lb(v), rb = st.rb(v);
+		ASSERT_TRUE(lb < rb || n == 1);
+		for(size_t i = lb; i < rb; ++i) {
+			ASSERT_GE(longest_common_extension(text, sa[i], sa[i + 1]), st.str_depth(v));
+		}
+		if(lb > 0) {
+			ASSERT_LT(longest_common_extension(text, sa[lb - 1], sa[lb]), st.str_depth(v));
+		}
+		if(rb + 1 < n) {
+			ASSERT_LT(longest_common_extension(text, sa[rb], sa[rb + 1]), st.str_depth(v));
+		}
+
+		size_t next = lb;
+		st.for_each_internal_child(v, [&](size_t c) {
+			ASSERT_EQ(v, st.parent(c));
+			ASSERT_LE(next, st.lb(c));
+			for(; next < st.lb(c); ++next) {
+				ASSERT_EQ(v, st.parent(st.leaf(sa[next])));
+			}
+			next = st.rb(c) + 1;
+		});
+		for(; next <= rb; ++next) {
+			ASSERT_EQ(v, st.parent(st.leaf(sa[next])));
+		}
+		ASSERT_EQ(next, rb + 1);
 	}
 }
 
-TEST(SuffixTree, strdepth)     {
-	test::roundtrip_batch(test_strdepth);
+TEST(SuffixTree, compact) {
+	test::roundtrip_batch(test_compact_st);
+	test::on_string_generators(test_compact_st, 11);
+}
+
+void test_lcp_intervals(const std::string& str) {
+	test::TestInput input = test::compress_input(str);
+	io::InputView in = input.as_view();
+	auto t = create_algo<TextDS<>>("", in);
+	auto& lcp = t.require_lcp();
+	const size_t n = lcp.size();
+
+	// naively, every boundary i lies in the interval of lcp value lcp[i]
+	// that is maximal around it
+	std::set<std::tuple<size_t, size_t, size_t>> expected;
+	expected.emplace(0, 0, n - 1);
+	for(size_t i = 1; i < n; ++i) {
+		size_t lb = i - 1, rb = i;
+		while(lb > 0 && lcp[lb] >= lcp[i]) --lb;
+		while(rb + 1 < n && lcp[rb + 1] >= lcp[i]) ++rb;
+		expected.emplace(lcp[i], lb, rb);
+	}
+
+	LCPIntervals intervals;
+	std::vector<LCPInterval> found;
+	std::vector<size_t> leaf_parent(n);
+	intervals.enumerate(lcp, 0, n - 1,
+		[&](const LCPInterval& iv) { found.push_back(iv); },
+		[&](size_t rank, size_t parent) { leaf_parent[rank] = parent; });
+
+	std::set<std::tuple<size_t, size_t, size_t>> actual;
+	std::vector<LCPInterval> by_id(found.size());
+	for(auto& iv : found) {
+		actual.emplace(iv.lcp, iv.lb, iv.rb);
+		ASSERT_LT(iv.id, found.size());
+		by_id[iv.id] = iv;
+	}
+	ASSERT_EQ(expected, actual);
+	ASSERT_EQ(expected.size(), found.size());
+
+	// postorder, with every interval nested in its parent
+	for(size_t k = 0; k < found.size(); ++k) {
+		const auto& iv = found[k];
+		const auto& p = by_id[iv.parent];
+		if(k + 1 == found.size()) {
+			ASSERT_EQ(iv.id, iv.parent);
+		} else {
+			ASSERT_LT(p.lcp, iv.lcp);
+			ASSERT_LE(p.lb, iv.lb);
+			ASSERT_GE(p.rb, iv.rb);
+		}
+	}
+	for(size_t i = 0; i < n; ++i) {
+		const auto& p = by_id[leaf_parent[i]];
+		ASSERT_LE(p.lb, i);
+		ASSERT_GE(p.rb, i);
+		const size_t left = (i > 0) ? size_t(lcp[i]) : 0;
+		const size_t right = (i + 1 < n) ? size_t(lcp[i + 1]) : 0;
+		ASSERT_EQ(std::max(left, right), p.lcp);
+	}
+
+	// the child ranges of the root can be enumerated on their own
+	size_t next = 0;
+	std::set<std::tuple<size_t, size_t, size_t>> nested;
+	nested.emplace(0, 0, n - 1);
+	LCPIntervals::for_each_child_range(lcp, 0, n - 1, [&](size_t lb, size_t rb) {
+		ASSERT_EQ(next, lb);
+		next = rb + 1;
+		if(lb == rb) return;
+		intervals.enumerate(lcp, lb, rb, [&](const LCPInterval& iv) {
+			nested.emplace(iv.lcp, iv.lb, iv.rb);
+		});
+	});
+	ASSERT_EQ(n, next);
+	ASSERT_EQ(expected, nested);
+}
 
-    //this never terminates. see bug #18662
-	//test::on_string_generators(test_strdepth,11);
+TEST(LCPIntervals, enumerate) {
+	test::roundtrip_batch(test_lcp_intervals);
+	test::on_string_generators(test_lcp_intervals, 11);
 }
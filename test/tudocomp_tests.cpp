@@ -1,5 +1,6 @@
 #include <algorithm>
 #include <iostream>
+#include <random>
 #include <sstream>
 #include <stdexcept>
 #include <utility>
@@ -726,6 +727,79 @@ TEST(IO, bits_eof) {
     }
 }
 
+TEST(IO, bits_mixed) {
+    // write random mixes of integers and codes, compare the output against
+    // writing the same bits one by one and read them back
+    std::mt19937_64 rnd(1337);
+    for(size_t round = 0; round < 200; round++) {
+        struct Op { uint8_t kind; uint64_t v; size_t bits; };
+        std::vector<Op> ops;
+        std::vector<bool> expected;
+        auto push_int = [&](uint64_t v, size_t bits) {
+            for(size_t i = bits; i > 0; i--) expected.push_back((v >> (i - 1)) & 1);
+        };
+
+        const size_t num = rnd() % 40;
+        for(size_t i = 0; i < num; i++) {
+            const uint8_t kind = rnd() % 5;
+            const size_t bits = rnd() % 65;
+            uint64_t v = bits == 0 ? 0 : rnd() >> (64 - bits);
+            switch(kind) {
+                case 0: v &= 1; push_int(v, 1); break;
+                case 1: push_int(v, bits); break;
+                case 2: v %= 100; push_int(1, v + 1); break;
+                case 3: push_int(1, bits_for(v) + 1); push_int(v, bits_for(v)); break;
+                case 4: {
+                    v = std::max<uint64_t>(v, 1);
+                    const size_t b = bits_for(v);
+                    push_int(1, bits_for(b) + 1);
+                    push_int(b, bits_for(b));
+                    push_int(v, b);
+                    break;
+                }
+            }
+            ops.push_back(Op { kind, v, bits });
+        }
+
+        std::string result, reference;
+        {
+            std::ostringstream ss_result, ss_reference;
+            Output output(ss_result), output_reference(ss_reference);
+            {
+                BitOStream out(output);
+                BitOStream out_reference(output_reference);
+                for(const Op& op : ops) {
+                    switch(op.kind) {
+                        case 0: out.write_bit(op.v); break;
+                        case 1: out.write_int(op.v, op.bits); break;
+                        case 2: out.write_unary(op.v); break;
+                        case 3: out.write_elias_gamma(op.v); break;
+                        case 4: out.write_elias_delta(op.v); break;
+                    }
+                }
+                for(bool bit : expected) out_reference.write_bit(bit);
+            }
+            result = ss_result.str();
+            reference = ss_reference.str();
+        }
+        ASSERT_EQ(reference, result);
+
+        Input input(result);
+        BitIStream in(input);
+        for(const Op& op : ops) {
+            switch(op.kind) {
+                case 0: ASSERT_EQ(op.v, in.read_bit()); break;
+                case 1: ASSERT_EQ(op.v, in.read_int<uint64_t>(op.bits)); break;
+                case 2: ASSERT_EQ(op.v, in.read_unary<uint64_t>()); break;
+                case 3: ASSERT_EQ(op.v, in.read_elias_gamma<uint64_t>()); break;
+                case 4: ASSERT_EQ(op.v, in.read_elias_delta<uint64_t>()); break;
+            }
+        }
+        ASSERT_TRUE(in.eof());
+        ASSERT_EQ(0U, in.read_int<uint64_t>(13));
+    }
+}
+
 TEST(View, construction) {
     static const uint8_t DATA[3] = { 'f', 'o', 'o' };
 